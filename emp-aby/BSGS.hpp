@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include <cstring>
 #include <cmath>
 #include <mutex>
 #include <atomic>
@@ -10,27 +11,180 @@
 #include <mcl/bn.hpp>
 #include "emp-aby/utils.h"
 #include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace emp {
 
-struct BLS12381ElementHash {
-    std::size_t operator()(const BLS12381Element& g) const {
-        std::stringstream ss;
-        g.pack(ss);
-        return std::hash<std::string>()(ss.str());
-    }
+// Baby steps live in an open-addressing table of cache-line sized buckets.
+// A slot is keyed by a 64-bit fingerprint of the normalized affine point:
+// bits of x, with the low bit taken from y so that P and -P differ.
+// Tag 0 marks an empty slot.
+struct alignas(64) BSGSBucket {
+    static const int kSlots = 4;
+    uint64_t tag[kSlots];
+    uint64_t index[kSlots];
 };
 
-struct BSGSPrecomputation {
+// On-disk layout: this header, padded to header_size, followed directly by
+// n_buckets BSGSBucket records, so the file can be mapped and used as is.
+struct BSGSFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
     uint64_t n;
     uint64_t N;
+    uint64_t n_buckets;
+    uint64_t g_tag;
+    uint8_t g[64];
+    uint8_t g_inv_n[64];
+};
+
+static const char BSGS_FILE_MAGIC[8] = {'B', 'S', 'G', 'S', 'T', 'B', 'L', '\0'};
+static const uint32_t BSGS_FILE_VERSION = 1;
+static const uint32_t BSGS_HEADER_SIZE = 256;
+
+inline uint64_t bsgs_fingerprint(const G1& P) {
+    uint64_t x[3], y0;
+    memcpy(x, P.x.getUnit(), sizeof(x));
+    memcpy(&y0, P.y.getUnit(), sizeof(y0));
+    uint64_t h = x[0] ^ (x[1] * 0x9e3779b97f4a7c15ULL) ^ (x[2] * 0xc2b2ae3d27d4eb4fULL);
+    h ^= h >> 29;
+    return ((h | (1ULL << 63)) & ~1ULL) | (y0 & 1);
+}
+
+// Read-only private mapping of a whole file; throws on failure.
+inline void* map_table_file(const char* filename, size_t min_len, size_t& len) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file for reading");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < min_len) {
+        close(fd);
+        throw std::runtime_error("map_table_file: truncated file");
+    }
+    len = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("map_table_file: mmap failed");
+    }
+    return base;
+}
+
+// Point -> small integer index over BSGSBucket storage. The buckets are
+// either owned (after a build) or point into a mapped table file.
+struct PointIndex {
+    const BSGSBucket* buckets = nullptr;
+    uint64_t n_buckets = 0;
+    std::vector<BSGSBucket> owned_buckets;
+    void* mapped = nullptr;
+    size_t mapped_len = 0;
+
+    PointIndex() = default;
+    PointIndex(const PointIndex&) = delete;
+    PointIndex& operator=(const PointIndex&) = delete;
+    ~PointIndex() { release(); }
+
+    // Sized for a load factor of at most 1/2.
+    void reset(uint64_t entries) {
+        release();
+        n_buckets = 1;
+        while (n_buckets * BSGSBucket::kSlots < 2 * entries) n_buckets <<= 1;
+        owned_buckets.assign(n_buckets, BSGSBucket{});
+        buckets = owned_buckets.data();
+    }
+
+    void release() {
+        if (mapped) munmap(mapped, mapped_len);
+        mapped = nullptr;
+        mapped_len = 0;
+        owned_buckets.clear();
+        owned_buckets.shrink_to_fit();
+        buckets = nullptr;
+        n_buckets = 0;
+    }
+
+    // Takes ownership of the mapping [base, base + len).
+    void attach(void* base, size_t len, size_t offset, uint64_t n_buckets_in) {
+        release();
+        mapped = base;
+        mapped_len = len;
+        n_buckets = n_buckets_in;
+        buckets = reinterpret_cast<const BSGSBucket*>(static_cast<const char*>(base) + offset);
+        madvise(base, len, MADV_WILLNEED);
+    }
+
+    static bool valid_layout(uint64_t n_buckets_in, size_t offset, size_t len) {
+        return n_buckets_in != 0 && (n_buckets_in & (n_buckets_in - 1)) == 0
+            && len == offset + n_buckets_in * sizeof(BSGSBucket);
+    }
+
+    void insert(uint64_t tag, uint64_t j) {
+        uint64_t mask = n_buckets - 1;
+        for (uint64_t b = (tag >> 1) & mask;; b = (b + 1) & mask) {
+            BSGSBucket& bk = owned_buckets[b];
+            for (int s = 0; s < BSGSBucket::kSlots; ++s) {
+                if (bk.tag[s] == tag) return;
+                if (bk.tag[s] == 0) {
+                    bk.tag[s] = tag;
+                    bk.index[s] = j;
+                    return;
+                }
+            }
+        }
+    }
+
+    // P must be normalized. The identity maps to 0 and is never stored;
+    // an empty index finds nothing.
+    int64_t lookup(const G1& P) const {
+        if (P.isZero()) return 0;
+        if (n_buckets == 0) return -1;
+        uint64_t tag = bsgs_fingerprint(P);
+        uint64_t mask = n_buckets - 1;
+        for (uint64_t b = (tag >> 1) & mask;; b = (b + 1) & mask) {
+            const BSGSBucket& bk = buckets[b];
+            for (int s = 0; s < BSGSBucket::kSlots; ++s) {
+                if (bk.tag[s] == tag) return static_cast<int64_t>(bk.index[s]);
+                if (bk.tag[s] == 0) return -1;
+            }
+        }
+    }
+
+    // powers[k] = g^(first + k); normalizes them and inserts every nonzero index.
+    void insert_powers(std::vector<G1>& powers, uint64_t first) {
+        G1::normalizeVec(powers.data(), powers.data(), powers.size());
+        for (size_t k = 0; k < powers.size(); ++k) {
+            if (first + k != 0) insert(bsgs_fingerprint(powers[k]), first + k);
+        }
+    }
+
+    void write(std::ostream& out) const {
+        out.write(reinterpret_cast<const char*>(buckets), n_buckets * sizeof(BSGSBucket));
+    }
+};
+
+struct BSGSPrecomputation {
+    uint64_t n = 0;
+    uint64_t N = 0;
     BLS12381Element g;
     BLS12381Element g_inv_n;
-    std::unordered_map<BLS12381Element, uint64_t, BLS12381ElementHash> baby_table;
+    PointIndex table;
 
-    void precompute(const BLS12381Element& g_in, uint64_t N_in, uint32_t n_threads = 1);
+    void precompute(const BLS12381Element& g_in, uint64_t N_in);
     int64_t solve_parallel_with_pool(BLS12381Element& y, ThreadPool* pool, uint32_t n_threads = 4) const;
     vector<int64_t> solve_parallel_with_pool_vector(vector<BLS12381Element> ys, ThreadPool* pool, uint32_t n_tasks) const;
+    // Targets are split across tasks; each task walks the giant steps of its
+    // slice in lockstep, normalizing them with one batch inversion per step.
+    vector<int64_t> solve_batch(const vector<BLS12381Element>& ys, ThreadPool* pool, uint32_t n_tasks) const;
+
+    // P must be normalized. Returns j with P == g^j for j < n, or -1.
+    int64_t lookup(const G1& P) const {
+        return table.lookup(P);
+    }
 
     void serialize(const char* filename) {
         std::ofstream outFile(filename, std::ios::binary);
@@ -38,126 +192,105 @@ struct BSGSPrecomputation {
             throw std::runtime_error("Cannot open file for writing");
         }
 
-        outFile.write(reinterpret_cast<const char*>(&n), sizeof(n));
-        outFile.write(reinterpret_cast<const char*>(&N), sizeof(N));
-
-        std::stringstream ss_g, ss_g_inv_n;
-        g.pack(ss_g);
-        g_inv_n.pack(ss_g_inv_n);
-        std::string g_str = ss_g.str();
-        std::string g_inv_n_str = ss_g_inv_n.str();
-        
-        size_t g_len = g_str.length();
-        size_t g_inv_n_len = g_inv_n_str.length();
-        outFile.write(reinterpret_cast<const char*>(&g_len), sizeof(g_len));
-        outFile.write(g_str.c_str(), g_len);
-        outFile.write(reinterpret_cast<const char*>(&g_inv_n_len), sizeof(g_inv_n_len));
-        outFile.write(g_inv_n_str.c_str(), g_inv_n_len);
-
-        size_t table_size = baby_table.size();
-        outFile.write(reinterpret_cast<const char*>(&table_size), sizeof(table_size));
-        
-        for (const auto& pair : baby_table) {
-            std::stringstream ss;
-            pair.first.pack(ss);
-            std::string key_str = ss.str();
-            size_t key_len = key_str.length();
-            outFile.write(reinterpret_cast<const char*>(&key_len), sizeof(key_len));
-            outFile.write(key_str.c_str(), key_len);
-            outFile.write(reinterpret_cast<const char*>(&pair.second), sizeof(pair.second));
+        char raw[BSGS_HEADER_SIZE] = {0};
+        BSGSFileHeader* h = reinterpret_cast<BSGSFileHeader*>(raw);
+        memcpy(h->magic, BSGS_FILE_MAGIC, sizeof(h->magic));
+        h->version = BSGS_FILE_VERSION;
+        h->header_size = BSGS_HEADER_SIZE;
+        h->n = n;
+        h->N = N;
+        h->n_buckets = table.n_buckets;
+        G1 g_norm = g.point;
+        g_norm.normalize();
+        h->g_tag = bsgs_fingerprint(g_norm);
+        if (g.point.serialize(h->g, sizeof(h->g)) == 0 || g_inv_n.point.serialize(h->g_inv_n, sizeof(h->g_inv_n)) == 0) {
+            throw std::runtime_error("BSGS serialize: point encoding failed");
+        }
+
+        outFile.write(raw, BSGS_HEADER_SIZE);
+        table.write(outFile);
+        if (!outFile) {
+            throw std::runtime_error("BSGS serialize: write failed");
         }
     }
 
     void deserialize(const char* filename) {
-        std::ifstream inFile(filename, std::ios::binary);
-        if (!inFile) {
-            throw std::runtime_error("Cannot open file for reading");
+        size_t len = 0;
+        void* base = map_table_file(filename, BSGS_HEADER_SIZE, len);
+
+        const BSGSFileHeader* h = reinterpret_cast<const BSGSFileHeader*>(base);
+        bool ok = memcmp(h->magic, BSGS_FILE_MAGIC, sizeof(h->magic)) == 0
+               && h->version == BSGS_FILE_VERSION
+               && h->header_size == BSGS_HEADER_SIZE
+               && PointIndex::valid_layout(h->n_buckets, h->header_size, len);
+        BLS12381Element g_in, g_inv_n_in;
+        ok = ok && g_in.point.deserialize(h->g, sizeof(h->g)) != 0
+                && g_inv_n_in.point.deserialize(h->g_inv_n, sizeof(h->g_inv_n)) != 0;
+        if (ok) {
+            G1 g_norm = g_in.point;
+            g_norm.normalize();
+            // The fingerprint depends on mcl's internal field representation.
+            ok = bsgs_fingerprint(g_norm) == h->g_tag;
         }
-
-        inFile.read(reinterpret_cast<char*>(&n), sizeof(n));
-        inFile.read(reinterpret_cast<char*>(&N), sizeof(N));
-
-        size_t g_len, g_inv_n_len;
-        inFile.read(reinterpret_cast<char*>(&g_len), sizeof(g_len));
-        std::string g_str(g_len, '\0');
-        inFile.read(&g_str[0], g_len);
-        std::stringstream ss_g(g_str);
-        g.unpack(ss_g);
-
-        inFile.read(reinterpret_cast<char*>(&g_inv_n_len), sizeof(g_inv_n_len));
-        std::string g_inv_n_str(g_inv_n_len, '\0');
-        inFile.read(&g_inv_n_str[0], g_inv_n_len);
-        std::stringstream ss_g_inv_n(g_inv_n_str);
-        g_inv_n.unpack(ss_g_inv_n);
-
-        size_t table_size;
-        inFile.read(reinterpret_cast<char*>(&table_size), sizeof(table_size));
-        baby_table.clear();
-        baby_table.reserve(table_size);
-
-        for (size_t i = 0; i < table_size; ++i) {
-            size_t key_len;
-            inFile.read(reinterpret_cast<char*>(&key_len), sizeof(key_len));
-            std::string key_str(key_len, '\0');
-            inFile.read(&key_str[0], key_len);
-            std::stringstream ss_key(key_str);
-            BLS12381Element key;
-            key.unpack(ss_key);
-            
-            uint64_t value;
-            inFile.read(reinterpret_cast<char*>(&value), sizeof(value));
-            baby_table[key] = value;
+        if (!ok) {
+            munmap(base, len);
+            throw std::runtime_error("BSGS deserialize: incompatible table file");
         }
+
+        n = h->n;
+        N = h->N;
+        g = g_in;
+        g_inv_n = g_inv_n_in;
+        table.attach(base, len, h->header_size, h->n_buckets);
     }
 };
 
-void BSGSPrecomputation::precompute(const BLS12381Element& g_in, uint64_t N_in, uint32_t n_threads) {
+inline void BSGSPrecomputation::precompute(const BLS12381Element& g_in, uint64_t N_in) {
     g = g_in;
     N = N_in;
     n = static_cast<uint64_t>(std::ceil(std::sqrt(N)));
 
-    baby_table.clear();
-    baby_table.reserve(n);
+    table.reset(n);
 
-    Fr n_fr; n_fr.setStr(std::to_string(n));
+    Fr n_fr(static_cast<int64_t>(n));
     BLS12381Element g_n = g * n_fr;
     g_inv_n = g_n.negate();
 
-    BLS12381Element cur;
-    for (uint64_t j = 0; j < n; ++j) {
-        cur.point.normalize();
-        baby_table[cur] = j;
-        cur = cur + g;
+    std::vector<G1> steps(n);
+    steps[0].clear();
+    for (uint64_t j = 1; j < n; ++j) {
+        G1::add(steps[j], steps[j - 1], g.point);
     }
+    table.insert_powers(steps, 0);
 }
 
-int64_t BSGSPrecomputation::solve_parallel_with_pool(BLS12381Element& y, ThreadPool* pool, uint32_t n_tasks) const {
+inline int64_t BSGSPrecomputation::solve_parallel_with_pool(BLS12381Element& y, ThreadPool* pool, uint32_t n_tasks) const {
     if (n_tasks == 0) n_tasks = 1;
     using namespace std;
-    
+
     std::vector<std::future<int64_t>> futures;
     std::atomic<bool> found(false);
     std::atomic<int64_t> result(-1);
+    G1 step;
+    G1::mul(step, g_inv_n.point, Fr(static_cast<int64_t>(n_tasks)));
 
     for (uint32_t task_id = 0; task_id < n_tasks; ++task_id) {
-        futures.push_back(pool->enqueue([this, &y, task_id, n_tasks, &found, &result]() {
-            BLS12381Element giant = y;
+        futures.push_back(pool->enqueue([this, &y, &step, task_id, n_tasks, &found, &result]() {
+            G1 giant = y.point;
             uint64_t start = task_id;
             // giant = y * g^{-start * n}
             if (start > 0) {
-                using mcl::bn::Fr;
-                Fr shift;
-                shift.setStr(std::to_string(start));
-                BLS12381Element shift_step = g_inv_n * shift;
-                giant = giant + shift_step;
+                G1 shift_step;
+                G1::mul(shift_step, g_inv_n.point, Fr(static_cast<int64_t>(start)));
+                G1::add(giant, giant, shift_step);
             }
 
             for (uint64_t i = start; i < n; i += n_tasks) {
                 if (found.load(std::memory_order_relaxed)) return int64_t(-1);
-                giant.point.normalize();
-                auto it = baby_table.find(giant);
-                if (it != baby_table.end()) {
-                    uint64_t m = i * n + it->second;
+                giant.normalize();
+                int64_t j = lookup(giant);
+                if (j >= 0) {
+                    uint64_t m = i * n + j;
                     if (m < N) {
                         result.store(m, std::memory_order_relaxed);
                         found.store(true, std::memory_order_relaxed);
@@ -166,7 +299,7 @@ int64_t BSGSPrecomputation::solve_parallel_with_pool(BLS12381Element& y, ThreadP
                         throw std::runtime_error("BSGS solve_parallel_with_pool: m out of range");
                     }
                 }
-                giant = giant + g_inv_n * n_tasks;
+                G1::add(giant, giant, step);
             }
             return int64_t(-1);
         }));
@@ -183,7 +316,7 @@ int64_t BSGSPrecomputation::solve_parallel_with_pool(BLS12381Element& y, ThreadP
     throw std::runtime_error("BSGS solve_parallel_with_pool: no solution found");
 }
 
-vector<int64_t>
+inline vector<int64_t>
 BSGSPrecomputation::solve_parallel_with_pool_vector(
     vector<BLS12381Element> ys,
     ThreadPool* pool,
@@ -195,35 +328,36 @@ BSGSPrecomputation::solve_parallel_with_pool_vector(
 
     vector<int64_t> results(M, -1);
     std::atomic<bool> failed(false);
+    G1 step;
+    G1::mul(step, g_inv_n.point, Fr(static_cast<int64_t>(n_tasks)));
 
     vector<std::future<void>> futures;
 
     for (uint32_t task_id = 0; task_id < n_tasks; ++task_id) {
         futures.emplace_back(
             pool->enqueue([&, task_id]() {
-                using mcl::bn::Fr;
+                G1 shift;
+                if (task_id > 0) G1::mul(shift, g_inv_n.point, Fr(static_cast<int64_t>(task_id)));
 
                 for (size_t idx = 0; idx < M; ++idx) {
-                    BLS12381Element giant = ys[idx];
+                    G1 giant = ys[idx].point;
 
                     // giant = y + task_id * g_inv_n
                     if (task_id > 0) {
-                        Fr shift;
-                        shift.setStr(std::to_string(task_id));
-                        giant = giant + g_inv_n * shift;
+                        G1::add(giant, giant, shift);
                     }
 
                     for (uint64_t i = task_id; i < n; i += n_tasks) {
-                        giant.point.normalize();
-                        auto it = baby_table.find(giant);
-                        if (it != baby_table.end()) {
-                            uint64_t m = i * n + it->second;
+                        giant.normalize();
+                        int64_t j = lookup(giant);
+                        if (j >= 0) {
+                            uint64_t m = i * n + j;
                             if (m < N) {
                                 results[idx] = static_cast<int64_t>(m);
                                 break;
                             }
                         }
-                        giant = giant + g_inv_n * n_tasks;
+                        G1::add(giant, giant, step);
                     }
                 }
             })
@@ -240,6 +374,59 @@ BSGSPrecomputation::solve_parallel_with_pool_vector(
     return results;
 }
 
+inline vector<int64_t>
+BSGSPrecomputation::solve_batch(
+    const vector<BLS12381Element>& ys,
+    ThreadPool* pool,
+    uint32_t n_tasks
+) const
+{
+    if (n_tasks == 0) n_tasks = 1;
+    const size_t M = ys.size();
+    vector<int64_t> results(M, -1);
+    if (M == 0) return results;
+    if (n_tasks > M) n_tasks = static_cast<uint32_t>(M);
+
+    G1 step = g_inv_n.point;
+    step.normalize();
 
+    vector<std::future<void>> futures;
+    size_t chunk = (M + n_tasks - 1) / n_tasks;
+    for (size_t lo = 0; lo < M; lo += chunk) {
+        size_t hi = std::min(M, lo + chunk);
+        futures.emplace_back(pool->enqueue([this, &ys, &results, &step, lo, hi]() {
+            size_t active = hi - lo;
+            std::vector<G1> giant(active);
+            std::vector<size_t> id(active);
+            for (size_t k = 0; k < active; ++k) {
+                giant[k] = ys[lo + k].point;
+                id[k] = lo + k;
+            }
+
+            for (uint64_t i = 0; i < n && active > 0; ++i) {
+                G1::normalizeVec(giant.data(), giant.data(), active);
+                for (size_t k = 0; k < active;) {
+                    int64_t j = lookup(giant[k]);
+                    if (j >= 0 && i * n + j < N) {
+                        results[id[k]] = static_cast<int64_t>(i * n + j);
+                        --active;
+                        giant[k] = giant[active];
+                        id[k] = id[active];
+                        continue;
+                    }
+                    G1::add(giant[k], giant[k], step);
+                    ++k;
+                }
+            }
+        }));
+    }
+    for (auto& f : futures) f.get();
+
+    for (auto v : results) {
+        if (v < 0)
+            throw std::runtime_error("BSGS batch solve: no solution found");
+    }
+    return results;
+}
 
 } // namespace emp
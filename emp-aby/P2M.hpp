@@ -1,75 +1,115 @@
-
+#pragma once
 #include "libelgl/elgl/BLS12381Element.h"
+#include "emp-aby/BSGS.hpp"
 #include <iostream>
 #include <fstream>
-#include <map>
 #include <string>
 #include <cstddef>
 #include <cstring>
 #include <algorithm> 
 #include <stdexcept> 
 #include <cstdlib>          
-void serialize_P_to_m(const std::map<std::string, Fr>& P_to_m, const char* filename) {
-    std::ofstream outFile(filename, std::ios::binary);
-    if (!outFile) {
-        std::cerr << "Error: Unable to open file for writing P_to_m table.\n";
-        return;
-    }
 
-    size_t size = P_to_m.size();
-    outFile.write(reinterpret_cast<const char*>(&size), sizeof(size));
-    for (const auto& pair : P_to_m) {
-        size_t key_len = pair.first.length();
-        outFile.write(reinterpret_cast<const char*>(&key_len), sizeof(key_len));
-        outFile.write(pair.first.c_str(), key_len);
+// Small discrete-log index g^m -> m for m in [0, max_exponent]. Entries are
+// 64-bit fingerprints in the same bucket layout as the BSGS baby steps, and
+// the file is a fixed header followed by the raw buckets so it can be mapped.
+struct SmallDlogFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t max_exponent;
+    uint64_t n_buckets;
+    uint64_t g_tag;
+};
 
-        std::string value_str = pair.second.getStr();
-        size_t value_len = value_str.length();
-        outFile.write(reinterpret_cast<const char*>(&value_len), sizeof(value_len));
-        outFile.write(value_str.c_str(), value_len);
-    }
+static const char SMALL_DLOG_FILE_MAGIC[8] = {'P', '2', 'M', 'I', 'D', 'X', '1', '\0'};
+static const uint32_t SMALL_DLOG_FILE_VERSION = 1;
+static const uint32_t SMALL_DLOG_HEADER_SIZE = 64;
 
-    outFile.close();
-}
+struct SmallDlogIndex {
+    uint64_t max_exponent = 0;
+    emp::PointIndex table;
 
-void deserialize_P_to_m(std::map<std::string, Fr>& P_to_m, const char* filename) {
-    std::ifstream inFile(filename, std::ios::binary);
-    if (!inFile) {
-        std::cerr << "Error: Unable to open file for reading P_to_m table.\n";
-        return;
+    bool empty() const { return table.n_buckets == 0; }
+
+    void build(uint64_t max_exponent_in) {
+        max_exponent = max_exponent_in;
+        table.reset(max_exponent + 1);
+        G1 g = BLS12381Element::generator().getPoint();
+        const uint64_t chunk = 1ULL << 16;
+        std::vector<G1> powers;
+        G1 cur;
+        cur.clear();
+        for (uint64_t first = 0; first <= max_exponent; first += chunk) {
+            uint64_t cnt = std::min(chunk, max_exponent + 1 - first);
+            powers.resize(cnt);
+            for (uint64_t k = 0; k < cnt; ++k) {
+                powers[k] = cur;
+                G1::add(cur, cur, g);
+            }
+            table.insert_powers(powers, first);
+        }
     }
-    size_t size;
-    inFile.read(reinterpret_cast<char*>(&size), sizeof(size));
-    for (size_t i = 0; i < size; ++i) {
-        size_t key_len;
-        inFile.read(reinterpret_cast<char*>(&key_len), sizeof(key_len));
-        std::string key(key_len, '\0');
-        inFile.read(&key[0], key_len);
-        size_t value_len;
-        inFile.read(reinterpret_cast<char*>(&value_len), sizeof(value_len));
-        std::string value_str(value_len, '\0');
-        inFile.read(&value_str[0], value_len);
-        Fr value;
-        value.setStr(value_str);
-        P_to_m[key] = value;
+
+    // Returns m with y == g^m, or -1 if m is not in range.
+    int64_t find(const BLS12381Element& y) const {
+        G1 P = y.getPoint();
+        P.normalize();
+        int64_t m = table.lookup(P);
+        return (m >= 0 && static_cast<uint64_t>(m) <= max_exponent) ? m : -1;
     }
 
-    inFile.close();
-}
+    void serialize(const char* filename) const {
+        std::ofstream outFile(filename, std::ios::binary);
+        if (!outFile) {
+            throw std::runtime_error("Unable to open file for writing P_to_m table");
+        }
+        char raw[SMALL_DLOG_HEADER_SIZE] = {0};
+        SmallDlogFileHeader* h = reinterpret_cast<SmallDlogFileHeader*>(raw);
+        memcpy(h->magic, SMALL_DLOG_FILE_MAGIC, sizeof(h->magic));
+        h->version = SMALL_DLOG_FILE_VERSION;
+        h->header_size = SMALL_DLOG_HEADER_SIZE;
+        h->max_exponent = max_exponent;
+        h->n_buckets = table.n_buckets;
+        h->g_tag = emp::bsgs_fingerprint(BLS12381Element::generator().getPoint());
+        outFile.write(raw, SMALL_DLOG_HEADER_SIZE);
+        table.write(outFile);
+        if (!outFile) {
+            throw std::runtime_error("P_to_m serialize: write failed");
+        }
+    }
 
-void build_safe_P_to_m(std::map<std::string, Fr>& P_to_m, int max_exponent) {
-    if (max_exponent <= 1UL << 24) {
-        for (size_t i = 0; i <= max_exponent; ++i) {
-            BLS12381Element g_i(i);
-            P_to_m[g_i.getPoint().getStr()] = Fr(to_string(i));
+    void deserialize(const char* filename) {
+        size_t len = 0;
+        void* base = emp::map_table_file(filename, SMALL_DLOG_HEADER_SIZE, len);
+        const SmallDlogFileHeader* h = reinterpret_cast<const SmallDlogFileHeader*>(base);
+        bool ok = memcmp(h->magic, SMALL_DLOG_FILE_MAGIC, sizeof(h->magic)) == 0
+               && h->version == SMALL_DLOG_FILE_VERSION
+               && h->header_size == SMALL_DLOG_HEADER_SIZE
+               && h->g_tag == emp::bsgs_fingerprint(BLS12381Element::generator().getPoint())
+               && emp::PointIndex::valid_layout(h->n_buckets, h->header_size, len);
+        if (!ok) {
+            munmap(base, len);
+            throw std::runtime_error("P_to_m deserialize: incompatible table file");
         }
-        return;
+        max_exponent = h->max_exponent;
+        table.attach(base, len, h->header_size, h->n_buckets);
     }
-    const char* filename = "P_to_m_table.bin";
-    for (size_t i = 0; i <= 1UL << 24; ++i) {
-        BLS12381Element g_i(i);
-        g_i.getPoint().normalize(); 
-        P_to_m[g_i.getPoint().getStr()] = Fr(i);
+};
+
+// Builds the index in memory, capped at 2^24 exponents.
+inline void build_safe_P_to_m(SmallDlogIndex& P_to_m, uint64_t max_exponent) {
+    P_to_m.build(std::min<uint64_t>(max_exponent, 1ULL << 24));
+}
+
+// Loads the index from cache_file, rebuilding it when the file is missing,
+// stale or too small for max_exponent.
+inline void load_or_build_P_to_m(SmallDlogIndex& P_to_m, uint64_t max_exponent, const std::string& cache_file) {
+    try {
+        P_to_m.deserialize(cache_file.c_str());
+        if (P_to_m.max_exponent >= std::min<uint64_t>(max_exponent, 1ULL << 24)) return;
+    } catch (const std::exception&) {
     }
-    serialize_P_to_m(P_to_m, filename);
+    build_safe_P_to_m(P_to_m, max_exponent);
+    P_to_m.serialize(cache_file.c_str());
 }
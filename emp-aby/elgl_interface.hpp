@@ -24,42 +24,25 @@
 // #endif
 
 
-static const std::string base64_chars =
-             "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-             "abcdefghijklmnopqrstuvwxyz"
-             "0123456789+/";
-
-std::string base64_encode(const std::string &in) {
-    std::string out;
-    int val=0, valb=-6;
-    for (unsigned char c : in) {
-        val = (val<<8) + c;
-        valb += 8;
-        while (valb>=0) {
-            out.push_back(base64_chars[(val>>valb)&0x3F]);
-            valb-=6;
-        }
-    }
-    if (valb>-6) out.push_back(base64_chars[((val<<8)>>(valb+8))&0x3F]);
-    while (out.size()%4) out.push_back('=');
-    return out;
+// Sub-messages inside one packet are framed as a uint32 byte length
+// followed by the raw bytes; packed G1/Fr values are already binary.
+inline void write_frame(std::stringstream& ss, const std::string& s) {
+    uint32_t len = s.size();
+    ss.write((const char*)&len, sizeof(len));
+    ss.write(s.data(), len);
 }
 
-std::string base64_decode(const std::string &in) {
-    std::vector<int> T(256,-1);
-    for (int i=0; i<64; i++) T[base64_chars[i]] = i;
-    std::string out;
-    int val=0, valb=-8;
-    for (unsigned char c : in) {
-        if (T[c] == -1) break;
-        val = (val<<6) + T[c];
-        valb += 6;
-        if (valb>=0) {
-            out.push_back(char((val>>valb)&0xFF));
-            valb-=8;
-        }
+inline void read_frame(std::stringstream& ss, std::string& s) {
+    uint32_t len = 0;
+    ss.read((char*)&len, sizeof(len));
+    if (!ss) {
+        throw std::runtime_error("read_frame: truncated length");
+    }
+    s.resize(len);
+    ss.read(&s[0], len);
+    if (!ss) {
+        throw std::runtime_error("read_frame: truncated payload");
     }
-    return out;
 }
 
 namespace emp {
@@ -115,22 +98,11 @@ namespace emp {
     }
 
     #define PARALLEL_FOR_SU(begin, end, BODY)                                  \
-    do {                                                                        \
-        size_t _threads = pool->size();                                         \
-        size_t _block = calc_block_size(su, num_party, _threads);              \
-        std::vector<std::future<void>> _fs;                                    \
-        _fs.reserve(_threads);                                                  \
-        for (size_t _b = (begin); _b < (end); _b += _block) {                  \
-            size_t _bs = _b;                                                    \
-            size_t _be = std::min((end), _b + _block);                          \
-            _fs.emplace_back(pool->enqueue([&, _bs, _be]() {                   \
-                for (size_t i = _bs; i < _be; ++i) {                            \
-                    BODY                                                        \
-                }                                                               \
-            }));                                                                \
+    emp::parallel_for(pool, (begin), (end), [&](size_t _bs, size_t _be) {     \
+        for (size_t i = _bs; i < _be; ++i) {                                    \
+            BODY                                                                \
         }                                                                       \
-        for (auto& _f : _fs) _f.get();                                          \
-    } while (0)
+    }, calc_block_size(su, num_party, pool->size()))
 
     template <typename IO>
     class ELGL{
@@ -184,18 +156,15 @@ namespace emp {
                 y3.resize(table_size);
                 vector<Plaintext> r1;
                 r1.resize(table_size);
-                std::vector<std::future<void>> tasks;
-                for(size_t i = 0; i < table_size; i++){
-                    tasks.push_back(pool->enqueue([&, i]() {
+                emp::parallel_for(pool, 0, table_size, [&](size_t l, size_t r) {
+                    for (size_t i = l; i < r; i++) {
                         r1[i].set_random();
                         x[i] = Plaintext(Fr(table[i]));
                         EncTable_c0[i] = BLS12381Element(r1[i].get_message());
-                        y3[i] = global_pk.get_pk() * r1[i].get_message();
+                        y3[i] = global_pk.pk_mul(r1[i].get_message());
                         EncTable_c1[i] =  y3[i] + BLS12381Element(x[i].get_message());
-                    }));
-                }
-                for (auto& task : tasks) task.get();
-                tasks.clear();
+                    }
+                });
                 for(size_t i = 0; i < table_size; i++){
                     EncTable_c1[i].pack(encMap);
                 }
@@ -224,25 +193,18 @@ namespace emp {
                 obj.pack(s);
                 string str      = s.str();
                 int string_size = str.size();
-                char* c         = (char*)malloc(string_size);
-                s.read(c, string_size);
                 simulate_network_transfer(string_size);
-                io->send_data(i, c, string_size, j, mt);
+                io->send_data(i, str.data(), string_size, j, mt);
                 io->flush(i, j);
-                free(c);
                 s.clear();
             }
 
             void serialize_send_(std::stringstream& s, int i, int j = 0, MESSAGE_TYPE mt = NORM_MSG){
                 string str      = s.str();
                 int string_size = str.size();
-
-                char* c         = (char*)malloc(string_size);
-                s.read(c, string_size);
                 simulate_network_transfer(string_size);
-                io->send_data(i, c, string_size, j, mt);
+                io->send_data(i, str.data(), string_size, j, mt);
                 io->flush(i, j);
-                free(c);
                 s.clear();
             }
         
@@ -253,22 +215,9 @@ namespace emp {
                 obj.pack(s);
                 string str      = s.str();
                 int string_size = str.size();
-                char* c         = (char*)malloc(string_size);
-                s.read(c, string_size);
-                std::vector<std::future<void>> res;
-                for (int i = 1; i <= num_party; ++i) {
-                    if (i != party) {
-                        res.push_back(std::async([this, i, c, string_size, j, mt]() {
-                            simulate_network_transfer(string_size);
-                            io->send_data(i, c, string_size, j, mt);
-                            io->flush(i, j);
-                        }));
-                    }
-                }
-                for (auto& fut : res)
-                    fut.get();
-                res.clear();
-                free(c);
+                struct iovec parts[1] = {{(void*)str.data(), (size_t)string_size}};
+                simulate_network_transfer(string_size);
+                io->broadcast_data_v(parts, 1, j, mt);
                 s.clear();
             }
 
@@ -276,24 +225,11 @@ namespace emp {
                 string str = s.str();
                 int string_size = str.size();
 
-                std::vector<std::future<void>> res;
-                for (int i = 1; i <= num_party; ++i) {
-                    if (i != party) {
-                        char* c = (char*)malloc(string_size + sizeof(int));
-                        memcpy(c, &party, sizeof(int));
-                        memcpy(c + sizeof(int), str.data(), string_size);
-
-                        res.push_back(std::async([this, i, c, string_size, j, mt]() {
-                            simulate_network_transfer(string_size + sizeof(int));
-                            io->send_data(i, c, string_size + sizeof(int), j, mt);
-                            io->flush(i, j);
-                            free(c);
-                        }));
-                    }
-                }
-
-                for (auto& fut : res) fut.get();
-                res.clear();
+                // Sender id + payload are copied once into a buffer shared by
+                // every peer's send queue.
+                struct iovec parts[2] = {{&party, sizeof(int)}, {(void*)str.data(), (size_t)string_size}};
+                simulate_network_transfer(string_size + sizeof(int));
+                io->broadcast_data_v(parts, 2, j, mt);
                 s.clear();
             }
 
@@ -301,13 +237,10 @@ namespace emp {
                 string str = s.str();
                 int string_size = str.size();
 
-                char* c = (char*)malloc(string_size + sizeof(int));
-                memcpy(c, &party, sizeof(int));
-                memcpy(c + sizeof(int), str.data(), string_size);
+                struct iovec parts[2] = {{&party, sizeof(int)}, {(void*)str.data(), (size_t)string_size}};
                 simulate_network_transfer(string_size + sizeof(int));
-                io->send_data(target_party, c, string_size + sizeof(int), j, mt);
+                io->send_data_v(target_party, parts, 2, j, mt);
                 io->flush(target_party, j);
-                free(c);
 
                 s.clear();
             }
@@ -328,64 +261,52 @@ namespace emp {
             template <typename T>
             void deserialize_recv(T& obj, int i, int j = 0, MESSAGE_TYPE mt = NORM_MSG) {
                 std::stringstream s;
-                int string_size = 0;
-                char* c         = (char*)io->recv_data(i, string_size, j, mt);
-                if (c != nullptr && string_size > 0) simulate_network_transfer((size_t)string_size);
-                s.write(c, string_size);
-                free(c);
+                MsgView msg = io->recv_view(i, j, mt);
+                if (!msg.empty()) simulate_network_transfer(msg.size());
+                s.write(msg.data(), msg.size());
                 obj.unpack(s);
                 s.clear();
             }
 
             void deserialize_recv_(std::stringstream& s, int i, int j = 0, MESSAGE_TYPE mt = NORM_MSG) {
-                int string_size = 0;
-                char* c = (char*)io->recv_data(i, string_size, j, mt);
-                if (c == nullptr || string_size <= sizeof(int)) {
-                    std::cerr << "[Error] Invalid data received from party " << i << std::endl;
-                    return;
-                }
-                simulate_network_transfer((size_t)string_size);
+                MsgView msg = deserialize_recv_view(i, j, mt);
+                s.write(msg.data(), msg.size());
+            }
 
-                int sender_id = 0;
-                memcpy(&sender_id, c, sizeof(int));
-                {
-                    s.write(c + sizeof(int), string_size - sizeof(int));
+            // Counterpart of serialize_sendall_/serialize_sendp2p that skips the
+            // stringstream: the returned view points into the receive buffer.
+            // Unpack from it with cybozu::MemoryInputStream(msg.data(), msg.size()).
+            MsgView deserialize_recv_view(int i, int j = 0, MESSAGE_TYPE mt = NORM_MSG) {
+                MsgView msg = io->recv_view(i, j, mt);
+                if (msg.size() <= sizeof(int)) {
+                    std::cerr << "[Error] Invalid data received from party " << i << std::endl;
+                    return MsgView();
                 }
-
-                free(c);
+                simulate_network_transfer(msg.size());
+                msg.remove_prefix(sizeof(int));
+                return msg;
             }
 
             void serialize_send_with_tag(std::stringstream& s, int i, int tag, MESSAGE_TYPE mt = NORM_MSG) {
                 string str = s.str();
                 int string_size = str.size();
-                char* c = (char*)malloc(sizeof(int) + string_size);
-                memcpy(c, &tag, sizeof(int));
-                memcpy(c + sizeof(int), str.data(), string_size);
+                struct iovec parts[2] = {{&tag, sizeof(int)}, {(void*)str.data(), (size_t)string_size}};
                 simulate_network_transfer(sizeof(int) + string_size);
-                io->send_data(i, c, sizeof(int) + string_size, 0, mt);
+                io->send_data_v(i, parts, 2, 0, mt);
                 io->flush(i, 0);
-                free(c);
                 s.clear();
             }
 
             void deserialize_recv_with_tag(std::stringstream& s, int i, int tag, MESSAGE_TYPE mt = NORM_MSG) {
                 while (true) {
-                    int string_size = 0;
-                    char* c = (char*)io->recv_data(i, string_size, 0, mt);
-                    if (c == nullptr || string_size < sizeof(int)) {
+                    MsgView msg = io->recv_view(i, 0, mt);
+                    if (msg.size() < sizeof(int)) {
                         std::cerr << "[Error] Invalid data received from party " << i << std::endl;
-                        free(c);
                         continue;
                     }
-                    int recv_tag = 0;
-                    memcpy(&recv_tag, c, sizeof(int));
-                    if (recv_tag == tag) {
-                        s.write(c + sizeof(int), string_size - sizeof(int));
-                        free(c);
+                    if (msg.read_pod<int>() == tag) {
+                        s.write(msg.data(), msg.size());
                         break;
-                    } else {
-                        free(c);
-                        continue;
                     }
                 }
                 s.clear();
@@ -394,22 +315,9 @@ namespace emp {
             void serialize_sendall_with_tag(std::stringstream& s, int tag, int j = 0, MESSAGE_TYPE mt = NORM_MSG) {
                 string str = s.str();
                 int string_size = str.size();
-                std::vector<std::future<void>> res;
-                for (int i = 1; i <= num_party; ++i) {
-                    if (i != party) {
-                        char* c = (char*)malloc(sizeof(int) + string_size);
-                        memcpy(c, &tag, sizeof(int));
-                        memcpy(c + sizeof(int), str.data(), string_size);
-                        res.push_back(std::async([this, i, c, string_size, j, mt]() {
-                            simulate_network_transfer(sizeof(int) + string_size);
-                            io->send_data(i, c, sizeof(int) + string_size, j, mt);
-                            io->flush(i, j);
-                            free(c);
-                        }));
-                    }
-                }
-                for (auto& fut : res) fut.get();
-                res.clear();
+                struct iovec parts[2] = {{&tag, sizeof(int)}, {(void*)str.data(), (size_t)string_size}};
+                simulate_network_transfer(sizeof(int) + string_size);
+                io->broadcast_data_v(parts, 2, j, mt);
                 s.clear();
             }
     };
@@ -134,21 +134,8 @@ public:
         lbcrypto::Serial::Serialize(obj, s, lbcrypto::SerType::BINARY);
         string str      = s.str();
         int string_size = str.size();
-        char* c         = (char*)malloc(string_size);
-        s.read(c, string_size);
-        std::vector<std::future<void>> res;
-        for (int i = 1; i <= num_party; ++i) {
-            if (i != party) {
-                res.push_back(std::async([this, i, c, string_size, j, mt]() {
-                    io->send_data(i, c, string_size, j, mt);
-                    io->flush(i, j);
-                }));
-            }
-        }
-        for (auto& fut : res)
-            fut.get();
-        res.clear();
-        free(c);
+        struct iovec parts[1] = {{(void*)str.data(), (size_t)string_size}};
+        io->broadcast_data_v(parts, 1, j, mt);
         s.clear();
     }
 
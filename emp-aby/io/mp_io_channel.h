@@ -1,6 +1,8 @@
 #pragma once
 
 #include <emp-tool/emp-tool.h>
+#include <sys/uio.h>
+#include "emp-aby/io/msg_buffer.hpp"
 
 namespace emp {
 enum MESSAGE_TYPE : uint8_t { NORM_MSG = 0, BOOT_REQ_MSG = 1, BOOT_RSP_MSG = 2, TERMINATE_MSG = 3 };
@@ -10,6 +12,11 @@ public:
     virtual void send_data(int dst, const void* data, int len, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG) = 0;
     virtual void recv_data(int src, void* data, int len, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG)       = 0;
     virtual void* recv_data(int src, int& len, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG)                 = 0;
+    virtual void send_data_v(int dst, const struct iovec* parts, int cnt, int j = 0,
+                             MESSAGE_TYPE msg_type = NORM_MSG)                                              = 0;
+    virtual MsgView recv_view(int src, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG)                         = 0;
+    virtual void broadcast_data_v(const struct iovec* parts, int cnt, int j = 0,
+                                  MESSAGE_TYPE msg_type = NORM_MSG)                                         = 0;
     virtual void send_bool(int dst, bool* data, int length, int j = 0)                                      = 0;
     virtual void recv_bool(int src, bool* data, int length, int j = 0)                                      = 0;
     virtual void send_block(int dst, const block* data, int length, int j = 0)                              = 0;
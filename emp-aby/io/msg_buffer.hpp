@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace emp {
+
+// Per-connection cache of receive buffers, bucketed by power-of-two size
+// class so a buffer can be returned knowing only the message length.
+// Buffers come from malloc, so callers that take ownership may free() them.
+class RecvBufferPool {
+public:
+    static const int kMinClass = 6;
+    static const int kMaxClass = 32;
+    static const size_t kMaxCached = 8;
+
+    RecvBufferPool() = default;
+    RecvBufferPool(const RecvBufferPool&) = delete;
+    RecvBufferPool& operator=(const RecvBufferPool&) = delete;
+
+    ~RecvBufferPool() {
+        for (auto& bucket : free_list)
+            for (void* p : bucket) free(p);
+    }
+
+    static int size_class(size_t len) {
+        int k = kMinClass;
+        while (k < kMaxClass && (size_t(1) << k) < len) ++k;
+        return k;
+    }
+
+    void* acquire(size_t len) {
+        int k = size_class(len);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto& bucket = free_list[k];
+            if (!bucket.empty()) {
+                void* p = bucket.back();
+                bucket.pop_back();
+                return p;
+            }
+        }
+        void* p = malloc(size_t(1) << k);
+        if (p == nullptr) throw std::bad_alloc();
+        return p;
+    }
+
+    void release(void* p, size_t len) {
+        if (p == nullptr) return;
+        int k = size_class(len);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto& bucket = free_list[k];
+            if (bucket.size() < kMaxCached) {
+                bucket.push_back(p);
+                return;
+            }
+        }
+        free(p);
+    }
+
+private:
+    std::mutex mtx;
+    std::vector<void*> free_list[kMaxClass + 1];
+};
+
+// Read-only view of one received message. The underlying buffer goes back
+// to its connection's pool when the view is destroyed.
+class MsgView {
+public:
+    MsgView() = default;
+    MsgView(char* base, size_t len, RecvBufferPool* pool) : base(base), len(len), pos(0), pool(pool) {}
+    MsgView(const MsgView&) = delete;
+    MsgView& operator=(const MsgView&) = delete;
+    MsgView(MsgView&& o) noexcept : base(o.base), len(o.len), pos(o.pos), pool(o.pool) {
+        o.base = nullptr;
+        o.pool = nullptr;
+    }
+    MsgView& operator=(MsgView&& o) noexcept {
+        if (this != &o) {
+            reset();
+            base = o.base; len = o.len; pos = o.pos; pool = o.pool;
+            o.base = nullptr;
+            o.pool = nullptr;
+        }
+        return *this;
+    }
+    ~MsgView() { reset(); }
+
+    const char* data() const { return base + pos; }
+    size_t size() const { return len - pos; }
+    bool empty() const { return size() == 0; }
+
+    void remove_prefix(size_t n) {
+        if (n > size()) throw std::runtime_error("MsgView: prefix past end");
+        pos += n;
+    }
+
+    template <typename T>
+    T read_pod() {
+        T v;
+        if (sizeof(T) > size()) throw std::runtime_error("MsgView: truncated");
+        memcpy(&v, data(), sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+private:
+    void reset() {
+        if (pool) pool->release(base, len);
+        else free(base);
+        base = nullptr;
+        pool = nullptr;
+    }
+
+    char* base = nullptr;
+    size_t len = 0;
+    size_t pos = 0;
+    RecvBufferPool* pool = nullptr;
+};
+
+}  // namespace emp
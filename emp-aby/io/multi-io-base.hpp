@@ -2,7 +2,12 @@
 
 #include <shared_mutex>
 #include <sys/select.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <memory>
 #include "emp-aby/io/util.hpp"
+#include "emp-aby/io/msg_buffer.hpp"
+#include "emp-aby/io/spsc_ring.hpp"
 
 namespace emp {
 class MultiIOBase : public IOChannel<MultiIOBase> {
@@ -11,12 +16,40 @@ public:
     int consocket = -1;
     std::shared_mutex sock_mutex;
     bool continue_comm = false;
-    std::deque<std::pair<int, void*>> recv_msg_queue[3];
-    std::condition_variable recv_condition_vars[3];
-    std::mutex recv_mutex[3];
+    // One ring per message type; background_recv is the only producer.
+    SPSCRing<std::pair<int, void*>> recv_ring[3];
+    RecvBufferPool recv_pool;
+    static const int kMaxParts = 7;
+
+    // Partially received message, for the non-blocking recv_available path.
+    char pending_hdr[5];
+    size_t pending_hdr_got = 0;
+    void* pending_buf      = nullptr;
+    int pending_len        = 0;
+    size_t pending_got     = 0;
+
+    // Outbound messages for this peer, written in FIFO order by a dedicated
+    // sender thread that coalesces everything queued into batched writev calls.
+    // Small payloads are copied and the caller returns at once; large ones
+    // are sent from the caller's memory and the caller waits on `done`.
+    static const size_t kCopyThreshold = 1 << 16;
+    static const size_t kMaxIov        = 1024;
+    struct SendJob {
+        char hdr[5];
+        std::shared_ptr<const std::string> owned;
+        struct iovec parts[kMaxParts];
+        int cnt                      = 0;
+        std::atomic<uint32_t>* done = nullptr;
+    };
+    std::mutex send_mutex;
+    std::condition_variable send_cv;
+    std::vector<SendJob> send_queue;
+    bool send_stop = false;
+    std::thread sender;
 
     MultiIOBase(int consocket, bool quiet = false) : consocket(consocket), continue_comm(true) {
         set_nodelay();
+        sender = std::thread([this]() { this->send_loop(); });
         if (!quiet)
             std::cout << "connected\n";
     }
@@ -25,6 +58,14 @@ public:
     void flush() {}
 
     ~MultiIOBase() {
+        if (sender.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(send_mutex);
+                send_stop = true;
+            }
+            send_cv.notify_one();
+            sender.join();
+        }
         close(consocket);
     }
 
@@ -39,24 +80,110 @@ public:
     }
 
     void send_msg(const void* data, int len, MESSAGE_TYPE msg_type = NORM_MSG) {
-        char* meta_buff = (char*)malloc(5);
-        meta_buff[0]    = msg_type;
-        memcpy(meta_buff + 1, &(len), 4);
-        std::shared_lock lock(sock_mutex);
-        this->send_data(meta_buff, 5);
-        if(msg_type != TERMINATE_MSG)
-            this->send_data(data, len);
-        lock.unlock();
-        free(meta_buff);
+        struct iovec part = {const_cast<void*>(data), (size_t)len};
+        send_msgv(&part, msg_type == TERMINATE_MSG ? 0 : 1, msg_type);
+    }
+
+    void send_msgv(const struct iovec* parts, int cnt, MESSAGE_TYPE msg_type = NORM_MSG) {
+        if (cnt > kMaxParts)
+            error("send_msgv: too many parts");
+        size_t len = 0;
+        for (int i = 0; i < cnt; ++i)
+            len += parts[i].iov_len;
+        if (len <= kCopyThreshold) {
+            post(gather(parts, cnt), msg_type);
+            return;
+        }
+        SendJob job;
+        std::atomic<uint32_t> done{0};
+        for (int i = 0; i < cnt; ++i)
+            job.parts[i] = parts[i];
+        job.cnt  = cnt;
+        job.done = &done;
+        enqueue(std::move(job), len, msg_type);
+        while (done.load(std::memory_order_acquire) == 0)
+            futex_wait_word(&done, 0);
+    }
+
+    // Queues a payload shared with other peers (see MultiIO::broadcast_data_v).
+    void post(std::shared_ptr<const std::string> payload, MESSAGE_TYPE msg_type = NORM_MSG) {
+        SendJob job;
+        size_t len = 0;
+        if (msg_type != TERMINATE_MSG) {
+            len          = payload->size();
+            job.parts[0] = {(void*)payload->data(), len};
+            job.cnt      = 1;
+        }
+        job.owned = std::move(payload);
+        enqueue(std::move(job), len, msg_type);
+    }
+
+    static std::shared_ptr<const std::string> gather(const struct iovec* parts, int cnt) {
+        size_t len = 0;
+        for (int i = 0; i < cnt; ++i)
+            len += parts[i].iov_len;
+        auto buf = std::make_shared<std::string>();
+        buf->reserve(len);
+        for (int i = 0; i < cnt; ++i)
+            buf->append((const char*)parts[i].iov_base, parts[i].iov_len);
+        return buf;
+    }
+
+    void enqueue(SendJob&& job, size_t len, MESSAGE_TYPE msg_type) {
+        int len32   = len;
+        job.hdr[0] = msg_type;
+        memcpy(job.hdr + 1, &len32, 4);
+        {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            // Counted when queued so get_total_bytes_sent() is exact as soon
+            // as the send call returns.
+            this->counter += 5 + len;
+            send_queue.push_back(std::move(job));
+        }
+        send_cv.notify_one();
+    }
+
+    // counter is only written under send_mutex, so it is read under it too.
+    uint64_t bytes_sent() {
+        std::lock_guard<std::mutex> lock(send_mutex);
+        return this->counter;
+    }
+
+    void send_loop() {
+        std::vector<SendJob> batch;
+        std::vector<struct iovec> iov;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(send_mutex);
+                send_cv.wait(lock, [this] { return send_stop || !send_queue.empty(); });
+                if (send_queue.empty())
+                    return;
+                batch.swap(send_queue);
+            }
+            iov.clear();
+            for (auto& job : batch) {
+                iov.push_back({job.hdr, 5});
+                for (int i = 0; i < job.cnt; ++i)
+                    iov.push_back(job.parts[i]);
+            }
+            for (size_t off = 0; off < iov.size(); off += kMaxIov) {
+                std::shared_lock lock(sock_mutex);
+                send_iov_internal(iov.data() + off, std::min(kMaxIov, iov.size() - off));
+            }
+            for (auto& job : batch) {
+                if (job.done) {
+                    job.done->store(1, std::memory_order_release);
+                    futex_wake_word(job.done);
+                }
+            }
+            batch.clear();
+        }
     }
 
     bool recv_msg() {
-        char* meta_buff = (char*)malloc(5);
+        char meta_buff[5];
         std::shared_lock lock(sock_mutex);
 
-        // add select here
-        // select(consocket, );
-
         this->recv_data(meta_buff, 5);
         MESSAGE_TYPE recv_type = static_cast<MESSAGE_TYPE>(meta_buff[0]);
         if (recv_type == TERMINATE_MSG) {
@@ -64,21 +191,82 @@ public:
             this->continue_comm = false;
             return false;
         }
+        if (recv_type >= TERMINATE_MSG)
+            error("recv_msg: unknown message type\n");
 
         int len;
         memcpy(&(len), meta_buff + 1, 4);
-        // std::cout << "received length" << len << std::endl;
-        void* data = malloc(len);
+        void* data = recv_pool.acquire(len);
         this->recv_data(data, len);
         lock.unlock();
 
-        std::unique_lock que_lock(recv_mutex[recv_type]);
-        recv_msg_queue[recv_type].push_back(std::pair<int, void*>(len, data));
-        que_lock.unlock();
-        recv_condition_vars[recv_type].notify_one();
+        recv_ring[recv_type].push(std::pair<int, void*>(len, data));
         return true;
     }
 
+    // Non-blocking counterpart of recv_msg for event-loop backends: consumes
+    // whatever the socket has buffered (up to budget bytes) and resumes the
+    // current message on the next call. Returns false once the peer has sent
+    // TERMINATE_MSG.
+    bool recv_available(size_t budget = 1 << 20) {
+        size_t consumed = 0;
+        while (consumed < budget) {
+            if (pending_hdr_got < 5) {
+                ssize_t res = recv(consocket, pending_hdr + pending_hdr_got, 5 - pending_hdr_got, MSG_DONTWAIT);
+                if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                    return true;
+                if (res <= 0)
+                    error("net_recv_data\n");
+                pending_hdr_got += res;
+                consumed += res;
+                if (pending_hdr_got < 5)
+                    continue;
+                if (static_cast<MESSAGE_TYPE>(pending_hdr[0]) == TERMINATE_MSG) {
+                    pending_hdr_got     = 0;
+                    this->continue_comm = false;
+                    return false;
+                }
+                if (static_cast<uint8_t>(pending_hdr[0]) >= TERMINATE_MSG)
+                    error("recv_msg: unknown message type\n");
+                memcpy(&pending_len, pending_hdr + 1, 4);
+                pending_buf = recv_pool.acquire(pending_len);
+                pending_got = 0;
+            }
+            if (pending_got < (size_t)pending_len) {
+                ssize_t res = recv(consocket, (char*)pending_buf + pending_got, pending_len - pending_got, MSG_DONTWAIT);
+                if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                    return true;
+                if (res <= 0)
+                    error("net_recv_data\n");
+                pending_got += res;
+                consumed += res;
+                if (pending_got < (size_t)pending_len)
+                    continue;
+            }
+            recv_ring[static_cast<uint8_t>(pending_hdr[0])].push(std::pair<int, void*>(pending_len, pending_buf));
+            pending_hdr_got = 0;
+            pending_buf     = nullptr;
+        }
+        return true;
+    }
+
+    void send_iov_internal(struct iovec* iov, int cnt) {
+        while (cnt > 0) {
+            ssize_t res = writev(consocket, iov, cnt);
+            if (res <= 0)
+                error("net_send_data\n");
+            while (cnt > 0 && (size_t)res >= iov->iov_len) {
+                res -= iov->iov_len;
+                ++iov;
+                --cnt;
+            }
+            if (cnt > 0) {
+                iov->iov_base = (char*)iov->iov_base + res;
+                iov->iov_len -= res;
+            }
+        }
+    }
+
     void send_data_internal(const void* data, size_t len) {
         size_t sent = 0;
         while (sent < len) {
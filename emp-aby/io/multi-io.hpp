@@ -3,8 +3,24 @@
 #include "emp-aby/io/mp_io_channel.h"
 #include "emp-aby/io/multi-io-base.hpp"
 #include <poll.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 namespace emp {
+// How incoming messages are read off the peer sockets.
+//   POLL:         one thread polls all peers and reads each message whole.
+//   EPOLL:        one thread, non-blocking reads, messages reassembled
+//                 incrementally so a large message never stalls other peers.
+//   PEER_THREADS: one blocking reader thread per peer.
+enum class RecvBackend { POLL, EPOLL, PEER_THREADS };
+
+#if defined(__linux__)
+const RecvBackend default_recv_backend = RecvBackend::EPOLL;
+#else
+const RecvBackend default_recv_backend = RecvBackend::POLL;
+#endif
+
 class MultiIO : public MPIOChannel<MultiIOBase> {
 private:
     /* data */
@@ -16,8 +32,10 @@ public:
     std::map<uint, MultiIOBase*> ios;
     std::map<uint, MultiIOBase*> ot_ios[2];
     bool continue_comm;
+    RecvBackend backend;
     std::future<void> background_recv_fut;
-    MultiIO(int party, int num_party, std::vector<std::pair<std::string, unsigned short>>& net_config);
+    MultiIO(int party, int num_party, std::vector<std::pair<std::string, unsigned short>>& net_config,
+            RecvBackend backend = default_recv_backend);
     ~MultiIO();
 
     void setup_ot_ios();
@@ -25,6 +43,9 @@ public:
     void broadcast_data(int party_num, const void* data, int len, int j, MESSAGE_TYPE msg_type = NORM_MSG);
     void recv_data(int src, void* data, int len, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG);
     void* recv_data(int src, int& len, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG);
+    void send_data_v(int dst, const struct iovec* parts, int cnt, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG);
+    void broadcast_data_v(const struct iovec* parts, int cnt, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG);
+    MsgView recv_view(int src, int j = 0, MESSAGE_TYPE msg_type = NORM_MSG);
 
     uint64_t get_total_bytes_sent();
 
@@ -57,14 +78,18 @@ public:
     }
 
     void background_recv();
+    void background_recv_epoll();
+    void background_recv_peer_threads();
 };
 
-MultiIO::MultiIO(int party, int num_party, std::vector<std::pair<std::string, unsigned short>>& net_config)
+MultiIO::MultiIO(int party, int num_party, std::vector<std::pair<std::string, unsigned short>>& net_config,
+                 RecvBackend backend)
     : party(party),
       num_party(num_party),
       bind_port(net_config[party - 1].second),
       bind_address(net_config[party - 1].first),
-      net_config(net_config) {
+      net_config(net_config),
+      backend(backend) {
     std::map<uint, int> socket_map;
     accept_base_connections(num_party - party, net_config[party - 1].second, net_config[party - 1].first, socket_map,
                             party, num_party);
@@ -78,8 +103,17 @@ MultiIO::MultiIO(int party, int num_party, std::vector<std::pair<std::string, un
     }
     socket_map.clear();
     continue_comm       = true;
-    background_recv_fut = std::async([this]() {
-        this->background_recv();
+    background_recv_fut = std::async(std::launch::async, [this]() {
+        switch (this->backend) {
+            case RecvBackend::EPOLL:
+                this->background_recv_epoll();
+                break;
+            case RecvBackend::PEER_THREADS:
+                this->background_recv_peer_threads();
+                break;
+            default:
+                this->background_recv();
+        }
     });
 }
 
@@ -149,44 +183,30 @@ void MultiIO::send_data(int dst, const void* data, int len, int j, MESSAGE_TYPE
     }
 }
 void MultiIO::broadcast_data(int party_num, const void* data, int len, int j, MESSAGE_TYPE msg_type) {
-    ThreadPool pool(party_num<std::thread::hardware_concurrency()? party_num: std::thread::hardware_concurrency());
-    std::vector<std::future<void>> futures;
-
+    auto payload = std::make_shared<const std::string>((const char*)data, len);
     for (int i = 1; i <= party_num; ++i) {
-        if (i!= party) {
-            futures.push_back(pool.enqueue([this, i, data, len, j, msg_type]() {
-                this->send_data(i, data, len, j, msg_type);
-            }));
-        }
+        if (i != party)
+            ios[i]->post(payload, msg_type);
     }
+}
 
-    for (auto& fut : futures) {
-        fut.get();
-    }
+// One copy of the payload is shared by every peer's send queue; returns as
+// soon as it is queued.
+void MultiIO::broadcast_data_v(const struct iovec* parts, int cnt, int j, MESSAGE_TYPE msg_type) {
+    auto payload = MultiIOBase::gather(parts, cnt);
+    for (auto& io : ios)
+        io.second->post(payload, msg_type);
 }
 void MultiIO::recv_data(int src, void* data, int len, int j, MESSAGE_TYPE msg_type) {
     if (src != 0 && src != party) {
         MultiIOBase* io = ios[src];
-        bool received   = false;
-        while (!received) {
-            std::unique_lock lock(io->recv_mutex[msg_type]);
-            if (!io->recv_msg_queue[msg_type].empty()) {
-                received     = true;
-                int recv_len = io->recv_msg_queue[msg_type].front().first;
-                if (len != recv_len) {
-                    std::cout << "\n" << party << " " << src << " lengths " << len << " " << recv_len << "\n";
-                    error("unequal length");
-                }
-                memcpy(data, io->recv_msg_queue[msg_type].front().second, len);
-                io->recv_msg_queue[msg_type].pop_front();
-                lock.unlock();
-                return;
-            }
-            else {
-                io->recv_condition_vars[msg_type].wait(
-                    lock, [io, msg_type] { return !io->recv_msg_queue[msg_type].empty(); });
-            }
+        auto msg        = io->recv_ring[msg_type].pop();
+        if (len != msg.first) {
+            std::cout << "\n" << party << " " << src << " lengths " << len << " " << msg.first << "\n";
+            error("unequal length");
         }
+        memcpy(data, msg.second, len);
+        io->recv_pool.release(msg.second, len);
     }
     else {
         error("receive called for invalid party");
@@ -194,43 +214,46 @@ void MultiIO::recv_data(int src, void* data, int len, int j, MESSAGE_TYPE msg_ty
 }
 
 void* MultiIO::recv_data(int src, int& len, int j, MESSAGE_TYPE msg_type) {
-    void* data = nullptr;
     if (src != 0 and src != party) {
-        MultiIOBase* io = ios[src];
-        bool received   = false;
-        while (!received) {
-            std::unique_lock lock(io->recv_mutex[msg_type]);
-            if (!io->recv_msg_queue[msg_type].empty()) {
-                received     = true;
-                int recv_len = io->recv_msg_queue[msg_type].front().first;
-                len          = recv_len;
-                data         = io->recv_msg_queue[msg_type].front().second;
-                io->recv_msg_queue[msg_type].pop_front();
-                lock.unlock();
-                return data;
-            }
-            else {
-                io->recv_condition_vars[msg_type].wait(
-                    lock, [io, msg_type] { return !io->recv_msg_queue[msg_type].empty(); });
-            }
-        }
+        auto msg = ios[src]->recv_ring[msg_type].pop();
+        len      = msg.first;
+        return msg.second;
     }
     else {
         error("receive called for invalid party");
     }
-    return data;
+    return nullptr;
+}
+
+void MultiIO::send_data_v(int dst, const struct iovec* parts, int cnt, int j, MESSAGE_TYPE msg_type) {
+    if (dst != 0 && dst != party) {
+        ios[dst]->send_msgv(parts, cnt, msg_type);
+    }
+    else {
+        error("sending to invalid party");
+    }
+}
+
+// Hands out the queued buffer itself; it returns to the connection's pool
+// when the view goes out of scope.
+MsgView MultiIO::recv_view(int src, int j, MESSAGE_TYPE msg_type) {
+    if (src == 0 || src == party)
+        error("receive called for invalid party");
+    MultiIOBase* io = ios[src];
+    auto msg        = io->recv_ring[msg_type].pop();
+    return MsgView((char*)msg.second, msg.first, &io->recv_pool);
 }
 
 uint64_t MultiIO::get_total_bytes_sent() {
     uint64_t total = 0;
     for (auto& io : this->ios) {
-        total += io.second->counter;
+        total += io.second->bytes_sent();
     }
     for (auto& io : this->ot_ios[0]) {
-        total += io.second->counter;
+        total += io.second->bytes_sent();
     }
     for (auto& io : this->ot_ios[1]) {
-        total += io.second->counter;
+        total += io.second->bytes_sent();
     }
     return total;
 }
@@ -263,6 +286,9 @@ void MultiIO::background_recv() {
                 if (pfds[i].revents & POLLIN) {
                     int p = socket_party[pfds[i].fd];
                     c     = ios[p]->recv_msg();
+                    // The peer closes its socket after TERMINATE; stop polling it.
+                    if (!c)
+                        pfds[i].fd = -1;
                 }
             }
         }
@@ -275,4 +301,54 @@ void MultiIO::background_recv() {
     }
 }
 
-}  // namespace emp
\ No newline at end of file
+void MultiIO::background_recv_epoll() {
+#if defined(__linux__)
+    int epfd = epoll_create1(0);
+    if (epfd == -1)
+        error("error: epoll_create1");
+    for (auto& io : ios) {
+        struct epoll_event ev;
+        ev.events   = EPOLLIN;
+        ev.data.ptr = io.second;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, io.second->consocket, &ev) == -1)
+            error("error: epoll_ctl");
+    }
+    size_t active = ios.size();
+    std::vector<struct epoll_event> events(ios.size());
+    while (active > 0) {
+        int ready = epoll_wait(epfd, events.data(), events.size(), -1);
+        if (ready == -1) {
+            if (errno == EINTR)
+                continue;
+            error("error: epoll_wait");
+        }
+        for (int i = 0; i < ready; ++i) {
+            MultiIOBase* io = static_cast<MultiIOBase*>(events[i].data.ptr);
+            if (!io->recv_available()) {
+                epoll_ctl(epfd, EPOLL_CTL_DEL, io->consocket, nullptr);
+                --active;
+            }
+        }
+    }
+    close(epfd);
+    continue_comm = false;
+#else
+    background_recv();
+#endif
+}
+
+void MultiIO::background_recv_peer_threads() {
+    std::vector<std::thread> readers;
+    for (auto& io : ios) {
+        MultiIOBase* peer = io.second;
+        readers.emplace_back([peer]() {
+            while (peer->recv_msg()) {
+            }
+        });
+    }
+    for (auto& t : readers)
+        t.join();
+    continue_comm = false;
+}
+
+}  // namespace emp
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace emp {
+
+// Sleep/wake on a 32-bit word. Falls back to yielding where futex is missing.
+inline void futex_wait_word(std::atomic<uint32_t>* word, uint32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    if (word->load(std::memory_order_acquire) == expected)
+        std::this_thread::yield();
+#endif
+}
+
+inline void futex_wake_word(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+// Single-producer ring. The producer (the background receive thread)
+// never blocks: one such thread serves every peer under the poll and epoll
+// backends, so a full ring must not stall traffic for the others. Cap
+// messages fit in the lock-free ring; past that the producer spills into an
+// unbounded overflow list, and stays on it until consumers have drained it,
+// which keeps FIFO order. Consumers are expected to be one task per
+// (peer, message type); a consumer-side flag keeps the ring safe if two
+// receivers do overlap. Consumers spin briefly, then sleep on a futex
+// sequence word.
+template <typename T, size_t Cap = 4096>
+class SPSCRing {
+    static_assert((Cap & (Cap - 1)) == 0, "SPSCRing capacity must be a power of two");
+
+public:
+    static const int kSpin = 256;
+
+    void push(const T& v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (overflow_n.load(std::memory_order_acquire) != 0 || t - head.load(std::memory_order_acquire) == Cap) {
+            std::lock_guard<std::mutex> lk(overflow_mtx);
+            // Only the producer adds to the overflow, so a ring slot may be
+            // used again only once consumers have emptied it.
+            if (overflow.empty() && t - head.load(std::memory_order_acquire) != Cap) {
+                push_ring(t, v);
+            } else {
+                overflow.push_back(v);
+                overflow_n.store(overflow.size(), std::memory_order_release);
+            }
+        } else {
+            push_ring(t, v);
+        }
+        data_seq.fetch_add(1, std::memory_order_seq_cst);
+        if (consumers_waiting.load(std::memory_order_seq_cst) != 0)
+            futex_wake_word(&data_seq);
+    }
+
+    bool try_pop(T& out) {
+        while (consumer_busy.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+        size_t h = head.load(std::memory_order_relaxed);
+        bool ok  = h != tail.load(std::memory_order_acquire);
+        if (ok) {
+            out = slots[h & (Cap - 1)];
+            head.store(h + 1, std::memory_order_release);
+        } else if (overflow_n.load(std::memory_order_acquire) != 0) {
+            // The ring is empty, so everything older has been taken.
+            std::lock_guard<std::mutex> lk(overflow_mtx);
+            if (!overflow.empty()) {
+                out = overflow.front();
+                overflow.pop_front();
+                overflow_n.store(overflow.size(), std::memory_order_release);
+                ok = true;
+            }
+        }
+        consumer_busy.clear(std::memory_order_release);
+        return ok;
+    }
+
+    T pop() {
+        T out;
+        for (int i = 0; i < kSpin; ++i) {
+            if (try_pop(out))
+                return out;
+        }
+        for (;;) {
+            consumers_waiting.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t s = data_seq.load(std::memory_order_seq_cst);
+            if (try_pop(out)) {
+                consumers_waiting.fetch_sub(1, std::memory_order_relaxed);
+                return out;
+            }
+            futex_wait_word(&data_seq, s);
+            consumers_waiting.fetch_sub(1, std::memory_order_relaxed);
+            if (try_pop(out))
+                return out;
+        }
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire) &&
+               overflow_n.load(std::memory_order_acquire) == 0;
+    }
+
+    // Messages currently spilled past the ring.
+    size_t overflowed() const { return overflow_n.load(std::memory_order_acquire); }
+
+private:
+    void push_ring(size_t t, const T& v) {
+        slots[t & (Cap - 1)] = v;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<size_t> head{0};
+    std::atomic<uint32_t> consumers_waiting{0};
+    std::atomic_flag consumer_busy = ATOMIC_FLAG_INIT;
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<uint32_t> data_seq{0};
+    alignas(64) std::atomic<size_t> overflow_n{0};
+    std::mutex overflow_mtx;
+    std::deque<T> overflow;
+    alignas(64) T slots[Cap];
+};
+
+}  // namespace emp
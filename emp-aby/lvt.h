@@ -16,6 +16,7 @@
 #include "libelgl/elgl/FFT_Para_Optimized.hpp"
 #include "emp-aby/BSGS.hpp"
 #include "emp-aby/P2M.hpp"
+#include "emp-aby/point_table.hpp"
 // #include "libelgl/elgl/FFT_Para_AccelerateCompatible.hpp"
 
 #if defined(__APPLE__) || defined(__MACH__)
@@ -95,6 +96,118 @@ Plaintext set_challenge(const std::stringstream& ciphertexts) {
     return challenge;
 }
 
+// x mod modulo on canonical values; Vint only for moduli wider than 64 bits.
+inline Plaintext lvt_mod(const Plaintext& x, const mcl::Vint& modulo) {
+    Plaintext out;
+    if (modulo.getUnitSize() == 1 && !modulo.isNegative() && !modulo.isZero()) {
+        out.assign_uint64(x.mod_uint64(modulo.getUnit()[0]));
+    } else {
+        mcl::Vint v = x.get_message().getMpz();
+        v %= modulo;
+        out.assign(v);
+    }
+    return out;
+}
+
+// One rotated instance of a table: everything generate_shares produces and
+// a lookup consumes. Instances of the same LVT share keys and table.
+struct LutInstance {
+    Plaintext rotation;
+    vector<Plaintext> lut_share;
+    PointTable cip_lut;
+    vector<Ciphertext> cr_i;
+};
+
+// Output ciphertexts of a batch lookup, Ciphertext(user_pk[p], cip_lut[p][idx]),
+// kept as table indices. It shares the table instance it was read from, so
+// it stays valid when the LVT installs a new instance.
+class LutOutput {
+    public:
+    LutOutput() = default;
+    LutOutput(std::shared_ptr<const PointTable> table, vector<BLS12381Element> c0, vector<uint32_t> idx)
+        : table(std::move(table)), c0(std::move(c0)), idx(std::move(idx)) {}
+
+    size_t size() const { return idx.size(); }
+    size_t parties() const { return c0.size(); }
+    const vector<uint32_t>& indices() const { return idx; }
+
+    Ciphertext at(size_t p, size_t i) const { return Ciphertext(c0[p], table->at(p, idx[i])); }
+
+    // All parties' ciphertexts for element i, as L2A and Reconstruct take them.
+    vector<Ciphertext> element(size_t i) const {
+        vector<Ciphertext> out(c0.size());
+        for (size_t p = 0; p < c0.size(); ++p) out[p] = at(p, i);
+        return out;
+    }
+
+    vector<vector<Ciphertext>> materialize(ThreadPool* pool = nullptr) const {
+        vector<vector<Ciphertext>> out(c0.size(), vector<Ciphertext>(idx.size()));
+        emp::parallel_for(pool, 0, idx.size(), [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; ++i)
+                for (size_t p = 0; p < c0.size(); ++p) out[p][i] = at(p, i);
+        });
+        return out;
+    }
+
+    private:
+    std::shared_ptr<const PointTable> table;
+    vector<BLS12381Element> c0;
+    vector<uint32_t> idx;
+};
+
+// Per-process state shared by every LVT over the same parties: the joint
+// key, the user keys and the discrete-log indexes. Tables attached to one
+// context only add their own table data.
+template <typename IO>
+class LVTContext {
+    public:
+    int num_party = 0;
+    int party = 0;
+    MPIOChannel<IO>* io = nullptr;
+    ThreadPool* pool = nullptr;
+    ELGL<IO>* elgl = nullptr;
+    ELGL_PK global_pk;
+    std::vector<ELGL_PK> user_pk;
+    emp::BSGSPrecomputation bsgs;
+    SmallDlogIndex P_to_m;
+    bool keyed = false;
+
+    LVTContext() = default;
+    LVTContext(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl)
+        : num_party(num_party), party(party), io(io), pool(pool), elgl(elgl), user_pk(num_party) {
+        user_pk[party-1] = elgl->kp.get_pk();
+    }
+    // Grows P_to_m to cover max_exponent; tables that need less reuse it.
+    void require_P_to_m(uint64_t max_exponent, const std::string& cache_file);
+    void require_bsgs();
+};
+
+template <typename IO>
+void LVTContext<IO>::require_P_to_m(uint64_t max_exponent, const std::string& cache_file) {
+    if (!P_to_m.empty() && P_to_m.max_exponent >= std::min<uint64_t>(max_exponent, 1ULL << 24)) return;
+    if (max_exponent <= 65536) {
+        build_safe_P_to_m(P_to_m, max_exponent);
+        return;
+    }
+    load_or_build_P_to_m(P_to_m, max_exponent, cache_file);
+}
+
+template <typename IO>
+void LVTContext<IO>::require_bsgs() {
+    if (bsgs.n != 0) return;
+    std::string bsgs_cache = "../cache/bsgs_40.bin";
+    uint64_t N = 1ULL << 32;
+    if (fs::exists(bsgs_cache)) {
+        try {
+            bsgs.deserialize(bsgs_cache.c_str());
+            return;
+        } catch (const std::exception& e) {
+        }
+    }
+    bsgs.precompute(BLS12381Element::generator(), N);
+    bsgs.serialize(bsgs_cache.c_str());
+}
+
 template <typename IO>
 class LVT{
     public:
@@ -110,241 +223,298 @@ class LVT{
     size_t ad;
     // void shuffle(Ciphertext& c, bool* rotation, size_t batch_size, size_t i);
 
-    ELGL_PK global_pk;
+    std::shared_ptr<LVTContext<IO>> ctx;
+    ELGL_PK& global_pk;
     Plaintext rotation;
-    std::vector<ELGL_PK> user_pk;
+    std::vector<ELGL_PK>& user_pk;
     vector<Plaintext> lut_share;
-    vector<vector<BLS12381Element>> cip_lut;
-    emp::BSGSPrecomputation bsgs;
-    std::map<std::string, Fr> P_to_m;
+    // num_party x su, stored compactly; generation writes each row into
+    // the layout chosen here as soon as it is known.
+    std::shared_ptr<const PointTable> cip_lut;
+    PointLayout cip_layout = PointLayout::AFFINE;
+    emp::BSGSPrecomputation& bsgs;
+    SmallDlogIndex& P_to_m;
     BLS12381Element g = BLS12381Element::generator();
     
     int num_party;
     int party;
     vector<int64_t> table;
+    // Elements per pipelined round of lookup_online_batch; 0 sends the whole
+    // batch as one round. Must match across parties.
+    size_t online_chunk = 1 << 14;
+    // Local state of one batch_thdcp round between its send and finish halves.
+    struct ThdcpRound {
+        vector<BLS12381Element> g1;
+        vector<vector<BLS12381Element>> ask_parts;
+    };
+    // keygen = false leaves an unkeyed context for load_full_state to key.
+    LVT(std::shared_ptr<LVTContext<IO>> ctx, Fr& alpha, int se, int da, bool keygen = true);
+    LVT(std::shared_ptr<LVTContext<IO>> ctx, std::string tableFile, Fr& alpha, int se, int da, bool keygen = true);
     LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha, int se, int da);
     LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, std::string tableFile, Fr& alpha, int se, int da);
+    static void initialize(std::string name, LVT<IO>*& lvt_ptr_ref, std::shared_ptr<LVTContext<IO>> ctx, Fr& alpha_fr, int se, int da);
     static void initialize(std::string name, LVT<IO>*& lvt_ptr_ref, int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha_fr, int se, int da);
     static void initialize_batch(std::string name, LVT<IO>*& lvt_ptr_ref, int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha_fr, int se, int da);
     ELGL_PK DistKeyGen(bool offline);
+    void precompute_keys();
     ~LVT();
     void generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table);
+    // Runs the share generation protocol over elgl's channel without touching
+    // the active instance, so it can run alongside lookups on another channel.
+    // With rotation_share set, the party's rotation share is that value mod
+    // su instead of a fresh one (see generate_shares_joint).
+    void generate_instance(LutInstance& inst, ELGL<IO>* elgl, ThreadPool* pool, const Plaintext* rotation_share = nullptr);
+    void use_instance(LutInstance&& inst);
+    // Generates the tables of a lookup_online_multi group: each party draws
+    // one rotation share below the largest su and every table uses it mod
+    // its own su, so all tables rotate by the same amount mod their size.
+    static void generate_shares_joint(const vector<LVT<IO>*>& tables);
     void generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table);
     void generate_shares_fake(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table);
     tuple<Plaintext, vector<Ciphertext>> lookup_online(Plaintext& x_share, vector<Ciphertext>& x_cipher);
     tuple<Plaintext, vector<Ciphertext>> lookup_online_(Plaintext& x_share, Ciphertext& x_cipher, vector<Ciphertext>& x_ciphers);
-    tuple<vector<Plaintext>, vector<vector<Ciphertext>>> lookup_online_batch(vector<Plaintext>& x_share, vector<vector<Ciphertext>>& x_cipher); 
-    vector<BLS12381Element> batch_thdcp(vector<Ciphertext>& c, vector<Plaintext>& u, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m);
-    tuple<vector<Plaintext>, vector<vector<Ciphertext>>> lookup_online_batch(vector<Plaintext>& x_share, vector<Ciphertext>& x_cipher); 
+    tuple<vector<Plaintext>, LutOutput> lookup_online_batch(vector<Plaintext>& x_share, vector<vector<Ciphertext>>& x_cipher); 
+    // Looks the same inputs up in several tables with one masked opening of
+    // x + rotation: this LVT's rotation ciphertexts mask the input and every
+    // table is indexed by the opened value mod its su. The tables must share
+    // the global key, be no larger than this one and come from
+    // generate_shares_joint with it (or all have zero rotation). Results are
+    // in the order of tables.
+    vector<tuple<vector<Plaintext>, LutOutput>> lookup_online_multi(const vector<LVT<IO>*>& tables, vector<Plaintext>& x_share, vector<vector<Ciphertext>>& x_cipher);
+    vector<BLS12381Element> batch_thdcp(vector<Ciphertext>& c, vector<Plaintext>& u);
+    void batch_thdcp_send(vector<Ciphertext>& c, vector<Plaintext>& u, ThdcpRound& rd);
+    vector<BLS12381Element> batch_thdcp_finish(vector<Ciphertext>& c, vector<Plaintext>& u, ThdcpRound& rd);
+    tuple<vector<Plaintext>, LutOutput> lookup_online_batch(vector<Plaintext>& x_share, vector<Ciphertext>& x_cipher); 
     vector<Plaintext> lookup_online_batch_(vector<Plaintext>& x_share);
+    BLS12381Element cip_at(int p, size_t i) const { return cip_lut->at(p, i); }
+    LutOutput lookup_output(vector<uint32_t> idx) const {
+        vector<BLS12381Element> c0(num_party);
+        for (int p = 0; p < num_party; ++p) c0[p] = user_pk[p].get_pk();
+        return LutOutput(cip_lut, std::move(c0), std::move(idx));
+    }
+    void install_cip(PointTable&& table) {
+        cip_lut = std::make_shared<const PointTable>(std::move(table));
+    }
     void save_full_state(const std::string& filename);
-    void load_full_state(const std::string& filename);
+    void load_full_state(const std::string& filename, bool verify_all = false);
     Plaintext Reconstruct(Plaintext input, vector<Ciphertext> input_cips, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, mcl::Vint modulo);
     Plaintext Reconstruct_interact(Plaintext input, Ciphertext input_cip, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, mcl::Vint modulo);
     Plaintext Reconstruct_easy(Plaintext input, ELGL<IO>* elgl, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, mcl::Vint modulo);
 
-    LVT(): num_party(0), party(0), io(nullptr), pool(nullptr), elgl(nullptr), alpha(Fr()), su(0), ad(0) {};
+    LVT(): LVT(std::make_shared<LVTContext<IO>>()) {};
+
+    private:
+    explicit LVT(std::shared_ptr<LVTContext<IO>> ctx)
+        : pool(ctx->pool), elgl(ctx->elgl), io(ctx->io), alpha(Fr()), su(0), ad(0), ctx(ctx),
+          global_pk(ctx->global_pk), user_pk(ctx->user_pk), bsgs(ctx->bsgs), P_to_m(ctx->P_to_m),
+          num_party(ctx->num_party), party(ctx->party) {}
 };
 
 template <typename IO>
 void LVT<IO>::save_full_state(const std::string& filename) {
-    std::ofstream out(filename, std::ios::binary);
-    if (!out) throw std::runtime_error("Failed to open file for writing");
-    
-    size_t total_size = sizeof(int) * 2 +  
-                       sizeof(size_t) * 2 + 
-                       sizeof(Fr) +         
-                       su * sizeof(Fr) + 
-                       sizeof(Fr) +        
-                       sizeof(size_t) +   
-                       table.size() * sizeof(int64_t) + 
-                       num_party * su * sizeof(G1) + 
-                       num_party * 2 * sizeof(G1) +  
-                       sizeof(G1) +        
-                       num_party * sizeof(G1) +
-                       sizeof(Fr) +        
-                       sizeof(G1) * 2;     
-
-    std::vector<char> buffer(total_size);
-    char* ptr = buffer.data();
-    memcpy(ptr, &num_party, sizeof(int)); ptr += sizeof(int);
-    memcpy(ptr, &party, sizeof(int)); ptr += sizeof(int);
-    memcpy(ptr, &su, sizeof(size_t)); ptr += sizeof(size_t);
-    memcpy(ptr, &ad, sizeof(size_t)); ptr += sizeof(size_t);
-
-    const Fr& rot_fr = rotation.get_message();
-    memcpy(ptr, &rot_fr, sizeof(Fr)); ptr += sizeof(Fr);
-    
-    for (size_t i = 0; i < su; i++) {
-        const Fr& fr = lut_share[i].get_message();
-        memcpy(ptr, &fr, sizeof(Fr)); ptr += sizeof(Fr);
-    }
-    
-    const Fr& sk_fr = elgl->kp.get_sk().get_sk();
-    memcpy(ptr, &sk_fr, sizeof(Fr)); ptr += sizeof(Fr);
-    
-    size_t se = table.size();
-    memcpy(ptr, &se, sizeof(size_t)); ptr += sizeof(size_t);
-    memcpy(ptr, table.data(), se * sizeof(int64_t)); ptr += se * sizeof(int64_t);
-    
-    for (int i = 0; i < num_party; ++i) {
-        for (size_t j = 0; j < su; ++j) {
-            const G1& point = cip_lut[i][j].getPoint();
-            memcpy(ptr, &point, sizeof(G1)); ptr += sizeof(G1);
-        }
-    }
-    
-    for (int i = 0; i < num_party; ++i) {
-        const G1& c0 = cr_i[i].get_c0().getPoint();
-        const G1& c1 = cr_i[i].get_c1().getPoint();
-        memcpy(ptr, &c0, sizeof(G1)); ptr += sizeof(G1);
-        memcpy(ptr, &c1, sizeof(G1)); ptr += sizeof(G1);
-    }
-    
-    const G1& global_point = global_pk.get_pk().getPoint();
-    memcpy(ptr, &global_point, sizeof(G1)); ptr += sizeof(G1);
-    
+    size_t n_points = 3 + 3 * num_party;
+    std::vector<uint8_t> sec[LVT_SEC_COUNT];
+    sec[LVT_SEC_SCALARS].resize(3 * LVT_FR_BYTES);
+    lvt_put_fr(sec[LVT_SEC_SCALARS].data(), rotation.get_message());
+    lvt_put_fr(sec[LVT_SEC_SCALARS].data() + LVT_FR_BYTES, elgl->kp.get_sk().get_sk());
+    lvt_put_fr(sec[LVT_SEC_SCALARS].data() + 2 * LVT_FR_BYTES, alpha);
+
+    vector<G1> points = {G_tbs.getPoint(), g.getPoint(), global_pk.get_pk().getPoint()};
+    for (int i = 0; i < num_party; ++i) points.push_back(user_pk[i].get_pk().getPoint());
     for (int i = 0; i < num_party; ++i) {
-        const G1& user_point = user_pk[i].get_pk().getPoint();
-        memcpy(ptr, &user_point, sizeof(G1)); ptr += sizeof(G1);
-    }
-
-    memcpy(ptr, &alpha, sizeof(Fr)); ptr += sizeof(Fr);
-
-    const G1& g_tbs_point = G_tbs.getPoint();
-    memcpy(ptr, &g_tbs_point, sizeof(G1)); ptr += sizeof(G1);
+        points.push_back(cr_i[i].get_c0().getPoint());
+        points.push_back(cr_i[i].get_c1().getPoint());
+    }
+    sec[LVT_SEC_POINTS].resize(n_points * LVT_POINT_BYTES);
+    for (size_t i = 0; i < n_points; ++i)
+        lvt_put_point(sec[LVT_SEC_POINTS].data() + i * LVT_POINT_BYTES, points[i]);
+
+    sec[LVT_SEC_TABLE].resize(table.size() * sizeof(int64_t));
+    memcpy(sec[LVT_SEC_TABLE].data(), table.data(), sec[LVT_SEC_TABLE].size());
+
+    sec[LVT_SEC_LUT_SHARE].resize(su * LVT_FR_BYTES);
+    emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++)
+            lvt_put_fr(sec[LVT_SEC_LUT_SHARE].data() + i * LVT_FR_BYTES, lut_share[i].get_message());
+    });
+
+    sec[LVT_SEC_CIP_LUT].resize(num_party * su * LVT_POINT_BYTES);
+    for (int p = 0; p < num_party; ++p) {
+        cip_lut->encode_row(p, sec[LVT_SEC_CIP_LUT].data() + p * su * LVT_POINT_BYTES, pool);
+    }
+
+    LvtStateHeader h = {};
+    memcpy(h.magic, LVT_STATE_MAGIC, sizeof(h.magic));
+    h.version = LVT_STATE_VERSION;
+    h.header_size = LVT_STATE_HEADER_SIZE;
+    h.num_party = num_party;
+    h.party = party;
+    h.su = su;
+    h.ad = ad;
+    h.table_size = table.size();
+    lvt_put_point(h.global_pk, global_pk.get_pk().getPoint());
+    uint64_t offset = LVT_STATE_HEADER_SIZE;
+    for (int s = 0; s < LVT_SEC_COUNT; ++s) {
+        uint64_t align = s == LVT_SEC_CIP_LUT ? 4096 : 64;
+        offset = (offset + align - 1) / align * align;
+        h.sections[s] = {offset, sec[s].size(), lvt_state_checksum(sec[s].data(), sec[s].size())};
+        offset += sec[s].size();
+    }
+    h.header_checksum = lvt_state_checksum(&h, sizeof(h));
 
-    const G1& g_point = g.getPoint();
-    memcpy(ptr, &g_point, sizeof(G1));
-    
-    out.write(buffer.data(), total_size);
-    out.close();
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) throw std::runtime_error("Failed to open file for writing");
+    char raw[LVT_STATE_HEADER_SIZE] = {0};
+    memcpy(raw, &h, sizeof(h));
+    out.write(raw, LVT_STATE_HEADER_SIZE);
+    uint64_t pos = LVT_STATE_HEADER_SIZE;
+    const char zeros[4096] = {0};
+    for (int s = 0; s < LVT_SEC_COUNT; ++s) {
+        out.write(zeros, h.sections[s].offset - pos);
+        out.write(reinterpret_cast<const char*>(sec[s].data()), sec[s].size());
+        pos = h.sections[s].offset + sec[s].size();
+    }
+    if (!out) throw std::runtime_error("save_full_state: write failed");
 }
 
+// Maps the file and decodes everything except cip_lut, whose rows stay in
+// the mapping and are decoded per entry by cip_at(). The cip_lut checksum
+// covers the whole section, so it is only checked when verify_all is set.
+// A keyed context only accepts states made under its global_pk; an unkeyed
+// one adopts the file's keys. Nothing is changed unless the whole load
+// succeeds.
 template <typename IO>
-void LVT<IO>::load_full_state(const std::string& filename) {
-    std::ifstream in(filename, std::ios::binary);
-    if (!in) throw std::runtime_error("Failed to open file for reading");
-    
-    in.seekg(0, std::ios::end);
-    size_t file_size = in.tellg();
-    in.seekg(0, std::ios::beg);
-    
-    std::vector<char> buffer(file_size);
-    in.read(buffer.data(), file_size);
-    const char* ptr = buffer.data();
-    
-    memcpy(&num_party, ptr, sizeof(int)); ptr += sizeof(int);
-    memcpy(&party, ptr, sizeof(int)); ptr += sizeof(int);
-    memcpy(&su, ptr, sizeof(size_t)); ptr += sizeof(size_t);
-    memcpy(&ad, ptr, sizeof(size_t)); ptr += sizeof(size_t);
-    
-    Fr rot_fr;
-    memcpy(&rot_fr, ptr, sizeof(Fr)); ptr += sizeof(Fr);
-    rotation.set_message(rot_fr);
-    
-    lut_share.resize(su);
-    for (size_t i = 0; i < su; i++) {
-        Fr fr;
-        memcpy(&fr, ptr, sizeof(Fr)); ptr += sizeof(Fr);
-        lut_share[i].set_message(fr);
-    }
-    
-    Fr sk_fr;
-    memcpy(&sk_fr, ptr, sizeof(Fr)); ptr += sizeof(Fr);
-    ELGL_SK key;
-    key.sk = sk_fr;
-    elgl->kp.sk = key;
-    
-    size_t se;
-    memcpy(&se, ptr, sizeof(size_t)); ptr += sizeof(size_t);
-    table.resize(se);
-    memcpy(table.data(), ptr, se * sizeof(int64_t)); ptr += se * sizeof(int64_t);
-
-    cip_lut.resize(num_party);
-    for (int i = 0; i < num_party; ++i) {
-        cip_lut[i].resize(su);
-        for (size_t j = 0; j < su; ++j) {
-            G1 point;
-            memcpy(&point, ptr, sizeof(G1)); ptr += sizeof(G1);
-            BLS12381Element elem;
-            elem.point = point;
-            cip_lut[i][j] = elem;
+void LVT<IO>::load_full_state(const std::string& filename, bool verify_all) {
+    size_t len = 0;
+    void* base = map_table_file(filename.c_str(), LVT_STATE_HEADER_SIZE, len);
+    const uint8_t* file = static_cast<const uint8_t*>(base);
+    LvtStateHeader h;
+    Fr rot, sk, alpha_;
+    vector<BLS12381Element> pts;
+    vector<int64_t> table_;
+    vector<Plaintext> shares_;
+    try {
+        memcpy(&h, file, sizeof(h));
+        uint64_t header_checksum = h.header_checksum;
+        h.header_checksum = 0;
+        if (memcmp(h.magic, LVT_STATE_MAGIC, sizeof(h.magic)) != 0 || h.version != LVT_STATE_VERSION
+            || h.header_size != LVT_STATE_HEADER_SIZE || lvt_state_checksum(&h, sizeof(h)) != header_checksum)
+            throw std::runtime_error("load_full_state: incompatible state file");
+        if ((int)h.num_party != num_party || (int)h.party != party)
+            throw std::runtime_error("load_full_state: state file belongs to another party");
+        BLS12381Element file_pk = lvt_get_point(h.global_pk);
+        if (ctx->keyed && file_pk != global_pk.get_pk())
+            throw std::runtime_error("load_full_state: state file was made under another key");
+        uint64_t expected[LVT_SEC_COUNT] = {3 * LVT_FR_BYTES, (3 + 3 * h.num_party) * LVT_POINT_BYTES,
+                                            h.table_size * sizeof(int64_t), h.su * LVT_FR_BYTES,
+                                            h.num_party * h.su * LVT_POINT_BYTES};
+        for (int s = 0; s < LVT_SEC_COUNT; ++s) {
+            const LvtStateSectionEntry& e = h.sections[s];
+            if (e.size != expected[s] || e.offset > len || e.size > len - e.offset)
+                throw std::runtime_error("load_full_state: truncated state file");
+            if ((s != LVT_SEC_CIP_LUT || verify_all) && lvt_state_checksum(file + e.offset, e.size) != e.checksum)
+                throw std::runtime_error("load_full_state: checksum mismatch");
         }
-    }
-    
-    cr_i.resize(num_party);
-    for (int i = 0; i < num_party; ++i) {
-        G1 c0, c1;
-        memcpy(&c0, ptr, sizeof(G1)); ptr += sizeof(G1);
-        memcpy(&c1, ptr, sizeof(G1)); ptr += sizeof(G1);
-        
-        BLS12381Element e0, e1;
-        e0.point = c0;
-        e1.point = c1;
-        cr_i[i] = Ciphertext(e0, e1);
-    }
-    
-    G1 global_point;
-    memcpy(&global_point, ptr, sizeof(G1)); ptr += sizeof(G1);
-    BLS12381Element global_elem;
-    global_elem.point = global_point;
-    global_pk.assign_pk(global_elem);
-    
-    user_pk.resize(num_party);
-    for (int i = 0; i < num_party; ++i) {
-        G1 user_point;
-        memcpy(&user_point, ptr, sizeof(G1)); ptr += sizeof(G1);
-        BLS12381Element user_elem;
-        user_elem.point = user_point;
-        user_pk[i].assign_pk(user_elem);
-    }
-
-    memcpy(&alpha, ptr, sizeof(Fr)); ptr += sizeof(Fr);
 
-    G1 g_tbs_point;
-    memcpy(&g_tbs_point, ptr, sizeof(G1)); ptr += sizeof(G1);
-    G_tbs.point = g_tbs_point;
-    G1 g_point;
-    memcpy(&g_point, ptr, sizeof(G1));
-    g.point = g_point;
-
-    in.close();
+        const uint8_t* scalars = file + h.sections[LVT_SEC_SCALARS].offset;
+        rot = lvt_get_fr(scalars);
+        sk = lvt_get_fr(scalars + LVT_FR_BYTES);
+        alpha_ = lvt_get_fr(scalars + 2 * LVT_FR_BYTES);
+
+        const uint8_t* points = file + h.sections[LVT_SEC_POINTS].offset;
+        pts.resize(3 + 3 * num_party);
+        for (size_t i = 0; i < pts.size(); ++i) pts[i] = lvt_get_point(points + i * LVT_POINT_BYTES);
+        if (pts[2] != file_pk)
+            throw std::runtime_error("load_full_state: incompatible state file");
+
+        table_.resize(h.table_size);
+        memcpy(table_.data(), file + h.sections[LVT_SEC_TABLE].offset, h.table_size * sizeof(int64_t));
+
+        const uint8_t* shares = file + h.sections[LVT_SEC_LUT_SHARE].offset;
+        shares_.resize(h.su);
+        emp::parallel_for(pool, 0, h.su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++)
+                shares_[i].set_message(lvt_get_fr(shares + i * LVT_FR_BYTES));
+        });
+    } catch (...) {
+        munmap(base, len);
+        throw;
+    }
+
+    su = h.su;
+    ad = h.ad;
+    rotation.set_message(rot);
+    alpha = alpha_;
+    G_tbs = pts[0];
+    g = pts[1];
+    cr_i.resize(num_party);
+    for (int i = 0; i < num_party; ++i)
+        cr_i[i] = Ciphertext(pts[3 + num_party + 2 * i], pts[4 + num_party + 2 * i]);
+    table = std::move(table_);
+    lut_share = std::move(shares_);
+    if (!ctx->keyed) {
+        ELGL_SK key;
+        key.sk = sk;
+        elgl->kp.sk = key;
+        global_pk.assign_pk(pts[2]);
+        user_pk.resize(num_party);
+        for (int i = 0; i < num_party; ++i) user_pk[i].assign_pk(pts[3 + i]);
+        ctx->keyed = true;
+    }
+    auto mapped = std::make_shared<PointTable>();
+    mapped->attach(std::make_shared<MappedPointTable>(base, len, file + h.sections[LVT_SEC_CIP_LUT].offset, num_party, su));
+    cip_lut = std::move(mapped);
+    precompute_keys();
 }
 
 template <typename IO>
-LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha, int se, int da){
-    this->io = io;
-    this->party = party;
-    this->num_party = num_party;
+LVT<IO>::LVT(std::shared_ptr<LVTContext<IO>> ctx, Fr& alpha, int se, int da, bool keygen) : LVT(ctx) {
     this->alpha = alpha;
-    this->pool = pool;
-    this->elgl = elgl;
-    this->user_pk.resize(num_party);
-    this->user_pk[party-1] = elgl->kp.get_pk();
     this->su = 1ULL << se;
     this->ad = 1ULL << da;
-    this->cip_lut.resize(num_party);
     this->cr_i.resize(num_party);
     this->lut_share.resize(su);
     this->G_tbs = BLS12381Element(su);
     BLS12381Element::init();
-    BLS12381Element g = BLS12381Element::generator();
-    this->global_pk = DistKeyGen(1);
+    if (keygen && !ctx->keyed) DistKeyGen(1);
 }
 
+template <typename IO>
+LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha, int se, int da)
+    : LVT(std::make_shared<LVTContext<IO>>(num_party, party, io, pool, elgl), alpha, se, da) {}
+
+template <typename IO>
+LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, string func_name, Fr& alpha, int se, int da)
+    : LVT(std::make_shared<LVTContext<IO>>(num_party, party, io, pool, elgl), func_name, alpha, se, da) {}
+
 template <typename IO>
 void LVT<IO>::initialize(std::string func_name, LVT<IO>*& lvt_ptr_ref, int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha_fr, int se, int da) {
-    std::string full_state_path = "../cache/lvt_" + func_name + "_size" + std::to_string(se) + "-P" + std::to_string(party) + ".bin";
+    initialize(func_name, lvt_ptr_ref, std::make_shared<LVTContext<IO>>(num_party, party, io, pool, elgl), alpha_fr, se, da);
+}
+
+template <typename IO>
+void LVT<IO>::initialize(std::string func_name, LVT<IO>*& lvt_ptr_ref, std::shared_ptr<LVTContext<IO>> ctx, Fr& alpha_fr, int se, int da) {
+    std::string full_state_path = "../cache/lvt_" + func_name + "_size" + std::to_string(se) + "-P" + std::to_string(ctx->party) + ".bin";
     fs::create_directories("../cache");
-    lvt_ptr_ref = new LVT<IO>(num_party, party, io, pool, elgl, func_name, alpha_fr, se, da);
-    if (fs::exists(full_state_path)) {
+    // Key generation waits until the cache has had its chance: a loaded
+    // state brings its own keys.
+    bool cached = fs::exists(full_state_path);
+    lvt_ptr_ref = new LVT<IO>(ctx, func_name, alpha_fr, se, da, false);
+    bool loaded = false;
+    if (cached) {
         auto start = clock_start();
-        lvt_ptr_ref->load_full_state(full_state_path);
-        std::cout << "Loading cached state time: " << std::fixed << std::setprecision(6) << time_from(start) / 1e6 << " seconds" << std::endl;
-    } else {
+        try {
+            lvt_ptr_ref->load_full_state(full_state_path);
+            loaded = true;
+            std::cout << "Loading cached state time: " << std::fixed << std::setprecision(6) << time_from(start) / 1e6 << " seconds" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring cached state " << full_state_path << ": " << e.what() << std::endl;
+        }
+    }
+    if (!loaded) {
         auto start = clock_start();
         cout << "Generating new state..." << endl;
+        if (!ctx->keyed) lvt_ptr_ref->DistKeyGen(1);
         lvt_ptr_ref->generate_shares(lvt_ptr_ref->lut_share, lvt_ptr_ref->rotation, lvt_ptr_ref->table);
         cout << "Generate shares finished" << endl;
         lvt_ptr_ref->save_full_state(full_state_path);
@@ -372,13 +542,12 @@ void LVT<IO>::initialize_batch(std::string func_name, LVT<IO>*& lvt_ptr_ref, int
 }
 
 template <typename IO>
-LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, string func_name, Fr& alpha, int se, int da)
-    : LVT(num_party, party, io, pool, elgl, alpha, se, da) {
+LVT<IO>::LVT(std::shared_ptr<LVTContext<IO>> ctx, string func_name, Fr& alpha, int se, int da, bool keygen)
+    : LVT(ctx, alpha, se, da, keygen) {
     fs::create_directories("../cache");
     std::string tableFile = "../bin/table_" + func_name + ".txt";
     std::string table_cache = "../cache/table_" + func_name + "_" + std::to_string(se) + ".bin";
     std::string p_to_m_cache = "../cache/p_to_m_" + std::to_string(da) + ".bin";
-    std::string bsgs_cache = "../cache/bsgs_40.bin";
     if (fs::exists(table_cache)) {
         std::ifstream in(table_cache, std::ios::binary);
         if (!in) throw std::runtime_error("Failed to open table cache");
@@ -398,61 +567,52 @@ LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, EL
         out.write(reinterpret_cast<const char*>(table.data()), size * sizeof(int64_t));
         out.close();
     }
-    if (2 * su * num_party <= 65536) {
-        build_safe_P_to_m(P_to_m, 2 * su * num_party);
-        return;
-    }
-    // if (da <= 16) {
-        if (fs::exists(p_to_m_cache)) {
-            std::ifstream in(p_to_m_cache, std::ios::binary);
-            if (!in) throw std::runtime_error("Failed to open P_to_m cache");
-            size_t size;
-            in.read(reinterpret_cast<char*>(&size), sizeof(size_t));
-            P_to_m.clear();
-            for (size_t i = 0; i < size; ++i) {
-                size_t key_len;
-                in.read(reinterpret_cast<char*>(&key_len), sizeof(size_t));
-                std::string key(key_len, '\0');
-                in.read(&key[0], key_len);
-                
-                Fr value;
-                in.read(reinterpret_cast<char*>(&value), sizeof(Fr));
-                P_to_m[key] = value;
-            }
-            in.close();
-        } else {
-            build_safe_P_to_m(P_to_m, 2 * su * num_party);
-            std::ofstream out(p_to_m_cache, std::ios::binary);
-            if (!out) throw std::runtime_error("Failed to create P_to_m cache");
-            
-            size_t size = P_to_m.size();
-            out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-            
-            for (const auto& pair : P_to_m) {
-                size_t key_len = pair.first.length();
-                out.write(reinterpret_cast<const char*>(&key_len), sizeof(size_t));
-                out.write(pair.first.c_str(), key_len);
-                out.write(reinterpret_cast<const char*>(&pair.second), sizeof(Fr));
-            }
-            out.close();
-        }
-    // }
-    uint64_t N = 1ULL << 32;
-    if (fs::exists(bsgs_cache)) {
-        try {
-            bsgs.deserialize(bsgs_cache.c_str());
-        } catch (const std::exception& e) {
-            bsgs.precompute(BLS12381Element::generator(), N);
-            bsgs.serialize(bsgs_cache.c_str());
-        }
-    } else {
-        bsgs.precompute(BLS12381Element::generator(), N);
-        bsgs.serialize(bsgs_cache.c_str());
-    }
+    ctx->require_P_to_m(2 * su * num_party, p_to_m_cache);
+    if (2 * su * num_party > 65536) ctx->require_bsgs();
 }
 
 template <typename IO>
 void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table) {
+    LutInstance inst;
+    generate_instance(inst, this->elgl, this->pool);
+    lut_share = std::move(inst.lut_share);
+    rotation = inst.rotation;
+    install_cip(std::move(inst.cip_lut));
+    cr_i = std::move(inst.cr_i);
+}
+
+template <typename IO>
+void LVT<IO>::generate_shares_joint(const vector<LVT<IO>*>& tables) {
+    if (tables.empty()) return;
+    uint64_t max_su = 0;
+    for (auto* t : tables) max_su = std::max<uint64_t>(max_su, t->su);
+    mcl::Vint bound(max_su);
+    Plaintext r;
+    r.set_random(bound);
+    for (auto* t : tables) {
+        LutInstance inst;
+        t->generate_instance(inst, t->elgl, t->pool, &r);
+        t->use_instance(std::move(inst));
+    }
+}
+
+template <typename IO>
+void LVT<IO>::use_instance(LutInstance&& inst) {
+    rotation = inst.rotation;
+    lut_share = std::move(inst.lut_share);
+    install_cip(std::move(inst.cip_lut));
+    cr_i = std::move(inst.cr_i);
+}
+
+template <typename IO>
+void LVT<IO>::generate_instance(LutInstance& inst, ELGL<IO>* elgl, ThreadPool* pool, const Plaintext* rotation_share) {
+    vector<Plaintext>& lut_share = inst.lut_share;
+    Plaintext& rotation = inst.rotation;
+    PointTable& cip_lut = inst.cip_lut;
+    vector<Ciphertext>& cr_i = inst.cr_i;
+    lut_share.resize(su);
+    cip_lut.reset(num_party, su, cip_layout);
+    cr_i.resize(num_party);
     vector<std::future<void>> res;
     vector<BLS12381Element> c0(su);
     vector<BLS12381Element> c1(su);
@@ -465,56 +625,49 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
     RangeProof Range_proof(global_pk, bound, su);
     RangeVerifier Range_verifier(Range_proof);
     RangeProver Range_prover(Range_proof);
-    ELGL_SK sbsk, twosk; rotation.set_random(bound);
+    ELGL_SK sbsk, twosk;
+    if (rotation_share)
+        rotation.assign_uint64(rotation_share->mod_uint64(su));
+    else
+        rotation.set_random(bound);
     Ciphertext my_rot_cipher = global_pk.encrypt(rotation);
     elgl->serialize_sendall(my_rot_cipher);
     for (int i = 1; i <= num_party; ++i) {
-        res.emplace_back(pool->enqueue([this, &my_rot_cipher, i]() {
+        res.emplace_back(pool->enqueue([&, i]() {
             if (i == party){
-                this->cr_i[party-1] = my_rot_cipher;
+                cr_i[party-1] = my_rot_cipher;
             }else{
                 Ciphertext other_rot_cipher;
                 elgl->deserialize_recv(other_rot_cipher, i);
-                this->cr_i[i-1] = other_rot_cipher;
+                cr_i[i-1] = other_rot_cipher;
             }
         }));
     }
     for (auto & f : res) f.get();
     res.clear();
-    auto write_block = [&](std::stringstream &ss, const std::string &s) {
-        uint32_t len = s.size();
-        ss.write((char*)&len, sizeof(len));
-        ss.write(s.data(), len);
-    };
-    auto read_block = [&](std::stringstream &ss, std::string &s) {
-        uint32_t len;
-        ss.read((char*)&len, sizeof(len));
-        s.resize(len);
-        ss.read(&s[0], len);
-    };
     if (party == ALICE) {
         std::stringstream comm, response, encMap;
         elgl->DecProof(global_pk, comm, response, encMap, this->table, su, c0, c1, pool);
-        std::string comm_b64 = base64_encode(comm.str());
-        std::string response_b64 = base64_encode(response.str());
-        std::string encMap_b64 = base64_encode(encMap.str());
+        std::string comm_str = comm.str();
+        std::string response_str = response.str();
+        std::string encMap_str = encMap.str();
         std::stringstream packet;
-        write_block(packet, response_b64);
-        write_block(packet, comm_b64);
-        write_block(packet, encMap_b64);
+        write_frame(packet, response_str);
+        write_frame(packet, comm_str);
+        write_frame(packet, encMap_str);
         elgl->serialize_sendall_(packet);  
     }
     else {
         std::stringstream packet;
         elgl->deserialize_recv_(packet, ALICE); 
-        std::string response_b64, comm_b64, encMap_b64;
-        read_block(packet, response_b64);
-        read_block(packet, comm_b64);
-        read_block(packet, encMap_b64);
+        std::string response_str, comm_str, encMap_str;
+        read_frame(packet, response_str);
+        read_frame(packet, comm_str);
+        read_frame(packet, encMap_str);
         std::stringstream response_dec, comm_dec, encMap_dec;
-        response_dec << base64_decode(response_b64);
-        comm_dec << base64_decode(comm_b64);
-        encMap_dec << base64_decode(encMap_b64);
+        response_dec << response_str;
+        comm_dec << comm_str;
+        encMap_dec << encMap_str;
         elgl->DecVerify(global_pk, comm_dec, response_dec, encMap_dec, c0, c1, su, pool);
     }
     vector<BLS12381Element> ak;
@@ -526,18 +679,8 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
     dk.resize(su);
     ek.resize(su);
     mcl::Unit N(su);
-    res.push_back(pool->enqueue(
-        [this, &c0, &ak, N](){
-            FFT_Para(c0, ak, this->alpha, N);     
-        }
-    ));
-    res.push_back(pool->enqueue(
-        [this, &c1, &bk, N](){
-            FFT_Para(c1, bk, this->alpha, N);
-        }
-    ));
-    for (auto& f : res) f.get();
-    res.clear();
+    FFT_Para(c0, ak, this->alpha, N, pool);
+    FFT_Para(c1, bk, this->alpha, N, pool);
     if (party == ALICE)
     {
         Plaintext beta;
@@ -547,28 +690,24 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         sk[0].set_random();
         std::fill(sk.begin(), sk.begin() + su, sk[0]);
         BLS12381Element dkk = BLS12381Element(1) * sk[0].get_message();
-        BLS12381Element ekk = global_pk.get_pk() * sk[0].get_message();
-        for (size_t i = 0; i < su; i++){
-            res.push_back(pool->enqueue(
-                [this, i, &dk, &ek, &sk, &ak, &bk, &beta, &dkk, &ekk](){
-                    Plaintext betak_;
-                    Plaintext i_;
-                    i_.assign(to_string(i));
-                    Plaintext::pow(betak_, beta, i_);
-                    dk[i] = dkk + ak[i] * betak_.get_message();
-                    ek[i] = ekk + bk[i] * betak_.get_message();
-                }
-            ));
-        }
-        for (auto& f : res) f.get();
-        res.clear();
+        BLS12381Element ekk = global_pk.pk_mul(sk[0].get_message());
+        emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++) {
+                Plaintext betak_;
+                Plaintext i_;
+                i_.assign_uint64(i);
+                Plaintext::pow(betak_, beta, i_);
+                dk[i] = dkk + ak[i] * betak_.get_message();
+                ek[i] = ekk + bk[i] * betak_.get_message();
+            }
+        });
         std::stringstream commit_ro, response_ro;
         Rot_prover.NIZKPoK(rot_proof, commit_ro, response_ro, global_pk, global_pk, dk, ek, ak, bk, beta, sk, pool);
         std::stringstream comm_ro_, response_ro_;        
         std::string comm_raw = commit_ro.str();
-        comm_ro_ << base64_encode(comm_raw);
+        comm_ro_ << comm_raw;
         std::string response_raw = response_ro.str();
-        response_ro_ << base64_encode(response_raw);
+        response_ro_ << response_raw;
         elgl->serialize_sendall_(comm_ro_);
         elgl->serialize_sendall_(response_ro_);
     }
@@ -578,7 +717,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         if (i == party) {
             continue;
         }else{
-            res.push_back(pool->enqueue([this, i, index, &c0, &c1, &dk, &ek, &Rot_prover,&rot_proof, &Rot_verifier, &rotation]()
+            res.push_back(pool->enqueue([&, i, index]()
             {
                 vector<BLS12381Element> ak_thread(su);
                 vector<BLS12381Element> bk_thread(su);
@@ -591,37 +730,36 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                 elgl->deserialize_recv_(response_ro, i);
                 comm_raw = comm_ro.str();
                 response_raw = response_ro.str();
-                comm_ << base64_decode(comm_raw);
-                response_ << base64_decode(response_raw);
-                Rot_verifier.NIZKPoK(dk_thread, ek_thread, ak_thread, bk_thread, comm_, response_, this->global_pk, this->global_pk, pool);
+                comm_ << comm_raw;
+                response_ << response_raw;
+                // The verifier keeps the challenge in its proof, so each
+                // concurrent peer check gets its own.
+                RotationProof peer_proof(global_pk, global_pk, su);
+                RotationVerifier peer_verifier(peer_proof);
+                peer_verifier.NIZKPoK(dk_thread, ek_thread, ak_thread, bk_thread, comm_, response_, this->global_pk, this->global_pk, pool);
                 if (i == this->party - 1) {
                     vector<BLS12381Element> dk_(su);
                     vector<BLS12381Element> ek_(su);
                     Plaintext beta;
                     Plaintext::pow(beta, alpha, rotation);
                     vector<Plaintext> sk(su);
-                    vector<std::future<void>> res_;
                     sk[0].set_random();
                     std::fill(sk.begin(), sk.begin() + su, sk[0]);
                     BLS12381Element dkk = BLS12381Element(1) * sk[0].get_message();
-                    BLS12381Element ekk = global_pk.get_pk() * sk[0].get_message();
-                    for (size_t i = 0; i < su; i++){
-                        res_.push_back(pool->enqueue(
-                            [this, i, &dk_, &ek_, &sk, &ak_thread, &bk_thread, &dk_thread, &ek_thread, &beta, &dkk, &ekk]()
-                            {
-                                Plaintext betak;
-                                Plaintext i_;
-                                i_.assign(to_string(i));
-                                Plaintext::pow(betak, beta, i_);
-                                dk_[i] = dkk + dk_thread[i] * betak.get_message();
-                                ek_[i] = ekk + ek_thread[i] * betak.get_message();
-                            }
-                        ));
-                    }
-                    for (auto & f : res_) {
-                        f.get();
-                    }
-                    res_.clear();
+                    BLS12381Element ekk = global_pk.pk_mul(sk[0].get_message());
+                    // The other peers' tasks may be holding every pool thread
+                    // while they wait to receive, so this task must not block
+                    // on work it queues; parallel_for runs it here if need be.
+                    emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+                        for (size_t k = l; k < r; ++k) {
+                            Plaintext betak;
+                            Plaintext k_;
+                            k_.assign_uint64(k);
+                            Plaintext::pow(betak, beta, k_);
+                            dk_[k] = dkk + dk_thread[k] * betak.get_message();
+                            ek_[k] = ekk + ek_thread[k] * betak.get_message();
+                        }
+                    });
                     std::stringstream commit_ro, response_ro;
                     Rot_prover.NIZKPoK(rot_proof, commit_ro, response_ro, 
                     global_pk, global_pk, dk_, ek_, dk_thread, ek_thread, beta, sk, pool);
@@ -629,8 +767,8 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                     std::string comm_raw_final, response_raw_final;
                     comm_raw_final = commit_ro.str();
                     response_raw_final = response_ro.str();
-                    comm_ro_final << base64_encode(comm_raw_final);
-                    response_ro_final << base64_encode(response_raw_final);
+                    comm_ro_final << comm_raw_final;
+                    response_ro_final << response_raw_final;
                     elgl->serialize_sendall_(comm_ro_final);
                     elgl->serialize_sendall_(response_ro_final);
                     if (this->num_party == this->party){
@@ -652,8 +790,8 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         elgl->deserialize_recv_(response_ro, num_party);
         comm_raw = comm_ro.str();
         response_raw = response_ro.str();
-        comm_ << base64_decode(comm_raw);
-        response_ << base64_decode(response_raw);
+        comm_ << comm_raw;
+        response_ << response_raw;
         Rot_verifier.NIZKPoK(dk, ek, ak, bk, comm_, 
         response_, global_pk, global_pk, pool);
     }
@@ -663,32 +801,14 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
     alpha_inv.assign(alpha_inv_.getMpz());
     Fr N_inv;
     Fr::inv(N_inv, N);
-    res.push_back(pool->enqueue(
-        [this, &dk, &c0_, &N, &alpha_inv]()
-        {
-            FFT_Para(dk, c0_, alpha_inv.get_message(), N);
-        }
-    ));
-    res.push_back(pool->enqueue(
-        [this, &ek, &c1_, &N, &alpha_inv]()
-        {
-            FFT_Para(ek, c1_, alpha_inv.get_message(), N);
-        }
-    ));
-    for (auto& f : res) {
-        f.get();
-    }
-    res.clear();
-    for (size_t i = 0; i < su; i++) {
-        res.push_back(pool->enqueue([&c0_, &c1_, &N_inv, i]() {
+    FFT_Para(dk, c0_, alpha_inv.get_message(), N, pool);
+    FFT_Para(ek, c1_, alpha_inv.get_message(), N, pool);
+    emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
             c0_[i] *= N_inv;
             c1_[i] *= N_inv;
-        }));
-    }
-    for (auto& f : res) {
-        f.get();
-    }
-    res.clear();
+        }
+    });
 
     if (party == ALICE) {
         vector<Plaintext> y_alice;
@@ -712,108 +832,77 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             elgl->deserialize_recv_(response_ro, i);
             comm_raw = commit_ro.str();
             response_raw = response_ro.str();
-            comm_ << base64_decode(comm_raw);
-            response_ << base64_decode(response_raw);
+            comm_ << comm_raw;
+            response_ << response_raw;
             BLS12381Element pk__ = user_pk[i-1].get_pk();
             Range_verifier.NIZKPoK(pk__, y3, y2, comm_, response_, c0_, global_pk, pool);
-            vector<std::future<void>> res_;
-            for (size_t j = 0; j < su; j++) {
-                res_.push_back(pool->enqueue([&l_alice, &y2, j]() {
+            emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+                for (size_t j = l; j < r; j++)
                     l_alice[j] -= y2[j];
-                }));
-            }
-            for (auto& f : res_) {
-                f.get();
-            }
-            cip_lut[i-1] = y3;
+            });
+            cip_lut.set_row(i-1, y3, pool);
         }
 
-        for (size_t i = 0; i < su; i++){
-            res.push_back(pool->enqueue([&c1_, &l_alice, i]() {
+        emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++)
                 l_alice[i] += c1_[i];
-            }));
-        }
-        for (auto& f : res) {
-            f.get();
-        }
-        res.clear();
-        cip_lut[0].resize(su);
+        });
+        vector<BLS12381Element> cip0(su);
         bool flag = 0; 
         if(ad * num_party <= 65536) flag = 1;
         if(flag){
-            BLS12381Element pk_tmp = this->global_pk.get_pk() * this->elgl->kp.get_sk().get_sk();
-            for (size_t i = 0; i < su; i++){
-                res.push_back(pool->enqueue([this, &l_alice, &c0_, &lut_share, &L, i, &pk_tmp]() {
-                    BLS12381Element Y = l_alice[i] - c0_[i] * elgl->kp.get_sk().get_sk(); Fr y; 
-                    auto it = this->P_to_m.find(Y.getPoint().getStr());
-                    if (it == this->P_to_m.end()) {
+            BLS12381Element pk_tmp = this->global_pk.pk_mul(elgl->kp.get_sk().get_sk());
+            emp::parallel_for(pool, 0, su, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) {
+                    BLS12381Element Y = l_alice[i] - c0_[i] * elgl->kp.get_sk().get_sk();
+                    int64_t m = this->P_to_m.find(Y);
+                    if (m < 0) {
                         std::cerr << "[Error] y not found in P_to_m! y = " << Y.getPoint().getStr() << std::endl;
                         exit(1);
-                    } else {
-                        y = it->second;
                     }
-                    mcl::Vint r_;
-                    mcl::Vint y_;
-                    y_ = y.getMpz();
-                    mcl::Vint ms;  
-                    ms.setStr(to_string(this->ad));
-                    mcl::gmp::mod(r_, y_, ms);
-                    Fr r;
-                    r.setMpz(r_);
+                    Fr r(m % (int64_t)this->ad);
                     lut_share[i].set_message(r);
                     BLS12381Element l(r);
-                    l += c0_[i] * this->elgl->kp.get_sk().get_sk();
+                    l += c0_[i] * elgl->kp.get_sk().get_sk();
                     L[i] = BLS12381Element(l);
-                    this->cip_lut[0][i] = BLS12381Element(r) + pk_tmp;
-                }));
-            }
-            for (auto& f : res) f.get();
-            res.clear();
+                    cip0[i] = BLS12381Element(r) + pk_tmp;
+                }
+            });
         } else {
             vector<BLS12381Element> Ys(su);
-            for (size_t i = 0; i < su; i++){
-                res.push_back(pool->enqueue([this, &l_alice, &c0_, &lut_share, &L, i, &Ys]() {
-                    Ys[i] = l_alice[i] - c0_[i] * elgl->kp.get_sk().get_sk(); 
-                }));
-            }
-            for (auto& f : res) f.get();
-            res.clear();
-            vector<int64_t> ys = this->bsgs.solve_parallel_with_pool_vector(Ys, this->pool, thread_num);
-            BLS12381Element pk_tmp = this->global_pk.get_pk() * this->elgl->kp.get_sk().get_sk();
-            for (size_t i = 0; i < su; i++){
-                res.push_back(pool->enqueue([this, &l_alice, &c0_, &lut_share, &L, i, &ys, &pk_tmp]() {
-                    mcl::Vint r_;
-                    int64_t y_i = ys[i];
-                    mpz_class y_; y_.setStr(std::to_string(y_i));
-                    mcl::Vint ms;  
-                    ms.setStr(to_string(this->ad));
-                    mcl::gmp::mod(r_, y_, ms);
-                    Fr r;
-                    r.setMpz(r_);
+            emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+                for (size_t i = l; i < r; i++)
+                    Ys[i] = l_alice[i] - c0_[i] * elgl->kp.get_sk().get_sk();
+            });
+            vector<int64_t> ys = this->bsgs.solve_batch(Ys, pool, pool->size());
+            BLS12381Element pk_tmp = this->global_pk.pk_mul(elgl->kp.get_sk().get_sk());
+            emp::parallel_for(pool, 0, su, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) {
+                    Fr r(ys[i] % (int64_t)this->ad);
                     lut_share[i].set_message(r);
                     BLS12381Element l(r);
-                    l += c0_[i] * this->elgl->kp.get_sk().get_sk();
+                    l += c0_[i] * elgl->kp.get_sk().get_sk();
                     L[i] = BLS12381Element(l);
-                    this->cip_lut[0][i] = BLS12381Element(r) + pk_tmp;
-                }));
-            }
-            for (auto& f : res) f.get();
-            res.clear();
+                    cip0[i] = BLS12381Element(r) + pk_tmp;
+                }
+            });
         }
         std::stringstream commit_ss, response_ss;
         std::string commit_raw, response_raw;
-        std::stringstream commit_b64_, response_b64_;
-        Range_prover.NIZKPoK(Range_proof, commit_ss, response_ss, global_pk, c0_, cip_lut[0], L, lut_share, elgl->kp.get_sk().get_sk(), pool);
+        std::stringstream commit_out_, response_out_;
+        Range_prover.NIZKPoK(Range_proof, commit_ss, response_ss, global_pk, c0_, cip0, L, lut_share, elgl->kp.get_sk().get_sk(), pool);
+        cip_lut.set_row(0, cip0, pool);
+        vector<BLS12381Element>().swap(cip0);
         commit_raw = commit_ss.str();
-        commit_b64_ << base64_encode(commit_raw);
+        commit_out_ << commit_raw;
         response_raw = response_ss.str();
-        response_b64_ << base64_encode(response_raw);
-        elgl->serialize_sendall_(commit_b64_);
-        elgl->serialize_sendall_(response_b64_);
+        response_out_ << response_raw;
+        elgl->serialize_sendall_(commit_out_);
+        elgl->serialize_sendall_(response_out_);
         for (size_t i = 2; i <= num_party; i++)
          {
-             res.push_back(pool->enqueue([this, i](){
-                 this->elgl->wait_for(i);
+             res.push_back(pool->enqueue([&, i](){
+                 elgl->wait_for(i);
              }));
          }
          for (auto& v : res)
@@ -827,27 +916,26 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         vector<BLS12381Element> cip_v;
         l_1_v.resize(su);
         cip_v.resize(su);
-        for (size_t i = 0; i < su; i++) {
-             res.push_back(pool->enqueue([this, &c0_, &lut_share, &bound, i, &cip_v, &l_1_v]() {
+        BLS12381Element pk_tmp = this->global_pk.pk_mul(elgl->kp.get_sk().get_sk());
+        emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++) {
                 lut_share[i].set_random(bound);
                 BLS12381Element l_1, cip_;
                 l_1 = BLS12381Element(lut_share[i].get_message());
                 cip_ = l_1;
-                l_1 += c0_[i] * this->elgl->kp.get_sk().get_sk();
-                l_1_v[i] = l_1;  
-                cip_ += this->global_pk.get_pk() * this->elgl->kp.get_sk().get_sk();
-                cip_v[i] = cip_;  
-            }));
-        }
-        for (auto& f : res) f.get();
-        res.clear();
-        cip_lut[party-1] = cip_v;
+                l_1 += c0_[i] * elgl->kp.get_sk().get_sk();
+                l_1_v[i] = l_1;
+                cip_ += pk_tmp;
+                cip_v[i] = cip_;
+            }
+        });
+        cip_lut.set_row(party-1, cip_v, pool);
         Range_prover.NIZKPoK(Range_proof, commit_ss, response_ss, global_pk, c0_, cip_v, l_1_v, lut_share, elgl->kp.get_sk().get_sk(), pool);
         std::stringstream commit_ra_, response_ra_;
         std::string commit_raw = commit_ss.str();
-        commit_ra_ << base64_encode(commit_raw);
+        commit_ra_ << commit_raw;
         std::string response_raw = response_ss.str();
-        response_ra_ << base64_encode(response_raw);
+        response_ra_ << response_raw;
         elgl->serialize_sendall_(commit_ra_);
         elgl->serialize_sendall_(response_ra_);
         for (size_t i = 2; i <= num_party; i++){
@@ -863,11 +951,11 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                 elgl->deserialize_recv_(response_ro, i);
                 comm_raw = commit_ro.str();
                 response_raw = response_ro.str();
-                comm_ << base64_decode(comm_raw);
-                response_ << base64_decode(response_raw);
+                comm_ << comm_raw;
+                response_ << response_raw;
                 BLS12381Element pk__ = user_pk[i-1].get_pk();
                 Range_verifier.NIZKPoK(pk__, y3, y2, comm_, response_, c0_, global_pk, pool);
-                cip_lut[i-1] = y3;
+                cip_lut.set_row(i-1, y3, pool);
             }
         }
         std::stringstream commit_ro, response_ro;
@@ -877,15 +965,15 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         elgl->deserialize_recv_(response_ro, ALICE);
         comm_raw_ = commit_ro.str();
         response_raw_ = response_ro.str();
-        comm_ << base64_decode(comm_raw_);
-        response_ << base64_decode(response_raw_);
+        comm_ << comm_raw_;
+        response_ << response_raw_;
         vector<BLS12381Element> y2;
         vector<BLS12381Element> y3;
         y2.resize(su);
         y3.resize(su);
         BLS12381Element pk__ = user_pk[0].get_pk();
         Range_verifier.NIZKPoK(pk__, y3, y2, comm_, response_, c0_, global_pk, pool);
-        cip_lut[0] = y3;
+        cip_lut.set_row(0, y3, pool);
         elgl->send_done(ALICE);
     }
     // // print rotation and party id
@@ -900,20 +988,18 @@ template <typename IO>
 void LVT<IO>::generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table) {
     size_t n = table.size();
     lut_share.resize(su);
-    cip_lut.assign(num_party, vector<BLS12381Element>());
-    for (int p = 0; p < num_party; ++p) cip_lut[p].resize(su);
+    PointTable cip_lut;
+    cip_lut.reset(num_party, su, cip_layout);
     rotation.set_message(0); Fr k=1;
     elgl->kp.sk.assign_sk(k);
     elgl->kp.pk = ELGL_PK(elgl->kp.sk);
     BLS12381Element tmp = BLS12381Element(num_party);
     this->global_pk.assign_pk(tmp);
     for (int p = 0; p < num_party; ++p) user_pk[p].assign_pk(tmp);
+    precompute_keys();
     cr_i[party-1] = global_pk.encrypt(rotation);
     BLS12381Element pk = this->global_pk.get_pk(); 
     BLS12381Element G = tmp;
-    size_t tnum = std::max<size_t>(1, thread_num);
-    size_t chosen_block_size = (n + tnum - 1) / tnum;
-    if (chosen_block_size == 0) chosen_block_size = 1;
     bool is_consecutive = true;
     if (n > 0) {
         int64_t start = table[0];
@@ -921,64 +1007,28 @@ void LVT<IO>::generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation
             if (table[i] != start + static_cast<int64_t>(i)) { is_consecutive = false; break; }
         }
     }
-    for (int p = 1; p < num_party; ++p) {
-        std::fill(cip_lut[p].begin(), cip_lut[p].begin() + n, pk);
-    }
-    vector<future<void>> tasks;
-    tasks.reserve(tnum + 4);
-    if (is_consecutive) {
-        size_t idx = 0;
-        while (idx < n) {
-            size_t bstart = idx;
-            size_t bend = std::min(n, bstart + chosen_block_size);
-            tasks.push_back(pool->enqueue([this, bstart, bend, G, pk, &table]() {
-                BLS12381Element start_point = BLS12381Element(static_cast<int64_t>(bstart + table[0]));
-                BLS12381Element cur = start_point;
-                for (size_t j = bstart; j < bend; ++j) {
-                    cip_lut[0][j] = cur + pk; 
-                    cur += G;
-                }
-            }));
-            idx = bend;
-        }
-    } else {
-        size_t idx = 0;
-        while (idx < n) {
-            size_t bstart = idx;
-            size_t bend = std::min(n, bstart + chosen_block_size);
-            tasks.push_back(pool->enqueue([this, bstart, bend, &table, pk]() {
-                for (size_t j = bstart; j < bend; ++j) {
-                    cip_lut[0][j] = BLS12381Element(table[j]) + pk;
-                }
-            }));
-            idx = bend;
-        }
-    }
-    for (auto &f : tasks) f.get();
-    tasks.clear();
-    if (party == 1) {
-        size_t idx = 0;
-        while (idx < n) {
-            size_t bstart = idx;
-            size_t bend = std::min(n, bstart + chosen_block_size);
-            tasks.push_back(pool->enqueue([bstart, bend, &lut_share, &table]() {
-                for (size_t j = bstart; j < bend; ++j) lut_share[j].set_message(table[j]);
-            }));
-            idx = bend;
+    emp::parallel_for(pool, 0, n, [&](size_t bstart, size_t bend) {
+        vector<G1> pts(bend - bstart);
+        for (int p = 1; p < num_party; ++p) {
+            std::fill(pts.begin(), pts.end(), pk.getPoint());
+            cip_lut.store(p, bstart, pts.data(), pts.size());
         }
-    } else {
-        size_t idx = 0;
-        while (idx < n) {
-            size_t bstart = idx;
-            size_t bend = std::min(n, bstart + chosen_block_size);
-            tasks.push_back(pool->enqueue([bstart, bend, &lut_share]() {
-                for (size_t j = bstart; j < bend; ++j) lut_share[j].set_message(0);
-            }));
-            idx = bend;
+        if (is_consecutive) {
+            BLS12381Element cur = BLS12381Element(static_cast<int64_t>(bstart + table[0]));
+            for (size_t j = bstart; j < bend; ++j) {
+                pts[j - bstart] = (cur + pk).getPoint();
+                cur += G;
+            }
+        } else {
+            for (size_t j = bstart; j < bend; ++j)
+                pts[j - bstart] = (BLS12381Element(table[j]) + pk).getPoint();
         }
-    }
-    for (auto &f : tasks) f.get();
-    tasks.clear();
+        cip_lut.store(0, bstart, pts.data(), pts.size());
+    });
+    emp::parallel_for(pool, 0, n, [&](size_t bstart, size_t bend) {
+        for (size_t j = bstart; j < bend; ++j) lut_share[j].set_message(party == 1 ? table[j] : 0);
+    });
+    install_cip(std::move(cip_lut));
     elgl->serialize_sendall(cr_i[party-1]);
     for (int p = 1; p <= num_party; ++p) {
         if (p != party) elgl->deserialize_recv(cr_i[p-1], p);
@@ -989,53 +1039,24 @@ void LVT<IO>::generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation
 template <typename IO>
 void LVT<IO>::generate_shares_fake(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table) {
     lut_share.resize(su);
-    cip_lut.resize(num_party, vector<BLS12381Element>(su));
-    for (int i = 0; i < num_party; ++i) {
-        cip_lut[i].resize(su);
-    }
+    PointTable cip_lut;
+    cip_lut.reset(num_party, su, cip_layout);
     rotation.set_message(0);
     cr_i[party-1] = global_pk.encrypt(rotation);
     BLS12381Element tmp = BLS12381Element(0);
-    vector<future<void>> res;
-    size_t block_size = (su + thread_num - 1) / thread_num;
-    if (party == 1) {
-        for (int t = 0; t < thread_num; ++t) {
-        size_t start = t * block_size;
-        size_t end = std::min(su, start + block_size);
-        res.push_back(pool->enqueue([this, &lut_share, &table, start, end]() {
-            for (size_t i = start; i < end; ++i) lut_share[i].set_message(table[i]);
-        }));
-        }
-        for (auto& f : res) f.get();
-        res.clear();
-    } else{
-        for (int t = 0; t < thread_num; ++t) {
-        size_t start = t * block_size;
-        size_t end = std::min(su, start + block_size);
-        res.push_back(pool->enqueue([this, &lut_share, &table, start, end]() {
-            for (size_t i = start; i < end; ++i) lut_share[i].set_message(0);
-        }));
+    emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) lut_share[i].set_message(party == 1 ? table[i] : 0);
+    });
+    emp::parallel_for(pool, 0, table.size(), [&](size_t l, size_t r) {
+        vector<G1> pts(r - l);
+        for (size_t i = l; i < r; ++i) pts[i - l] = (BLS12381Element(table[i]) + tmp).getPoint();
+        cip_lut.store(0, l, pts.data(), pts.size());
+        for (int p = 1; p < this->num_party; ++p) {
+            std::fill(pts.begin(), pts.end(), tmp.getPoint());
+            cip_lut.store(p, l, pts.data(), pts.size());
         }
-        for (auto& f : res) f.get();
-        res.clear();
-    }
-
-    for (int i = 0; i < table.size(); ++i) {
-        res.push_back(pool->enqueue([this, &lut_share, &tmp, i, &table]() {
-            cip_lut[0][i] = BLS12381Element(table[i]) + tmp;
-        }));
-    }
-    for (auto& f : res) f.get();
-    res.clear();
-
-    for (int i = 0; i < table.size(); ++i) {
-    res.push_back(pool->enqueue([this, &lut_share, &tmp, i, &table]() {
-        for (int p = 1; p < this->num_party; ++p)
-            cip_lut[p][i] = tmp;
-        }));
-    }
-    for (auto& f : res) f.get();
-    res.clear();
+    });
+    install_cip(std::move(cip_lut));
 }
 
 template <typename IO>
@@ -1073,11 +1094,24 @@ ELGL_PK LVT<IO>::DistKeyGen(bool offline){
             }
         }
     }
+    ctx->keyed = true;
+    precompute_keys();
     return global_pk;
 }
 
+// Fixed-base tables for global_pk and every user_pk; copies share them.
+// Keys already precomputed through another LVT on the context are kept.
+template <typename IO>
+void LVT<IO>::precompute_keys() {
+    if (!global_pk.precomputed()) global_pk.precompute();
+    emp::parallel_for(pool, 0, user_pk.size(), [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++)
+            if (!user_pk[i].precomputed()) user_pk[i].precompute();
+    }, 1);
+}
+
 template <typename IO>
-Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m, LVT<IO>* lvt) {
+Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m, LVT<IO>* lvt) {
     Plaintext sk(elgl->kp.get_sk().get_sk());
     BLS12381Element ask = c.get_c0() * sk.get_message();
     std::vector<BLS12381Element> ask_parts(num_party);
@@ -1085,19 +1119,14 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
 
     ExpProof exp_proof(global_pk);
     ExpProver exp_prover(exp_proof);
-    ExpVerifier exp_verifier(exp_proof);
 
     std::stringstream commit, response;
     BLS12381Element g1 = c.get_c0();
     BLS12381Element y1 = user_pks[party-1].get_pk();
     exp_prover.NIZKPoK(exp_proof, commit, response, g1, y1, ask, sk, party, pool);
 
-    std::stringstream commit_b64, response_b64;
-    commit_b64 << base64_encode(commit.str());
-    response_b64 << base64_encode(response.str());
-
-    elgl->serialize_sendall_(commit_b64);
-    elgl->serialize_sendall_(response_b64);
+    elgl->serialize_sendall_(commit);
+    elgl->serialize_sendall_(response);
     std::vector<std::future<void>> verify_futures;
     for (int i = 1; i <= num_party; ++i) {
         if (i != party) {
@@ -1108,19 +1137,6 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
                 elgl->deserialize_recv_(local_commit_stream, i);
                 elgl->deserialize_recv_(local_response_stream, i);
 
-                std::string comm_raw = local_commit_stream.str();
-                std::string resp_raw = local_response_stream.str();
-
-                local_commit_stream.str("");
-                local_commit_stream.clear();
-                local_commit_stream << base64_decode(comm_raw);
-                local_commit_stream.seekg(0);
-
-                local_response_stream.str("");
-                local_response_stream.clear();
-                local_response_stream << base64_decode(resp_raw);
-                local_response_stream.seekg(0);
-
                 BLS12381Element y1_other = user_pks[i - 1].get_pk();
                 BLS12381Element ask_i;
                 ExpVerifier exp_verifier(exp_proof);
@@ -1138,15 +1154,10 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
         pi_ask -= ask_i;
     }
 
-    std::string key = pi_ask.getPoint().getStr();
     Fr y;
     if(lvt->ad <= 1UL << 20) {
-        auto it = P_to_m.find(key);
-        bool t = 1;
-        if (it == P_to_m.end()) {
-            t = 0;
-        }
-        if (t) return it->second;
+        int64_t m = P_to_m.find(pi_ask);
+        if (m >= 0) return Fr(m);
     } 
     cout << "lvt->bsgs.solve_parallel_with_pool" << endl;
     y = lvt->bsgs.solve_parallel_with_pool(pi_ask, pool, thread_num);
@@ -1156,7 +1167,7 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
 
 
 template <typename IO>
-BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m, LVT<IO>* lvt) {
+BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m, LVT<IO>* lvt) {
     Plaintext sk(elgl->kp.get_sk().get_sk());
     BLS12381Element ask = c.get_c0() * sk.get_message();
     std::vector<BLS12381Element> ask_parts(num_party);
@@ -1164,19 +1175,14 @@ BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk,
 
     ExpProof exp_proof(global_pk);
     ExpProver exp_prover(exp_proof);
-    ExpVerifier exp_verifier(exp_proof);
 
     std::stringstream commit, response;
     BLS12381Element g1 = c.get_c0();
     BLS12381Element y1 = user_pks[party-1].get_pk();
     exp_prover.NIZKPoK(exp_proof, commit, response, g1, y1, ask, sk, party, pool);
 
-    std::stringstream commit_b64, response_b64;
-    commit_b64 << base64_encode(commit.str());
-    response_b64 << base64_encode(response.str());
-
-    elgl->serialize_sendall_(commit_b64);
-    elgl->serialize_sendall_(response_b64);
+    elgl->serialize_sendall_(commit);
+    elgl->serialize_sendall_(response);
 
     std::vector<std::future<void>> verify_futures;
     for (int i = 1; i <= num_party; ++i) {
@@ -1188,19 +1194,6 @@ BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk,
                 elgl->deserialize_recv_(local_commit_stream, i);
                 elgl->deserialize_recv_(local_response_stream, i);
 
-                std::string comm_raw = local_commit_stream.str();
-                std::string resp_raw = local_response_stream.str();
-
-                local_commit_stream.str("");
-                local_commit_stream.clear();
-                local_commit_stream << base64_decode(comm_raw);
-                local_commit_stream.seekg(0);
-
-                local_response_stream.str("");
-                local_response_stream.clear();
-                local_response_stream << base64_decode(resp_raw);
-                local_response_stream.seekg(0);
-
                 BLS12381Element y1_other = user_pks[i - 1].get_pk();
                 BLS12381Element ask_i;
                 ExpVerifier exp_verifier(exp_proof);
@@ -1225,58 +1218,51 @@ template <typename IO>
 vector<BLS12381Element>
 LVT<IO>::batch_thdcp(
     vector<Ciphertext>& c,
-    vector<Plaintext>& u_tmp,
-    ELGL<IO>* elgl,
-    const ELGL_PK& global_pk,
-    const std::vector<ELGL_PK>& user_pks,
-    MPIOChannel<IO>* io,
-    ThreadPool* pool,
-    int party,
-    int num_party,
-    std::map<std::string, Fr>& P_to_m)
+    vector<Plaintext>& u_tmp)
+{
+    ThdcpRound rd;
+    batch_thdcp_send(c, u_tmp, rd);
+    return batch_thdcp_finish(c, u_tmp, rd);
+}
+
+// First half of batch_thdcp: partial decryptions, proof and u-shares are
+// computed and queued for broadcast. Returns without waiting for peers.
+template <typename IO>
+void LVT<IO>::batch_thdcp_send(vector<Ciphertext>& c, vector<Plaintext>& u_tmp, ThdcpRound& rd)
 {
     const size_t n = c.size();
-    const size_t T = pool->size();
-    const size_t chunk = (n + T - 1) / T;
 
     Plaintext sk(elgl->kp.get_sk().get_sk());
 
     vector<BLS12381Element> ask(n);
-    vector<vector<BLS12381Element>> ask_parts(num_party, vector<BLS12381Element>(n));
-    vector<BLS12381Element> g1(n);
-
-    {
-        vector<std::future<void>> futs;
-        futs.reserve(T);
-
-        for (size_t t = 0; t < T; ++t) {
-            size_t l = t * chunk;
-            size_t r = std::min(l + chunk, n);
-            if (l >= r) break;
-
-            futs.emplace_back(pool->enqueue([&, l, r]() {
-                for (size_t i = l; i < r; ++i) {
-                    g1[i] = c[i].get_c0();
-                    ask[i] = g1[i] * sk.get_message();
-                    ask_parts[party - 1][i] = ask[i];
-                }
-            }));
+    rd.ask_parts.assign(num_party, vector<BLS12381Element>(n));
+    rd.g1.resize(n);
+
+    emp::parallel_for(pool, 0, n, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
+            rd.g1[i] = c[i].get_c0();
+            ask[i] = rd.g1[i] * sk.get_message();
+            rd.ask_parts[party - 1][i] = ask[i];
         }
-        for (auto& f : futs) f.get();
-    }
+    });
 
     ExpProof exp_proof(global_pk);
     ExpProver exp_prover(exp_proof);
-    ExpVerifier exp_verifier(exp_proof);
 
     std::stringstream sendss;
-    BLS12381Element pk_tmp = user_pks[party - 1].get_pk();
-    exp_prover.NIZKPoK_(exp_proof, sendss, pk_tmp, g1, ask, sk, pool);
+    exp_prover.NIZKPoK_(exp_proof, sendss, user_pk[party - 1].get_pk(), rd.g1, ask, sk, pool);
 
     for (size_t i = 0; i < n; ++i)
         u_tmp[i].pack(sendss);
 
     elgl->serialize_sendall_(sendss);
+}
+
+// Second half: receive and verify every peer's round, then combine.
+template <typename IO>
+vector<BLS12381Element> LVT<IO>::batch_thdcp_finish(vector<Ciphertext>& c, vector<Plaintext>& u_tmp, ThdcpRound& rd)
+{
+    const size_t n = c.size();
 
     vector<std::future<void>> verify_futures;
     vector<std::stringstream> recvss(num_party);
@@ -1287,10 +1273,12 @@ LVT<IO>::batch_thdcp(
 
         verify_futures.emplace_back(
             pool->enqueue([&, i]() {
+                // The verifier writes its challenge into the proof, so each
+                // peer's task needs its own.
+                ExpProof exp_proof(global_pk);
+                ExpVerifier exp_verifier(exp_proof);
                 elgl->deserialize_recv_(recvss[i - 1], i);
-                BLS12381Element y1_other = user_pks[i - 1].get_pk();
-                exp_verifier.NIZKPoK_(
-                    y1_other, g1, ask_parts[i - 1], recvss[i - 1], pool);
+                exp_verifier.NIZKPoK_(user_pk[i - 1].get_pk(), rd.g1, rd.ask_parts[i - 1], recvss[i - 1], pool);
 
                 for (size_t t = 0; t < n; ++t)
                     u_others[i - 1][t].unpack(recvss[i - 1]);
@@ -1299,45 +1287,16 @@ LVT<IO>::batch_thdcp(
 
     for (auto& f : verify_futures) f.get();
 
-    {
-        vector<std::future<void>> futs;
-        futs.reserve(T);
-
-        for (size_t t = 0; t < T; ++t) {
-            size_t l = t * chunk;
-            size_t r = std::min(l + chunk, n);
-            if (l >= r) break;
-
-            futs.emplace_back(pool->enqueue([&, l, r]() {
-                for (size_t i = l; i < r; ++i) {
-                    for (int p = 0; p < num_party; ++p)
-                        u_tmp[i] += u_others[p][i];
-                }
-            }));
-        }
-        for (auto& f : futs) f.get();
-    }
-
     vector<BLS12381Element> pi_ask(n);
-    {
-        vector<std::future<void>> futs;
-        futs.reserve(T);
-
-        for (size_t t = 0; t < T; ++t) {
-            size_t l = t * chunk;
-            size_t r = std::min(l + chunk, n);
-            if (l >= r) break;
-
-            futs.emplace_back(pool->enqueue([&, l, r]() {
-                for (size_t i = l; i < r; ++i) {
-                    pi_ask[i] = c[i].get_c1();
-                    for (int j = 0; j < num_party; ++j)
-                        pi_ask[i] -= ask_parts[j][i];
-                }
-            }));
+    emp::parallel_for(pool, 0, n, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
+            for (int p = 0; p < num_party; ++p)
+                u_tmp[i] += u_others[p][i];
+            pi_ask[i] = c[i].get_c1();
+            for (int j = 0; j < num_party; ++j)
+                pi_ask[i] -= rd.ask_parts[j][i];
         }
-        for (auto& f : futs) f.get();
-    }
+    });
 
     return pi_ask;
 }
@@ -1363,8 +1322,8 @@ tuple<Plaintext, vector<Ciphertext>> LVT<IO>::lookup_online(Plaintext& x_share,
     for (size_t i = 1; i <= num_party; i++){
         res.push_back(pool->enqueue([this, i, &P_shares, &u_shares](){
             if (i != party){
-                std::stringstream recv_ss;
-                elgl->deserialize_recv_(recv_ss, i);
+                MsgView msg = elgl->deserialize_recv_view(i);
+                cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
                 P_shares[i-1].unpack(recv_ss);
                 u_shares[i-1].unpack(recv_ss);
             }
@@ -1386,22 +1345,12 @@ tuple<Plaintext, vector<Ciphertext>> LVT<IO>::lookup_online(Plaintext& x_share,
         std::cerr << "[Error] LVT lookup_online U != H!" << std::endl;
         exit(1);
     }
-    mcl::Vint h;
-    h.setStr(to_string(su));
-    mcl::Vint q1 = u.get_message().getMpz();
-    mcl::gmp::mod(q1, q1, h);
-    u.assign(q1.getStr());
-    mcl::Vint tbs;
-    tbs.setStr(to_string(su));
-    mcl::Vint u_mpz = u.get_message().getMpz(); 
-    mcl::gmp::mod(u_mpz, u_mpz, tbs);
-    mcl::Vint index_mpz;
-    index_mpz.setStr(u_mpz.getStr());
-    size_t index = static_cast<size_t>(index_mpz.getLow32bit());
+    size_t index = u.mod_uint64(su);
+    u.assign_uint64(index);
     out = this->lut_share[index];
     out_ciphers.resize(num_party);
     for (size_t i = 0; i < num_party; i++){
-        Ciphertext tmp(user_pk[i].get_pk(), cip_lut[i][index]);
+        Ciphertext tmp(user_pk[i].get_pk(), cip_at(i, index));
         out_ciphers[i] = tmp;
     }
     return std::make_tuple(out, out_ciphers);
@@ -1428,8 +1377,8 @@ tuple<Plaintext, vector<Ciphertext>> LVT<IO>::lookup_online_(Plaintext& x_share,
     for (size_t i = 1; i <= num_party; i++){
         res.push_back(pool->enqueue([this, i, &x_ciphers, &u_shares](){
             if (i != party){
-                std::stringstream recv_ss;
-                elgl->deserialize_recv_(recv_ss, i);
+                MsgView msg = elgl->deserialize_recv_view(i);
+                cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
                 Ciphertext x_cip;
                 x_cip.unpack(recv_ss);
                 Plaintext u_share;
@@ -1450,29 +1399,17 @@ tuple<Plaintext, vector<Ciphertext>> LVT<IO>::lookup_online_(Plaintext& x_share,
         c +=  x_ciphers[i] + cr_i[i];
         uu += u_shares[i];
     }
-    mcl::Vint h;
-    h.setStr(to_string(su));
-    mcl::Vint q1 = uu.get_message().getMpz();
-    mcl::gmp::mod(q1, q1, h);
-    uu.assign(q1.getStr());
+    size_t index = uu.mod_uint64(su);
+    uu.assign_uint64(index);
 
     Fr u = thdcp(c, elgl, global_pk, user_pk, elgl->io, pool, party, num_party, P_to_m, this);
-    mcl::Vint q2 = u.getMpz(); 
-    mcl::gmp::mod(q2, q2, h);
-    u.setStr(q2.getStr());
-    mcl::Vint tbs;
-    tbs.setStr(to_string(su));
-    mcl::Vint u_mpz = uu.get_message().getMpz(); 
-    mcl::gmp::mod(u_mpz, u_mpz, tbs);
-
-    mcl::Vint index_mpz;
-    index_mpz.setStr(u_mpz.getStr());
-    size_t index = static_cast<size_t>(index_mpz.getLow32bit());
+    uint64_t u_index = Plaintext(u).mod_uint64(su);
+    u.setArray(&u_index, 1);
 
     out = this->lut_share[index];
     out_ciphers.resize(num_party);
     for (size_t i = 0; i < num_party; i++){
-        Ciphertext tmp(user_pk[i].get_pk(), cip_lut[i][index]);
+        Ciphertext tmp(user_pk[i].get_pk(), cip_at(i, index));
         out_ciphers[i] = tmp;
     }
     // cout << "party: " << party << " index = " << index << endl;
@@ -1485,95 +1422,107 @@ tuple<Plaintext, vector<Ciphertext>> LVT<IO>::lookup_online_(Plaintext& x_share,
 }
 
 template <typename IO>
-tuple<vector<Plaintext>, vector<vector<Ciphertext>>>
+tuple<vector<Plaintext>, LutOutput>
 LVT<IO>::lookup_online_batch(
     vector<Plaintext>& x_shares,
     vector<vector<Ciphertext>>& x_ciphers)
 {
-    const size_t x_size = x_shares.size();
-    if (x_size == 0) return {};
-
-    const size_t T = pool->size();
-    const size_t chunk = (x_size + T - 1) / T;
-
-    vector<Plaintext> out(x_size);
-    vector<vector<Ciphertext>> out_ciphers(num_party, vector<Ciphertext>(x_size));
-
-    vector<Plaintext> local_u_share(x_size);
-    vector<Plaintext> u_total(x_size);
-    vector<Ciphertext> c_total(x_size);
+    if (x_shares.empty()) return {};
+    return std::move(lookup_online_multi({this}, x_shares, x_ciphers)[0]);
+}
 
-    {
-        vector<std::future<void>> futs;
-        futs.reserve(T);
-
-        for (size_t t = 0; t < T; ++t) {
-            size_t l = t * chunk;
-            size_t r = std::min(l + chunk, x_size);
-            if (l >= r) break;
-
-            futs.emplace_back(pool->enqueue([&, l, r]() {
-                for (size_t i = l; i < r; ++i) {
-                    local_u_share[i] = x_shares[i] + rotation;
-                    u_total[i] = local_u_share[i];
-
-                    c_total[i] = x_ciphers[0][i] + cr_i[0];
-                    for (size_t p = 1; p < num_party; ++p) {
-                        c_total[i] += x_ciphers[p][i] + cr_i[p];
-                    }
-                }
-            }));
-        }
-        for (auto& f : futs) f.get();
-    }
+// The batch is processed in rounds of online_chunk elements, pipelined two
+// deep: round k+1 is computed and queued for broadcast before round k is
+// received and verified, so local compute overlaps the peers' transfers.
+template <typename IO>
+vector<tuple<vector<Plaintext>, LutOutput>>
+LVT<IO>::lookup_online_multi(
+    const vector<LVT<IO>*>& tables,
+    vector<Plaintext>& x_shares,
+    vector<vector<Ciphertext>>& x_ciphers)
+{
+    const size_t x_size = x_shares.size();
+    const size_t n_tables = tables.size();
+    for (auto* t : tables) {
+        if (t->global_pk.get_pk() != global_pk.get_pk())
+            throw std::runtime_error("lookup_online_multi: tables use different keys");
+        Plaintext r;
+        r.assign_uint64(rotation.mod_uint64(t->su));
+        if (t->su > su || t->rotation != r)
+            throw std::runtime_error("lookup_online_multi: table rotation does not match");
+    }
+    vector<tuple<vector<Plaintext>, LutOutput>> res(n_tables);
+    if (x_size == 0) return res;
+
+    const size_t step = online_chunk ? std::min(online_chunk, x_size) : x_size;
+    const size_t rounds = (x_size + step - 1) / step;
+
+    vector<vector<Plaintext>> out(n_tables, vector<Plaintext>(x_size));
+    vector<vector<uint32_t>> out_idx(n_tables, vector<uint32_t>(x_size));
+
+    auto for_range = [&](size_t base, size_t n, auto body) {
+        emp::parallel_for(pool, 0, n, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; ++i) body(base + i, i);
+        });
+    };
 
-    vector<BLS12381Element> U =
-        batch_thdcp(c_total, u_total, elgl, global_pk,
-                    user_pk, elgl->io, pool,
-                    party, num_party, P_to_m);
+    struct Round {
+        size_t base = 0, n = 0;
+        vector<Plaintext> u_total;
+        vector<Ciphertext> c_total;
+        ThdcpRound thdcp;
+    };
 
-    mcl::Vint su_mod;
-    su_mod.setStr(to_string(su));
+    auto start_round = [&](Round& rd, size_t k) {
+        rd.base = k * step;
+        rd.n = std::min(step, x_size - rd.base);
+        rd.u_total.resize(rd.n);
+        rd.c_total.resize(rd.n);
+        for_range(rd.base, rd.n, [&](size_t g, size_t i) {
+            rd.u_total[i] = x_shares[g] + rotation;
+            rd.c_total[i] = x_ciphers[0][g] + cr_i[0];
+            for (size_t p = 1; p < num_party; ++p) {
+                rd.c_total[i] += x_ciphers[p][g] + cr_i[p];
+            }
+        });
+        batch_thdcp_send(rd.c_total, rd.u_total, rd.thdcp);
+    };
 
-    {
-        vector<std::future<void>> futs;
-        futs.reserve(T);
-
-        for (size_t t = 0; t < T; ++t) {
-            size_t l = t * chunk;
-            size_t r = std::min(l + chunk, x_size);
-            if (l >= r) break;
-
-            futs.emplace_back(pool->enqueue([&, l, r]() {
-                for (size_t i = l; i < r; ++i) {
-                    BLS12381Element UU(u_total[i].get_message());
-                    if (U[i] != UU) {
-                        std::cerr << "[Error] lookup_online_batch verify fail at i="
-                                  << i << " party=" << party << "\n";
-                        std::exit(1);
-                    }
+    auto finish_round = [&](Round& rd) {
+        vector<BLS12381Element> U = batch_thdcp_finish(rd.c_total, rd.u_total, rd.thdcp);
+        for_range(rd.base, rd.n, [&](size_t g, size_t i) {
+            BLS12381Element UU(rd.u_total[i].get_message());
+            if (U[i] != UU) {
+                std::cerr << "[Error] lookup_online_batch verify fail at i="
+                          << g << " party=" << party << "\n";
+                std::exit(1);
+            }
 
-                    mcl::Vint v = u_total[i].get_message().getMpz();
-                    v %= su_mod;
-                    u_total[i].assign(v.getStr());
+            for (size_t k = 0; k < n_tables; ++k) {
+                size_t idx = rd.u_total[i].mod_uint64(tables[k]->su);
+                out[k][g] = tables[k]->lut_share[idx];
+                out_idx[k][g] = idx;
+            }
+        });
+    };
 
-                    size_t idx = static_cast<size_t>(v.getLow32bit());
-                    out[i] = lut_share[idx];
-                    for (size_t p = 0; p < num_party; ++p)
-                        out_ciphers[p][i] =
-                            Ciphertext(user_pk[p].get_pk(), cip_lut[p][idx]);
-                }
-            }));
-        }
-        for (auto& f : futs) f.get();
+    Round cur, next;
+    start_round(cur, 0);
+    for (size_t k = 0; k < rounds; ++k) {
+        if (k + 1 < rounds)
+            start_round(next, k + 1);
+        finish_round(cur);
+        std::swap(cur, next);
     }
 
-    return { out, out_ciphers };
+    for (size_t k = 0; k < n_tables; ++k)
+        res[k] = { std::move(out[k]), tables[k]->lookup_output(std::move(out_idx[k])) };
+    return res;
 }
 
 
 template <typename IO>
-tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batch(vector<Plaintext>& x_shares, vector<Ciphertext>& x_cipher)
+tuple<vector<Plaintext>, LutOutput> LVT<IO>::lookup_online_batch(vector<Plaintext>& x_shares, vector<Ciphertext>& x_cipher)
 {
     size_t x_size = x_shares.size();
     if (x_size == 0) return {};
@@ -1586,8 +1535,8 @@ tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batc
     for (size_t p = 1; p <= num_party; p++) {
         if (p == party) continue;
         recv_futs.push_back(pool->enqueue([&, p]() {
-            std::stringstream recv_ss;
-            elgl->deserialize_recv_(recv_ss, p);
+            MsgView msg = elgl->deserialize_recv_view(p);
+            cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
             for (size_t i = 0; i < x_size; ++i) {
                 x_ciphers[p-1][i].unpack(recv_ss);
             }
@@ -1598,7 +1547,7 @@ tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batc
     recv_futs.clear();
     
     vector<Plaintext> out(x_size);
-    vector<vector<Ciphertext>> out_ciphers(num_party, vector<Ciphertext>(x_size));
+    vector<uint32_t> out_idx(x_size);
     vector<std::future<void>> fut;  
     fut.reserve(x_size);
     vector<Plaintext>  local_u_share(x_size);
@@ -1607,8 +1556,8 @@ tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batc
     vector<BLS12381Element> local_p1(x_size);
     vector<BLS12381Element> p_sum(x_size);
     Fr sk = elgl->kp.sk.get_sk();
-    for (size_t i = 0; i < x_size; i++) {
-        fut.push_back(pool->enqueue([&, i]() {
+    emp::parallel_for(pool, 0, x_size, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
             local_u_share[i]  = x_shares[i]  + rotation;
             u_total[i] = local_u_share[i];
             c_total[i] = x_ciphers[0][i] + cr_i[0];
@@ -1617,10 +1566,8 @@ tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batc
             }
             local_p1[i] = c_total[i].get_c0() * sk;
             p_sum[i] = local_p1[i];
-        }));
-    }
-    for (auto &f : fut) f.get();
-    fut.clear();
+        }
+    });
 
     std::stringstream send_ss;
     for (size_t i = 0; i < x_size; ++i) {
@@ -1666,42 +1613,26 @@ tuple<vector<Plaintext>, vector<vector<Ciphertext>>> LVT<IO>::lookup_online_batc
     }
     for (auto &f : fut) f.get();
     fut.clear();
-    size_t num_workers = std::min(static_cast<size_t>(thread_num), x_size);
-    size_t block_size = (x_size + num_workers - 1) / num_workers;
-    for (size_t w = 0; w < num_workers; ++w) {
-        size_t start = w * block_size;
-        size_t end = std::min(x_size, start + block_size);
-        if (start >= end) continue;
-        fut.push_back(pool->enqueue([&, start, end]() {
-            for (size_t i = start; i < end; ++i) {
-                for (size_t p = 1; p <= num_party; ++p) {
-                    if (p == party) continue;
-                    p_sum[i] += recv_p1[p-1][i];
-                    u_total[i] += recv_shares[p-1][i];
-                }
+    emp::parallel_for(pool, 0, x_size, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
+            for (size_t p = 1; p <= num_party; ++p) {
+                if (p == party) continue;
+                p_sum[i] += recv_p1[p-1][i];
+                u_total[i] += recv_shares[p-1][i];
             }
-        }));
-    }
-    for (auto &f : fut) f.get();
-    fut.clear();
-    mcl::Vint su_mod;
-    su_mod.setStr(to_string(su));
-    for (size_t i = 0; i < x_size; i++) {
-        fut.push_back(pool->enqueue([&, i]() {
+        }
+    });
+    emp::parallel_for(pool, 0, x_size, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
             BLS12381Element H = c_total[i].get_c1() - p_sum[i];
             BLS12381Element U = BLS12381Element(u_total[i].get_message());
-            mcl::Vint v = u_total[i].get_message().getMpz();
-            v %= su_mod;
-            u_total[i].assign(v.getStr());
-            size_t idx = static_cast<size_t>(v.getLow32bit());
+            size_t idx = u_total[i].mod_uint64(su);
+            u_total[i].assign_uint64(idx);
             out[i] = lut_share[idx];
-            for (size_t p = 0; p < num_party; p++)
-                out_ciphers[p][i] = Ciphertext(user_pk[p].get_pk(), cip_lut[p][idx]);
-        }));
-    }
-    for (auto &f : fut) f.get();
-    fut.clear();
-    return { out, out_ciphers };
+            out_idx[i] = idx;
+        }
+    });
+    return { out, lookup_output(std::move(out_idx)) };
 }
 
 
@@ -1711,22 +1642,10 @@ vector<Plaintext> LVT<IO>::lookup_online_batch_(vector<Plaintext>& x_share){
     vector<Plaintext> out(x_size);
     vector<Plaintext> uu(x_size);
     if (x_size == 0) return out;
-    size_t tnum = std::max<size_t>(1, thread_num);
-    size_t block_size = (x_size + tnum - 1) / tnum;
-    if (block_size == 0) block_size = 1;
-    {
-        vector<future<void>> futs;
-        for (size_t b = 0; b < x_size; b += block_size) {
-            size_t bstart = b;
-            size_t bend = std::min(x_size, b + block_size);
-
-            futs.push_back(pool->enqueue([this, bstart, bend, &x_share, &uu]() {
-                for (size_t i = bstart; i < bend; ++i)
-                    uu[i] = x_share[i] + this->rotation;
-            }));
-        }
-        for (auto &f : futs) f.get();
-    }
+    emp::parallel_for(pool, 0, x_size, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i)
+            uu[i] = x_share[i] + this->rotation;
+    });
     std::stringstream send_ss;
     for (size_t i = 0; i < x_size; ++i)
         uu[i].pack(send_ss);
@@ -1736,8 +1655,8 @@ vector<Plaintext> LVT<IO>::lookup_online_batch_(vector<Plaintext>& x_share){
     for (int p = 1; p <= num_party; ++p) {
         if (p == party) continue;
         recv_futs.push_back(pool->enqueue([this, p, x_size]() -> vector<Plaintext> {
-            std::stringstream recv_ss;
-            elgl->deserialize_recv_(recv_ss, p);
+            MsgView msg = elgl->deserialize_recv_view(p);
+            cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
             vector<Plaintext> tmp(x_size);
             for (size_t j = 0; j < x_size; ++j)
                 tmp[j].unpack(recv_ss);
@@ -1747,39 +1666,15 @@ vector<Plaintext> LVT<IO>::lookup_online_batch_(vector<Plaintext>& x_share){
     vector<vector<Plaintext>> recv_results;
     for (auto &f : recv_futs)
         recv_results.push_back(f.get());
-    for (auto &tmp_vec : recv_results) {
-        vector<future<void>> futs;
-        for (size_t b = 0; b < x_size; b += block_size) {
-            size_t bstart = b;
-            size_t bend = std::min(x_size, b + block_size);
-
-            futs.push_back(pool->enqueue([bstart, bend, &uu, &tmp_vec]() {
-                for (size_t j = bstart; j < bend; ++j)
-                    uu[j] += tmp_vec[j];
-            }));
+    emp::parallel_for(pool, 0, x_size, [&](size_t l, size_t r) {
+        for (auto &tmp_vec : recv_results)
+            for (size_t j = l; j < r; ++j)
+                uu[j] += tmp_vec[j];
+        for (size_t i = l; i < r; ++i) {
+            size_t index = uu[i].mod_uint64(su);
+            out[i] = this->lut_share[index];
         }
-        for (auto &f : futs) f.get();
-    }
-    {
-        mcl::Vint tbs; tbs.setStr(to_string(su));
-        vector<future<void>> futs;
-
-        for (size_t b = 0; b < x_size; b += block_size) {
-            size_t bstart = b;
-            size_t bend = std::min(x_size, b + block_size);
-
-            futs.push_back(pool->enqueue([this, bstart, bend, &uu, &out, &tbs]() {
-                for (size_t i = bstart; i < bend; ++i) {
-                    mcl::Vint u_mpz = uu[i].get_message().getMpz();
-                    mcl::gmp::mod(u_mpz, u_mpz, tbs);
-
-                    size_t index = static_cast<size_t>(u_mpz.getLow32bit());
-                    out[i] = this->lut_share[index];
-                }
-            }));
-        }
-        for (auto &f : futs) f.get();
-    }
+    });
     return out;
 }
 
@@ -1799,18 +1694,13 @@ Plaintext LVT<IO>::Reconstruct(Plaintext input, vector<Ciphertext> input_cips, E
         }
     }
     Fr out_ = thdcp(out_cip, elgl, global_pk, user_pks, io, pool, party, num_party, P_to_m, this); 
-    mcl::Vint o = out_.getMpz();
-    o %= modulo;
-
-    mcl::Vint o_ = out.get_message().getMpz();
-    o_ %= modulo;
-    
-    if (o_ != o) {
-        cout << "o_: " << o_ << endl; 
-        cout << "o: " << o << endl;
+    Plaintext o = lvt_mod(Plaintext(out_), modulo);
+    out = lvt_mod(out, modulo);
+    if (out != o) {
+        cout << "o_: " << out.get_message() << endl;
+        cout << "o: " << o.get_message() << endl;
         error("Reconstruct error");
     }
-    out.assign(o_);
     return out;
 }
 
@@ -1838,16 +1728,10 @@ Plaintext LVT<IO>::Reconstruct_interact(Plaintext input, Ciphertext input_cip, E
     }
 
     Fr out_ = thdcp(out_cip, elgl, global_pk, user_pks, io, pool, party, num_party, P_to_m, this);
-    mcl::Vint o = out_.getMpz();
-    o %= modulo;
-
-    mcl::Vint o_ = out.get_message().getMpz();
-    o_ %= modulo;
-    
-    if (o_ != o) {
+    out = lvt_mod(out, modulo);
+    if (out != lvt_mod(Plaintext(out_), modulo)) {
         error("Reconstruct_interact error");
     }
-    out.assign(o_);
     return out;
 }
 
@@ -1863,10 +1747,7 @@ Plaintext LVT<IO>::Reconstruct_easy(Plaintext input, ELGL<IO>* elgl, MPIOChannel
             out += tmp;
         }
     }
-    mcl::Vint o_ = out.get_message().getMpz();
-    o_ %= modulo;
-    out.assign(o_);
-    return out;
+    return lvt_mod(out, modulo);
 }
 
 template <typename IO>
@@ -1874,7 +1755,7 @@ LVT<IO>::~LVT(){
 }
 
 template <typename IO>
-std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m, LVT<IO>* lvt
+std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m, LVT<IO>* lvt
 ) {
     size_t batch_size = c_batch.size();
     if (batch_size == 0) return {};
@@ -1925,17 +1806,15 @@ std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, co
     for (auto& fut : compute_futures) fut.get();
     compute_futures.clear();
     std::stringstream batch_commits, batch_responses;
-    batch_commits << batch_size << "|";
-    batch_responses << batch_size << "|";
+    uint32_t batch_size_u32 = batch_size;
+    batch_commits.write((const char*)&batch_size_u32, sizeof(batch_size_u32));
+    batch_responses.write((const char*)&batch_size_u32, sizeof(batch_size_u32));
     for (size_t i = 0; i < batch_size; ++i) {
-        batch_commits << commits[i].length() << "|" << commits[i];
-        batch_responses << responses[i].length() << "|" << responses[i];
-    }
-    std::stringstream commit_b64, response_b64;
-    commit_b64 << base64_encode(batch_commits.str());
-    response_b64 << base64_encode(batch_responses.str());
-    elgl->serialize_sendall_(commit_b64);
-    elgl->serialize_sendall_(response_b64);
+        write_frame(batch_commits, commits[i]);
+        write_frame(batch_responses, responses[i]);
+    }
+    elgl->serialize_sendall_(batch_commits);
+    elgl->serialize_sendall_(batch_responses);
     std::vector<std::future<void>> verify_futures;
     std::mutex ask_parts_mutex;
     for (int i = 1; i <= num_party; ++i) {
@@ -1945,14 +1824,10 @@ std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, co
                     std::stringstream local_commit_stream, local_response_stream;
                     elgl->deserialize_recv_(local_commit_stream, i);
                     elgl->deserialize_recv_(local_response_stream, i);
-                    std::string comm_raw = base64_decode(local_commit_stream.str());
-                    std::string resp_raw = base64_decode(local_response_stream.str());
-                    std::stringstream comm_stream(comm_raw), resp_stream(resp_raw);
-                    size_t received_batch_size;
-                    char delimiter;
-                    comm_stream >> received_batch_size >> delimiter;
-                    resp_stream >> received_batch_size >> delimiter;
-                    if (received_batch_size != batch_size) {
+                    uint32_t comm_batch_size = 0, resp_batch_size = 0;
+                    local_commit_stream.read((char*)&comm_batch_size, sizeof(comm_batch_size));
+                    local_response_stream.read((char*)&resp_batch_size, sizeof(resp_batch_size));
+                    if (comm_batch_size != batch_size || resp_batch_size != batch_size) {
                         throw std::runtime_error("Batch size mismatch from party " + std::to_string(i));
                     }
                     std::vector<BLS12381Element> batch_ask_i(batch_size);
@@ -1960,12 +1835,9 @@ std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, co
                     ExpVerifier exp_verifier(local_exp_proof);
                     BLS12381Element y1_other = user_pks[i - 1].get_pk();
                     for (size_t j = 0; j < batch_size; ++j) {
-                        size_t comm_len, resp_len;
-                        comm_stream >> comm_len >> delimiter;
-                        resp_stream >> resp_len >> delimiter;
-                        std::string single_commit(comm_len, '\0'), single_response(resp_len, '\0');
-                        comm_stream.read(&single_commit[0], comm_len);
-                        resp_stream.read(&single_response[0], resp_len);
+                        std::string single_commit, single_response;
+                        read_frame(local_commit_stream, single_commit);
+                        read_frame(local_response_stream, single_response);
                         std::stringstream single_comm_stream(single_commit), single_resp_stream(single_response);
                         BLS12381Element g1 = c_batch[j].get_c0();
                         BLS12381Element ask_i;
@@ -1986,6 +1858,8 @@ std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, co
     for (auto& fut : verify_futures) fut.get();
     verify_futures.clear();
     std::vector<Fr> results(batch_size);
+    std::vector<BLS12381Element> pi_asks(batch_size);
+    std::vector<int64_t> ms(batch_size, -1);
     for (size_t t = 0; t < num_threads; ++t) {
         size_t start = t * block_size;
         size_t end = std::min(start + block_size, batch_size);
@@ -1996,19 +1870,32 @@ std::vector<Fr> thdcp_batch(std::vector<Ciphertext>& c_batch, ELGL<IO>* elgl, co
                     for (const auto& ask_i : ask_parts_batch[i]) {
                         pi_ask -= ask_i;
                     }
-                    std::string key = pi_ask.getPoint().getStr();
-                    Fr y = 0;
-                    results[i] = y;
+                    pi_asks[i] = pi_ask;
+                    if (!P_to_m.empty()) ms[i] = P_to_m.find(pi_ask);
                 }
             }));
         }
     }
     for (auto& fut : compute_futures) fut.get();
+
+    std::vector<size_t> miss;
+    std::vector<BLS12381Element> miss_ys;
+    for (size_t i = 0; i < batch_size; ++i) {
+        if (ms[i] < 0) {
+            miss.push_back(i);
+            miss_ys.push_back(pi_asks[i]);
+        }
+    }
+    if (!miss.empty()) {
+        std::vector<int64_t> solved = lvt->bsgs.solve_batch(miss_ys, pool, thread_num);
+        for (size_t k = 0; k < miss.size(); ++k) ms[miss[k]] = solved[k];
+    }
+    for (size_t i = 0; i < batch_size; ++i) results[i] = Fr(ms[i]);
     return results;
 }
 
 template <typename IO>
-vector<BLS12381Element> thdcp__batch(vector<Ciphertext>& c_batch, ELGL<IO>* elgl,const ELGL_PK& global_pk,const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m
+vector<BLS12381Element> thdcp__batch(vector<Ciphertext>& c_batch, ELGL<IO>* elgl,const ELGL_PK& global_pk,const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m
 ) {
     size_t batch_size = c_batch.size();
     if (batch_size == 0) return {};
@@ -2052,13 +1939,11 @@ vector<BLS12381Element> thdcp__batch(vector<Ciphertext>& c_batch, ELGL<IO>* elgl
     for (int p = 1; p <= num_party; p++) {
         if (p != party) {
             recv_futures.push_back(pool->enqueue([p, batch_size, io, &ask_parts_batch, &parts_mutex]() {
-                int recv_size;
-                void* recv_data = io->recv_data(p, recv_size);
+                MsgView msg = io->recv_view(p);
                 
-                if (recv_data) {
+                if (!msg.empty()) {
                     try {
-                        std::stringstream recv_ss;
-                        recv_ss.write(static_cast<char*>(recv_data), recv_size);
+                        cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
                         
                         std::vector<BLS12381Element> received_asks(batch_size);
                         for (size_t i = 0; i < batch_size; i++) {
@@ -2071,7 +1956,6 @@ vector<BLS12381Element> thdcp__batch(vector<Ciphertext>& c_batch, ELGL<IO>* elgl
                     } catch (const std::exception& e) {
                         std::cerr << "Error processing received data: " << e.what() << std::endl;
                     }
-                    free(recv_data);
                 }
             }));
         }
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "emp-aby/lvt.h"
+#include "emp-aby/lvt_state.hpp"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace emp {
+
+// On-disk pool: this header, padded to header_size, then count records of
+// record_size bytes. Checksums are lvt_state_checksum over the header (with
+// header_checksum zeroed) and over all records.
+struct LutPoolHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t num_party;
+    uint32_t party;
+    uint64_t su;
+    uint64_t count;
+    uint64_t record_size;
+    uint8_t global_pk[LVT_POINT_BYTES];
+    uint64_t body_checksum;
+    uint64_t header_checksum;
+};
+
+static const char LUT_POOL_MAGIC[8] = {'L', 'U', 'T', 'P', 'O', 'O', 'L', '\0'};
+static const uint32_t LUT_POOL_VERSION = 1;
+static const uint32_t LUT_POOL_HEADER_SIZE = 128;
+static_assert(sizeof(LutPoolHeader) <= LUT_POOL_HEADER_SIZE, "LUT pool header outgrew its slot");
+
+// Rotated table instances of one LVT, generated ahead of the online phase.
+// next() installs a fresh instance into the LVT for each use.
+//
+// Instances come either from fill(), which runs the generation protocol on
+// the LVT's own channel (offline phase), or from a background producer
+// started with start() on a dedicated channel. Which instances are due
+// depends only on how many have been used: instance n is due once
+// n < capacity + floor(used / refill) * refill, where
+// refill = capacity - low_watermark. Every party therefore generates the
+// same instances in the same order, as long as all parties make the same
+// sequence of next() calls.
+template <typename IO>
+class LutPool {
+public:
+    LutPool(LVT<IO>* lvt, size_t capacity, size_t low_watermark = 0)
+        : lvt(lvt), capacity(std::max<size_t>(1, capacity)),
+          refill(this->capacity - std::min(low_watermark, this->capacity - 1)) {}
+
+    ~LutPool() {
+        try {
+            stop();
+        }
+        catch (...) {
+        }
+    }
+
+    // Generates every due instance on the LVT's channel. All parties must
+    // call this at the same point.
+    void fill() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (producer.joinable())
+                    throw std::runtime_error("LutPool::fill: background producer is running");
+                if (produced >= due())
+                    return;
+            }
+            LutInstance inst;
+            lvt->generate_instance(inst, lvt->elgl, lvt->pool);
+            push(std::move(inst));
+        }
+    }
+
+    // Starts a producer thread that generates instances over prep_io with
+    // its own ELGL handle and thread pool. prep_io must connect the same
+    // parties as the LVT's channel but on separate sockets. Call during
+    // setup: the ELGL constructor re-runs curve initialization.
+    void start(MPIOChannel<IO>* prep_io, int threads = 4) {
+        if (producer.joinable())
+            return;
+        prep_pool.reset(new ThreadPool(threads));
+        prep_elgl.reset(new ELGL<IO>(lvt->num_party, prep_io, prep_pool.get(), lvt->party, -1, false));
+        prep_elgl->kp = lvt->elgl->kp;
+        stopping = false;
+        producer = std::thread([this]() { this->produce(); });
+    }
+
+    // Finishes the instances that are already due, then joins the producer.
+    void stop() {
+        if (!producer.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        producer.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // Installs the next instance into the LVT. Without a producer an empty
+    // pool is refilled in place, on the LVT's channel.
+    void next() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (ready.empty() && !producer.joinable()) {
+            lock.unlock();
+            fill();
+            lock.lock();
+        }
+        cv.wait(lock, [this] { return !ready.empty() || error; });
+        if (ready.empty())
+            std::rethrow_exception(error);
+        LutInstance inst = std::move(ready.front());
+        ready.pop_front();
+        ++used;
+        lock.unlock();
+        cv.notify_all();
+        lvt->use_instance(std::move(inst));
+    }
+
+    size_t available() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return ready.size();
+    }
+
+    size_t consumed() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return used;
+    }
+
+    // Unused instances, tagged with global_pk so they are never loaded under
+    // different keys. Every party saves and loads its own file, in the
+    // LutPoolHeader format below.
+    void save(const std::string& filename) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        const size_t rec = record_size();
+        std::vector<uint8_t> body(ready.size() * rec);
+        size_t k = 0;
+        for (auto& inst : ready)
+            encode(inst, body.data() + rec * k++);
+
+        LutPoolHeader h = {};
+        memcpy(h.magic, LUT_POOL_MAGIC, sizeof(h.magic));
+        h.version = LUT_POOL_VERSION;
+        h.header_size = LUT_POOL_HEADER_SIZE;
+        h.num_party = lvt->num_party;
+        h.party = lvt->party;
+        h.su = lvt->su;
+        h.count = ready.size();
+        h.record_size = rec;
+        lvt_put_point(h.global_pk, lvt->global_pk.get_pk().getPoint());
+        h.body_checksum = lvt_state_checksum(body.data(), body.size());
+        h.header_checksum = lvt_state_checksum(&h, sizeof(h));
+
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) throw std::runtime_error("Failed to open file for writing");
+        char raw[LUT_POOL_HEADER_SIZE] = {0};
+        memcpy(raw, &h, sizeof(h));
+        out.write(raw, LUT_POOL_HEADER_SIZE);
+        out.write(reinterpret_cast<const char*>(body.data()), body.size());
+        if (!out) throw std::runtime_error("LutPool::save: write failed");
+    }
+
+    // Replaces the pool contents; the loaded instances count as produced.
+    // Files that fail any check are refused and the pool is left as it was.
+    void load(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Failed to open file for reading");
+        uint64_t len = in.tellg();
+        in.seekg(0);
+        if (len < LUT_POOL_HEADER_SIZE) throw std::runtime_error("LutPool::load: not a LUT pool file");
+        LutPoolHeader h;
+        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        uint64_t header_checksum = h.header_checksum;
+        h.header_checksum = 0;
+        if (!in || memcmp(h.magic, LUT_POOL_MAGIC, sizeof(h.magic)) != 0 || h.version != LUT_POOL_VERSION ||
+            h.header_size != LUT_POOL_HEADER_SIZE || lvt_state_checksum(&h, sizeof(h)) != header_checksum)
+            throw std::runtime_error("LutPool::load: not a LUT pool file");
+        if (h.num_party != (uint32_t)lvt->num_party || h.party != (uint32_t)lvt->party || h.su != lvt->su ||
+            h.record_size != record_size() || lvt_get_point(h.global_pk) != lvt->global_pk.get_pk())
+            throw std::runtime_error("LutPool::load: file does not match this LVT");
+        if (len - LUT_POOL_HEADER_SIZE != h.count * h.record_size)
+            throw std::runtime_error("LutPool::load: truncated file");
+        std::vector<uint8_t> body(h.count * h.record_size);
+        in.seekg(LUT_POOL_HEADER_SIZE);
+        in.read(reinterpret_cast<char*>(body.data()), body.size());
+        if (!in || lvt_state_checksum(body.data(), body.size()) != h.body_checksum)
+            throw std::runtime_error("LutPool::load: checksum mismatch");
+        std::deque<LutInstance> loaded(h.count);
+        size_t k = 0;
+        for (auto& inst : loaded)
+            decode(inst, body.data() + h.record_size * k++);
+        std::lock_guard<std::mutex> lock(mtx);
+        if (producer.joinable())
+            throw std::runtime_error("LutPool::load: background producer is running");
+        ready    = std::move(loaded);
+        used     = 0;
+        produced = ready.size();
+    }
+
+private:
+    size_t due() const { return capacity + used / refill * refill; }
+
+    // One instance: rotation, lut_share[su], cip_lut[num_party][su] and
+    // cr_i[num_party] (c0, c1), with the lvt_state encodings.
+    size_t record_size() const {
+        return (1 + lvt->su) * LVT_FR_BYTES + (lvt->num_party * lvt->su + 2 * lvt->num_party) * LVT_POINT_BYTES;
+    }
+
+    void encode(const LutInstance& inst, uint8_t* out) const {
+        const size_t su = lvt->su, np = lvt->num_party;
+        lvt_put_fr(out, inst.rotation.get_message());
+        uint8_t* shares = out + LVT_FR_BYTES;
+        uint8_t* points = shares + su * LVT_FR_BYTES;
+        emp::parallel_for(lvt->pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; ++i)
+                lvt_put_fr(shares + i * LVT_FR_BYTES, inst.lut_share[i].get_message());
+        });
+        for (size_t p = 0; p < np; ++p)
+            inst.cip_lut.encode_row(p, points + p * su * LVT_POINT_BYTES, lvt->pool);
+        uint8_t* cr = points + np * su * LVT_POINT_BYTES;
+        for (size_t p = 0; p < np; ++p) {
+            lvt_put_point(cr + 2 * p * LVT_POINT_BYTES, inst.cr_i[p].get_c0().getPoint());
+            lvt_put_point(cr + (2 * p + 1) * LVT_POINT_BYTES, inst.cr_i[p].get_c1().getPoint());
+        }
+    }
+
+    void decode(LutInstance& inst, const uint8_t* in) const {
+        const size_t su = lvt->su, np = lvt->num_party;
+        inst.rotation.set_message(lvt_get_fr(in));
+        const uint8_t* shares = in + LVT_FR_BYTES;
+        const uint8_t* points = shares + su * LVT_FR_BYTES;
+        inst.lut_share.resize(su);
+        emp::parallel_for(lvt->pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; ++i)
+                inst.lut_share[i].set_message(lvt_get_fr(shares + i * LVT_FR_BYTES));
+        });
+        inst.cip_lut.reset(np, su, lvt->cip_layout);
+        for (size_t p = 0; p < np; ++p)
+            inst.cip_lut.decode_row(p, points + p * su * LVT_POINT_BYTES, lvt->pool);
+        const uint8_t* cr = points + np * su * LVT_POINT_BYTES;
+        inst.cr_i.resize(np);
+        for (size_t p = 0; p < np; ++p)
+            inst.cr_i[p] = Ciphertext(lvt_get_point(cr + 2 * p * LVT_POINT_BYTES),
+                                      lvt_get_point(cr + (2 * p + 1) * LVT_POINT_BYTES));
+    }
+
+    void push(LutInstance&& inst) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ready.push_back(std::move(inst));
+            ++produced;
+        }
+        cv.notify_all();
+    }
+
+    void produce() {
+        try {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this] { return produced < due() || stopping; });
+                    if (produced >= due())
+                        return;
+                }
+                LutInstance inst;
+                lvt->generate_instance(inst, prep_elgl.get(), prep_pool.get());
+                push(std::move(inst));
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            error = std::current_exception();
+            cv.notify_all();
+        }
+    }
+
+    LVT<IO>* lvt;
+    size_t capacity, refill;
+    size_t produced = 0, used = 0;
+    std::deque<LutInstance> ready;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::exception_ptr error;
+    std::unique_ptr<ThreadPool> prep_pool;
+    std::unique_ptr<ELGL<IO>> prep_elgl;
+    std::thread producer;
+};
+
+}  // namespace emp
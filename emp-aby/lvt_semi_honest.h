@@ -73,7 +73,7 @@ class LVT{
     vector<Plaintext> lut_share;
     vector<vector<BLS12381Element>> cip_lut;
     emp::BSGSPrecomputation bsgs;
-    std::map<std::string, Fr> P_to_m;
+    SmallDlogIndex P_to_m;
     BLS12381Element g;
     
     int num_party;
@@ -84,6 +84,7 @@ class LVT{
     static void initialize(std::string name, LVT<IO>*& lvt_ptr_ref, int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha_fr, int table_size, int m_bits);
     static void initialize_batch(std::string name, LVT<IO>*& lvt_ptr_ref, int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, ELGL<IO>* elgl, Fr& alpha_fr, int table_size, int m_bits);
     ELGL_PK DistKeyGen(bool offline);
+    void precompute_keys();
     ~LVT();
     void generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table);
     void generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation, vector<int64_t> table);
@@ -254,6 +255,7 @@ void LVT<IO>::load_full_state(const std::string& filename) {
     g.point = g_point;
 
     in.close();
+    precompute_keys();
 }
 
 
@@ -326,41 +328,7 @@ LVT<IO>::LVT(int num_party, int party, MPIOChannel<IO>* io, ThreadPool* pool, EL
         out.close();
     }
     // if (m_bits <= 14) {
-        if (fs::exists(p_to_m_cache)) {
-            std::ifstream in(p_to_m_cache, std::ios::binary);
-            if (!in) throw std::runtime_error("Failed to open P_to_m cache");
-            
-            size_t size;
-            in.read(reinterpret_cast<char*>(&size), sizeof(size_t));
-            P_to_m.clear();
-            
-            for (size_t i = 0; i < size; ++i) {
-                size_t key_len;
-                in.read(reinterpret_cast<char*>(&key_len), sizeof(size_t));
-                std::string key(key_len, '\0');
-                in.read(&key[0], key_len);
-                
-                Fr value;
-                in.read(reinterpret_cast<char*>(&value), sizeof(Fr));
-                P_to_m[key] = value;
-            }
-            in.close();
-        } else {
-            build_safe_P_to_m(P_to_m, 2 * su * num_party);
-            std::ofstream out(p_to_m_cache, std::ios::binary);
-            if (!out) throw std::runtime_error("Failed to create P_to_m cache");
-            
-            size_t size = P_to_m.size();
-            out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-            
-            for (const auto& pair : P_to_m) {
-                size_t key_len = pair.first.length();
-                out.write(reinterpret_cast<const char*>(&key_len), sizeof(size_t));
-                out.write(pair.first.c_str(), key_len);
-                out.write(reinterpret_cast<const char*>(&pair.second), sizeof(Fr));
-            }
-            out.close();
-        }
+        load_or_build_P_to_m(P_to_m, 2 * su * num_party, p_to_m_cache);
     // }
     uint64_t N = 1ULL << 32;
     if (fs::exists(bsgs_cache)) {
@@ -416,22 +384,12 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         for(size_t i = 0; i < su; i++){
             r1[i].set_random();
             c0[i] = BLS12381Element(r1[i].get_message());
-            c1[i] =  global_pk.get_pk() * r1[i].get_message() + BLS12381Element(x[i].get_message());
+            c1[i] =  global_pk.pk_mul(r1[i].get_message()) + BLS12381Element(x[i].get_message());
         }
    
         // DFT
-        res.push_back(pool->enqueue(
-            [this, &c0, &ak, N]()
-            {
-                FFT_Para(c0, ak, this->alpha, N);     
-            }
-        ));
-        res.push_back(pool->enqueue(
-            [this, &c1, &bk, N]()
-            {
-                FFT_Para(c1, bk, this->alpha, N);
-            }
-        ));
+        FFT_Para(c0, ak, this->alpha, N, pool);
+        FFT_Para(c1, bk, this->alpha, N, pool);
         for (auto& f : res) {
             f.get();
         }
@@ -459,7 +417,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                     dk[i] = BLS12381Element(1) * sk[i].get_message();
                     dk[i] += ak[i] * betak_.get_message();
                     // e_k = bk ^ betak * h^sk
-                    ek[i] = global_pk.get_pk() * sk[i].get_message();
+                    ek[i] = global_pk.pk_mul(sk[i].get_message());
                     ek[i] += bk[i] * betak_.get_message();
                 }
             ));
@@ -476,7 +434,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             ek[j].pack(commit_ro);
         }
         std::string comm_raw = commit_ro.str();
-        comm_ro_ << base64_encode(comm_raw);
+        comm_ro_ << comm_raw;
         // elgl->serialize_sendall_(comm_ro_);
         elgl->serialize_sendp2p(comm_ro_, party + 1);
     }
@@ -497,7 +455,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         std::stringstream comm_;
         elgl->deserialize_recv_(comm_ro, party - 1);
         comm_raw = comm_ro.str();
-        comm_ << base64_decode(comm_raw);
+        comm_ << comm_raw;
         for (size_t j = 0; j < su; j++)
         {
             dk_thread[j].unpack(comm_);
@@ -528,7 +486,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                         ek_[i] = ek_thread[i] * betak.get_message();
                         sk[i].set_random();
                         dk_[i] += BLS12381Element(sk[i].get_message());
-                        ek_[i] += global_pk.get_pk() * sk[i].get_message();
+                        ek_[i] += global_pk.pk_mul(sk[i].get_message());
                     }
                 ));
             }
@@ -546,7 +504,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             std::stringstream comm_ro_final; 
             std::string comm_raw_final;
             comm_raw_final = commit_ro.str();
-            comm_ro_final << base64_encode(comm_raw_final);         
+            comm_ro_final << comm_raw_final;         
 
             // elgl->serialize_sendall_(comm_ro_final);
             elgl->serialize_sendp2p(comm_ro_final, party + 1);
@@ -573,7 +531,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         std::stringstream comm_;
         elgl->deserialize_recv_(comm_ro, party - 1);
         comm_raw = comm_ro.str();
-        comm_ << base64_decode(comm_raw);
+        comm_ << comm_raw;
         for (size_t j = 0; j < su; j++)
         {
             dk_thread[j].unpack(comm_);
@@ -604,7 +562,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                         ek_[i] = ek_thread[i] * betak.get_message();
                         sk[i].set_random();
                         dk_[i] += BLS12381Element(sk[i].get_message());
-                        ek_[i] += global_pk.get_pk() * sk[i].get_message();
+                        ek_[i] += global_pk.pk_mul(sk[i].get_message());
                     }
                 ));
             }
@@ -620,33 +578,19 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             alpha_inv.assign(alpha_inv_.getMpz());
             Fr N_inv;
             Fr::inv(N_inv, N);
-            res.push_back(pool->enqueue(
-                [this, &dk_, &c0_, &N, &alpha_inv]()
-                {
-                    FFT_Para(dk_, c0_, alpha_inv.get_message(), N);
-                }
-            ));
-            res.push_back(pool->enqueue(
-                [this, &ek_, &c1_, &N, &alpha_inv]()
-                {
-                    FFT_Para(ek_, c1_, alpha_inv.get_message(), N);
-                }
-            ));
+            FFT_Para(dk_, c0_, alpha_inv.get_message(), N, pool);
+            FFT_Para(ek_, c1_, alpha_inv.get_message(), N, pool);
             for (auto& f : res) {
                 f.get();
             }
             res.clear();
 
-            for (size_t i = 0; i < su; i++) {
-                res.push_back(pool->enqueue([&c0_, &c1_, &N_inv, i]() {
+            emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+                for (size_t i = l; i < r; i++) {
                     c0_[i] *= N_inv;
                     c1_[i] *= N_inv;
-                }));
-            }
-            for (auto& f : res) {
-                f.get();
-            }
-            res.clear();
+                }
+            });
 
 
             std::stringstream commit_ro;
@@ -658,7 +602,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             std::stringstream comm_ro_final; 
             std::string comm_raw_final;
             comm_raw_final = commit_ro.str();
-            comm_ro_final << base64_encode(comm_raw_final);         
+            comm_ro_final << comm_raw_final;         
 
             elgl->serialize_sendall_(comm_ro_final);
     }
@@ -671,7 +615,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         // elgl->deserialize_recv_(comm_ro, num_party);
         elgl->deserialize_recv_(comm_ro, num_party);
         comm_raw = comm_ro.str();
-        comm_ << base64_decode(comm_raw);
+        comm_ << comm_raw;
 
         for (size_t j = 0; j < su; j++)
         {
@@ -703,7 +647,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             // time 
             elgl->deserialize_recv_(commit_ro, i);
             comm_raw = commit_ro.str();
-            comm_ << base64_decode(comm_raw);
+            comm_ << comm_raw;
             
             BLS12381Element pk__ = user_pk[i-1].get_pk();
             for (int j = 0; j < su; j++){
@@ -718,15 +662,10 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             cip_lut[i-1] = y3;
         }
         
-        for (size_t i = 0; i < su; i++){
-            res.push_back(pool->enqueue([&c1_, &l_alice, i]() {
+        emp::parallel_for(pool, 0, su, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++)
                 l_alice[i] += c1_[i];
-            }));
-        }
-        for (auto& f : res) {
-            f.get();
-        }
-        res.clear();
+        });
 
         cip_lut[0].resize(su);
         bool flag = 0; 
@@ -736,12 +675,12 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                 Y.getPoint().normalize();
                 Fr y; 
                 if(flag) {
-                    auto it = this->P_to_m.find(Y.getPoint().getStr());
-                    if (it == this->P_to_m.end()) {
+                    int64_t m = this->P_to_m.find(Y);
+                    if (m < 0) {
                         std::cerr << "[Error] y not found in P_to_m! y = " << Y.getPoint().getStr() << std::endl;
                         exit(1);
                     } else {
-                        y = it->second;
+                        y = Fr(m);
                     }
                 } else 
                 {   
@@ -767,7 +706,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
 
         std::stringstream commit_ss;
         std::string commit_raw;
-        std::stringstream commit_b64_;
+        std::stringstream commit_out_;
         
         // time prove
         for (unsigned int j = 0; j < su; ++j) {
@@ -776,8 +715,8 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         }   
 
         commit_raw = commit_ss.str();
-        commit_b64_ << base64_encode(commit_raw);
-        elgl->serialize_sendall_(commit_b64_);
+        commit_out_ << commit_raw;
+        elgl->serialize_sendall_(commit_out_);
 
         for (size_t i = 2; i <= num_party; i++)
          {
@@ -806,7 +745,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
             l_1_v[i] = l_1;  
 
             cip_ = BLS12381Element(lut_share[i].get_message());
-            cip_ += this->global_pk.get_pk() * this->elgl->kp.get_sk().get_sk();
+            cip_ += this->global_pk.pk_mul(this->elgl->kp.get_sk().get_sk());
             cip_v[i] = cip_;  
         }
         cip_lut[party-1] = cip_v;
@@ -818,7 +757,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
 
         std::stringstream commit_ra_;
         std::string commit_raw = commit_ss.str();
-        commit_ra_ << base64_encode(commit_raw);
+        commit_ra_ << commit_raw;
         // sendall
         elgl->serialize_sendall_(commit_ra_);
         // elgl->serialize_sendp2p(commit_ra_, ALICE);
@@ -836,7 +775,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
                 std::stringstream comm_;
                 elgl->deserialize_recv_(commit_ro, i);
                 comm_raw = commit_ro.str();
-                comm_ << base64_decode(comm_raw);
+                comm_ << comm_raw;
                 BLS12381Element pk__ = user_pk[i-1].get_pk();
                 for (int j = 0; j < su; j++){
                     y2[j].unpack(comm_);
@@ -851,7 +790,7 @@ void LVT<IO>::generate_shares(vector<Plaintext>& lut_share, Plaintext& rotation,
         std::stringstream comm_;
         elgl->deserialize_recv_(commit_ro, ALICE);
         comm_raw_ = commit_ro.str();
-        comm_ << base64_decode(comm_raw_);
+        comm_ << comm_raw_;
         vector<BLS12381Element> y2;
         vector<BLS12381Element> y3;
         y2.resize(su);
@@ -880,6 +819,7 @@ void LVT<IO>::generate_shares_(vector<Plaintext>& lut_share, Plaintext& rotation
     BLS12381Element tmp = BLS12381Element(0);
     this->global_pk.assign_pk(tmp);
     for (int p = 0; p < num_party; ++p) user_pk[p].assign_pk(tmp);
+    precompute_keys();
     BLS12381Element pk = this->global_pk.get_pk(); 
     BLS12381Element G = tmp;
     size_t tnum = std::max<size_t>(1, thread_num);
@@ -990,11 +930,22 @@ ELGL_PK LVT<IO>::DistKeyGen(bool offline) {
             }
         }
     }
+    precompute_keys();
     return global_pk;
 }
 
+// Fixed-base tables for global_pk and every user_pk; copies share them.
+template <typename IO>
+void LVT<IO>::precompute_keys() {
+    global_pk.precompute();
+    emp::parallel_for(pool, 0, user_pk.size(), [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++)
+            user_pk[i].precompute();
+    }, 1);
+}
+
 template <typename IO>
-Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m, LVT<IO>* lvt) {
+Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m, LVT<IO>* lvt) {
     Plaintext sk(elgl->kp.get_sk().get_sk());
     BLS12381Element ask = c.get_c0() * sk.get_message();
     std::vector<BLS12381Element> ask_parts(num_party);
@@ -1009,12 +960,8 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
     BLS12381Element y1 = user_pks[party-1].get_pk();
     exp_prover.NIZKPoK(exp_proof, commit, response, g1, y1, ask, sk, party, pool);
 
-    std::stringstream commit_b64, response_b64;
-    commit_b64 << base64_encode(commit.str());
-    response_b64 << base64_encode(response.str());
-
-    elgl->serialize_sendall_(commit_b64);
-    elgl->serialize_sendall_(response_b64);
+    elgl->serialize_sendall_(commit);
+    elgl->serialize_sendall_(response);
     std::vector<std::future<void>> verify_futures;
     for (int i = 1; i <= num_party; ++i) {
         if (i != party) {
@@ -1025,19 +972,6 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
                 elgl->deserialize_recv_(local_commit_stream, i);
                 elgl->deserialize_recv_(local_response_stream, i);
 
-                std::string comm_raw = local_commit_stream.str();
-                std::string resp_raw = local_response_stream.str();
-
-                local_commit_stream.str("");
-                local_commit_stream.clear();
-                local_commit_stream << base64_decode(comm_raw);
-                local_commit_stream.seekg(0);
-
-                local_response_stream.str("");
-                local_response_stream.clear();
-                local_response_stream << base64_decode(resp_raw);
-                local_response_stream.seekg(0);
-
                 BLS12381Element y1_other = user_pks[i - 1].get_pk();
                 BLS12381Element ask_i;
                 ExpVerifier exp_verifier(exp_proof);
@@ -1055,15 +989,10 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
         pi_ask -= ask_i;
     }
 
-    std::string key = pi_ask.getPoint().getStr();
     Fr y;
     if(lvt->ad <= 131072) {
-        auto it = P_to_m.find(key);
-        bool t = 1;
-        if (it == P_to_m.end()) {
-            t = 0;
-        }
-        if (t) return it->second;
+        int64_t m = P_to_m.find(pi_ask);
+        if (m >= 0) return Fr(m);
     } 
     cout << "lvt->bsgs.solve_parallel_with_pool" << endl;
     y = lvt->bsgs.solve_parallel_with_pool(pi_ask, pool, thread_num);
@@ -1073,7 +1002,7 @@ Fr thdcp(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vec
 
 
 template <typename IO>
-BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, std::map<std::string, Fr>& P_to_m, LVT<IO>* lvt) {
+BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk, const std::vector<ELGL_PK>& user_pks, MPIOChannel<IO>* io, ThreadPool* pool, int party, int num_party, SmallDlogIndex& P_to_m, LVT<IO>* lvt) {
     Plaintext sk(elgl->kp.get_sk().get_sk());
     BLS12381Element ask = c.get_c0() * sk.get_message();
     std::vector<BLS12381Element> ask_parts(num_party);
@@ -1088,12 +1017,8 @@ BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk,
     BLS12381Element y1 = user_pks[party-1].get_pk();
     exp_prover.NIZKPoK(exp_proof, commit, response, g1, y1, ask, sk, party, pool);
 
-    std::stringstream commit_b64, response_b64;
-    commit_b64 << base64_encode(commit.str());
-    response_b64 << base64_encode(response.str());
-
-    elgl->serialize_sendall_(commit_b64);
-    elgl->serialize_sendall_(response_b64);
+    elgl->serialize_sendall_(commit);
+    elgl->serialize_sendall_(response);
 
     std::vector<std::future<void>> verify_futures;
     for (int i = 1; i <= num_party; ++i) {
@@ -1105,19 +1030,6 @@ BLS12381Element thdcp_(Ciphertext& c, ELGL<IO>* elgl, const ELGL_PK& global_pk,
                 elgl->deserialize_recv_(local_commit_stream, i);
                 elgl->deserialize_recv_(local_response_stream, i);
 
-                std::string comm_raw = local_commit_stream.str();
-                std::string resp_raw = local_response_stream.str();
-
-                local_commit_stream.str("");
-                local_commit_stream.clear();
-                local_commit_stream << base64_decode(comm_raw);
-                local_commit_stream.seekg(0);
-
-                local_response_stream.str("");
-                local_response_stream.clear();
-                local_response_stream << base64_decode(resp_raw);
-                local_response_stream.seekg(0);
-
                 BLS12381Element y1_other = user_pks[i - 1].get_pk();
                 BLS12381Element ask_i;
                 ExpVerifier exp_verifier(exp_proof);
@@ -1237,8 +1149,8 @@ LVT<IO>::lookup_online_batch(vector<Plaintext>& x_share)
 
         recv_futs.emplace_back(
             pool->enqueue([&, p]() {
-                std::stringstream recv_ss;
-                elgl->deserialize_recv_(recv_ss, p);
+                MsgView msg = elgl->deserialize_recv_view(p);
+                cybozu::MemoryInputStream recv_ss(msg.data(), msg.size());
                 auto& tmp = recv_results[p - 1];
                 tmp.resize(x_size);
                 for (size_t i = 0; i < x_size; ++i)
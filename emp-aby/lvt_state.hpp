@@ -0,0 +1,153 @@
+#pragma once
+#include "libelgl/elgl/BLS12381Element.h"
+#include "emp-aby/BSGS.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+
+namespace emp {
+
+// On-disk LVT state: this header, padded to header_size, then one section
+// per LvtStateSection at 64-byte aligned offsets (cip_lut page aligned).
+// Scalars are canonical 32-byte Fr encodings and points are 48-byte
+// compressed G1 encodings, so files do not depend on mcl's in-memory form.
+// The header also carries global_pk, so a state can be checked against a
+// context's key before anything is decoded.
+//   SCALARS    rotation, sk, alpha
+//   POINTS     G_tbs, g, global_pk, user_pk[num_party], cr_i[num_party] (c0, c1)
+//   TABLE      int64 table[table_size]
+//   LUT_SHARE  lut_share[su]
+//   CIP_LUT    cip_lut[num_party][su], row-major
+enum LvtStateSection { LVT_SEC_SCALARS, LVT_SEC_POINTS, LVT_SEC_TABLE, LVT_SEC_LUT_SHARE, LVT_SEC_CIP_LUT, LVT_SEC_COUNT };
+
+static const size_t LVT_FR_BYTES = 32;
+static const size_t LVT_POINT_BYTES = 48;
+
+struct LvtStateSectionEntry {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+struct LvtStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t num_party;
+    uint32_t party;
+    uint64_t su;
+    uint64_t ad;
+    uint64_t table_size;
+    LvtStateSectionEntry sections[LVT_SEC_COUNT];
+    uint8_t global_pk[LVT_POINT_BYTES];
+    uint64_t header_checksum;
+};
+
+static const char LVT_STATE_MAGIC[8] = {'L', 'V', 'T', 'S', 'T', 'A', 'T', '\0'};
+static const uint32_t LVT_STATE_VERSION = 2;
+static const uint32_t LVT_STATE_HEADER_SIZE = 256;
+static_assert(sizeof(LvtStateHeader) <= LVT_STATE_HEADER_SIZE, "LVT state header outgrew its slot");
+
+// 64-bit multiply-xorshift checksum over 8-byte words; detects corruption
+// and truncation, not tampering.
+inline uint64_t lvt_state_checksum(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    uint64_t w = 0;
+    memcpy(&w, p + i, len - i);
+    h = (h ^ w) * 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 29);
+}
+
+inline void lvt_put_fr(uint8_t* out, const Fr& x) {
+    if (x.serialize(out, LVT_FR_BYTES) != LVT_FR_BYTES)
+        throw std::runtime_error("LVT state: Fr encoding failed");
+}
+
+inline Fr lvt_get_fr(const uint8_t* in) {
+    Fr x;
+    if (x.deserialize(in, LVT_FR_BYTES) != LVT_FR_BYTES)
+        throw std::runtime_error("LVT state: invalid Fr encoding");
+    return x;
+}
+
+inline void lvt_put_point(uint8_t* out, const G1& P) {
+    if (P.serialize(out, LVT_POINT_BYTES) != LVT_POINT_BYTES)
+        throw std::runtime_error("LVT state: point encoding failed");
+}
+
+inline BLS12381Element lvt_get_point(const uint8_t* in) {
+    BLS12381Element P;
+    if (P.point.deserialize(in, LVT_POINT_BYTES) != LVT_POINT_BYTES)
+        throw std::runtime_error("LVT state: invalid point encoding");
+    return P;
+}
+
+// rows x cols compressed points inside a mapped state file. Entries are
+// decoded on first use and cached; the cache is an anonymous mapping, so
+// neither file nor cache pages are touched until a lookup needs them.
+// at() may be called concurrently.
+class MappedPointTable {
+public:
+    MappedPointTable(void* base, size_t len, const uint8_t* data, size_t rows, size_t cols)
+        : rows(rows), cols(cols), base(base), len(len), data(data) {
+        size_t n = rows * cols;
+        cache_len = n * sizeof(G1) + n;
+        cache = mmap(nullptr, cache_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (cache == MAP_FAILED) {
+            munmap(base, len);
+            throw std::runtime_error("MappedPointTable: mmap failed");
+        }
+        points = static_cast<G1*>(cache);
+        ready = reinterpret_cast<std::atomic<uint8_t>*>(static_cast<char*>(cache) + n * sizeof(G1));
+        madvise(base, len, MADV_RANDOM);
+    }
+    MappedPointTable(const MappedPointTable&) = delete;
+    MappedPointTable& operator=(const MappedPointTable&) = delete;
+    ~MappedPointTable() {
+        munmap(cache, cache_len);
+        munmap(base, len);
+    }
+
+    BLS12381Element at(size_t row, size_t col) const {
+        size_t k = row * cols + col;
+        BLS12381Element out;
+        if (ready[k].load(std::memory_order_acquire) == 2) {
+            out.point = points[k];
+            return out;
+        }
+        out = lvt_get_point(data + k * LVT_POINT_BYTES);
+        uint8_t expected = 0;
+        if (ready[k].compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+            points[k] = out.point;
+            ready[k].store(2, std::memory_order_release);
+        }
+        return out;
+    }
+
+    // Encoded bytes of one row, as stored in the file.
+    const uint8_t* row_bytes(size_t row) const { return data + row * cols * LVT_POINT_BYTES; }
+
+    const size_t rows, cols;
+
+private:
+    void* base;
+    size_t len;
+    const uint8_t* data;
+    void* cache;
+    size_t cache_len;
+    G1* points;
+    std::atomic<uint8_t>* ready;
+};
+
+}  // namespace emp
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "elgl_interface.hpp"
+#include "emp-aby/ring_gemm.hpp"
+#include "emp-aby/triple_store.hpp"
 #include <vector>
 #include <random>
 #include <chrono>
@@ -9,14 +11,29 @@
 #include <mutex>
 #include <condition_variable>
 #include <map>
+#include <array>
 #include <mcl/vint.hpp>
 #include <mcl/fp.hpp>
 
-const mcl::Vint field_size("52435875175126190479447740508185965837690552500527637822603658699938581184512");
+// MASCOT computes in Fr; field_size is its modulus r, for callers that
+// reduce Vints before sharing them.
+const mcl::Vint field_size("52435875175126190479447740508185965837690552500527637822603658699938581184513");
 // const mcl::Vint field_size_2("340282366920938463463374607431768211297");
 // const mcl::Vint field_size(to_string(1ULL << 32));
 namespace emp {
 
+// MASCOT shares as parallel Fr arrays, for the batch operations.
+struct FrShares {
+    std::vector<Fr> value, mac;
+    FrShares() = default;
+    explicit FrShares(size_t n) : value(n), mac(n) {}
+    size_t size() const { return value.size(); }
+    void resize(size_t n) {
+        value.resize(n);
+        mac.resize(n);
+    }
+};
+
 template <typename IO>
 class MASCOT {
 public:
@@ -26,284 +43,468 @@ public:
     std::mutex mtx;
     std::condition_variable cv;
     std::mt19937_64 rng;
-    mcl::Vint mac_key;
+    Fr mac_key;
+    // Runs the local matrix products and batch operations; nullptr keeps
+    // them on the caller.
+    ThreadPool* pool = nullptr;
+
+    static const size_t FR_BYTES = 32;
 
     struct LabeledShare {
-        mcl::Vint value;
-        mcl::Vint mac;
+        Fr value;
+        Fr mac;
         int owner;
-        const mcl::Vint* field_size_ptr; 
 
-        LabeledShare() : value(0), mac(0), owner(0), field_size_ptr(nullptr) {}
-        LabeledShare(const mcl::Vint& v, const mcl::Vint& m, int o, const mcl::Vint* fs) : value(v), mac(m), owner(o), field_size_ptr(fs) {}
+        LabeledShare() : value(0), mac(0), owner(0) {}
+        LabeledShare(const Fr& v, const Fr& m, int o) : value(v), mac(m), owner(o) {}
 
         void pack(std::stringstream& ss) const {
-            ss << value.getStr() << " " << mac.getStr() << " " << owner << " ";
+            write_frs(ss, &value, 1);
+            write_frs(ss, &mac, 1);
         }
 
         void unpack(std::stringstream& ss) {
-            std::string s1, s2;
-            ss >> s1 >> s2 >> owner;
-            value.setStr(s1);
-            mac.setStr(s2);
+            read_frs(ss, &value, 1);
+            read_frs(ss, &mac, 1);
         }
 
         LabeledShare operator+(const LabeledShare& rhs) const {
-            mcl::Vint fs = field_size;
-            mcl::Vint v = ((value + rhs.value) % fs + fs) % fs;
-            mcl::Vint m = ((mac + rhs.mac) % fs + fs) % fs;
-            return LabeledShare(v, m, owner, field_size_ptr);
+            return LabeledShare(value + rhs.value, mac + rhs.mac, owner);
         }
-        LabeledShare operator*(const mcl::Vint& scalar) const {
-            mcl::Vint fs = field_size;
-            mcl::Vint s = scalar % fs;
-            mcl::Vint v = ((value * s) % fs + fs) % fs;
-            mcl::Vint m = ((mac * s) % fs + fs) % fs;
-            return LabeledShare(v, m, owner, field_size_ptr);
+        LabeledShare operator*(const Fr& scalar) const {
+            return LabeledShare(value * scalar, mac * scalar, owner);
         }
     };
     struct Triple {
-        mcl::Vint a, b, c, mac_a, mac_b, mac_c;
+        Fr a, b, c, mac_a, mac_b, mac_c;
         Triple() : a(0), b(0), c(0), mac_a(0), mac_b(0), mac_c(0) {}
-        Triple(const mcl::Vint& a, const mcl::Vint& b, const mcl::Vint& c, const mcl::Vint& mac_a, const mcl::Vint& mac_b, const mcl::Vint& mac_c)
+        Triple(const Fr& a, const Fr& b, const Fr& c, const Fr& mac_a, const Fr& mac_b, const Fr& mac_c)
             : a(a), b(b), c(c), mac_a(mac_a), mac_b(mac_b), mac_c(mac_c) {}
 
         void pack(std::stringstream& ss) const {
-            ss << a.getStr() << " " << b.getStr() << " " << c.getStr() << " "
-               << mac_a.getStr() << " " << mac_b.getStr() << " " << mac_c.getStr() << " ";
+            write_frs(ss, &a, 1); write_frs(ss, &b, 1); write_frs(ss, &c, 1);
+            write_frs(ss, &mac_a, 1); write_frs(ss, &mac_b, 1); write_frs(ss, &mac_c, 1);
         }
 
         void unpack(std::stringstream& ss) {
-            std::string sa, sb, sc, sma, smb, smc;
-            ss >> sa >> sb >> sc >> sma >> smb >> smc;
-            a.setStr(sa); b.setStr(sb); c.setStr(sc);
-            mac_a.setStr(sma); mac_b.setStr(smb); mac_c.setStr(smc);
+            read_frs(ss, &a, 1); read_frs(ss, &b, 1); read_frs(ss, &c, 1);
+            read_frs(ss, &mac_a, 1); read_frs(ss, &mac_b, 1); read_frs(ss, &mac_c, 1);
+        }
+
+        // Triple store record.
+        static const size_t RECORD_BYTES = 6 * FR_BYTES;
+        void encode(uint8_t* out) const {
+            put_frs(out, &a, 1); put_frs(out + FR_BYTES, &b, 1); put_frs(out + 2 * FR_BYTES, &c, 1);
+            put_frs(out + 3 * FR_BYTES, &mac_a, 1); put_frs(out + 4 * FR_BYTES, &mac_b, 1); put_frs(out + 5 * FR_BYTES, &mac_c, 1);
         }
+        static Triple decode(const uint8_t* in) {
+            Triple t;
+            get_frs(in, &t.a, 1); get_frs(in + FR_BYTES, &t.b, 1); get_frs(in + 2 * FR_BYTES, &t.c, 1);
+            get_frs(in + 3 * FR_BYTES, &t.mac_a, 1); get_frs(in + 4 * FR_BYTES, &t.mac_b, 1); get_frs(in + 5 * FR_BYTES, &t.mac_c, 1);
+            return t;
+        }
+    };
+
+    // <A> (m x k), <B> (k x n) and <C> = <AB>, row-major, with macs.
+    struct MatrixTriple {
+        size_t m = 0, k = 0, n = 0;
+        std::vector<Fr> a, b, c, mac_a, mac_b, mac_c;
     };
 
-    std::vector<Triple> triples_pool;
+    TripleSupply<Triple> triples;
+    std::map<std::array<size_t, 3>, std::vector<MatrixTriple>> matrix_triples_pool;
 
     void precompute_triples(size_t num_triples) {
-        for (size_t i = 0; i < num_triples; i++) {
-            generate_triple();
-        }
+        generate_triples(num_triples);
     }
 
     void generate_triple() {
-        mcl::Vint a_local, b_local;
-        a_local.setRand(field_size); a_local %= field_size;
-        b_local.setRand(field_size); b_local %= field_size;
+        generate_triples(1);
+    }
+    // count triples with one message per peer carrying every local a and b.
+    void generate_triples(size_t count) {
+        if (count == 0) return;
+        std::vector<Fr> local(2 * count), full(2 * count), other(2 * count);
+        for (auto& x : local) x.setByCSPRNG();
+        full = local;
         std::stringstream ss;
-        ss << a_local.getStr() << " " << b_local.getStr() << " ";
-        elgl->serialize_sendall_with_tag(ss, 2000 * party + party);
-        mcl::Vint a_full = a_local, b_full = b_local;
+        write_frs(ss, local.data(), local.size());
+        elgl->serialize_sendall_with_tag(ss, 7000 * party + party);
         for (int i = 1; i <= num_parties; ++i) {
             if (i != party) {
                 std::stringstream ss_recv;
-                elgl->deserialize_recv_with_tag(ss_recv, i, 2000 * i + i);
-                std::string sa, sb;
-                mcl::Vint other_a, other_b;
-                ss_recv >> sa >> sb;
-                other_a.setStr(sa); other_b.setStr(sb);
-                a_full += other_a; b_full += other_b;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 7000 * i + i);
+                read_frs(ss_recv, other.data(), other.size());
+                for (size_t j = 0; j < full.size(); ++j) full[j] += other[j];
             }
         }
-        mcl::Vint c_full = a_full * b_full % field_size;
-        mcl::Vint c_local = (party == 1) ? c_full : mcl::Vint(0);
-        mcl::Vint mac_a = a_local * mac_key % field_size;
-        mcl::Vint mac_b = b_local * mac_key % field_size;
-        mcl::Vint mac_c = c_local * mac_key % field_size;
-        triples_pool.emplace_back(a_local, b_local, c_local, mac_a, mac_b, mac_c);
+        for (size_t j = 0; j < count; ++j) {
+            const Fr& a = local[2 * j];
+            const Fr& b = local[2 * j + 1];
+            Fr c = (party == 1) ? full[2 * j] * full[2 * j + 1] : Fr(0);
+            triples.pool.emplace_back(a, b, c, a * mac_key, b * mac_key, c * mac_key);
+        }
     }
 
     Triple get_triple() {
-        if (triples_pool.empty()) {
-            precompute_triples(10);
+        Triple t;
+        triples.take(&t, 1, [this](size_t k) { generate_triples(k); });
+        return t;
+    }
+    // Takes n triples, generating any shortfall in one round.
+    std::vector<Triple> get_triples(size_t n) {
+        std::vector<Triple> out(n);
+        triples.take(out.data(), n, [this](size_t k) { generate_triples(k); });
+        return out;
+    }
+
+    // Offline run: writes count triples and the mac key to this party's
+    // store at path, generating batch triples per round.
+    void save_triples(const std::string& path, size_t count, size_t batch = 1 << 16) {
+        uint8_t key[FR_BYTES];
+        put_frs(key, &mac_key, 1);
+        triples.save(path, "MASCOT", num_parties, party, key, FR_BYTES, triple_store_run_id(elgl), count, batch,
+                     [this](size_t k) { generate_triples(k); });
+    }
+    // Takes triples from a store save_triples wrote for this party, in the
+    // same run as the peers' stores, and adopts that run's mac key. Shares
+    // made before this call no longer verify.
+    void load_triples(const std::string& path) {
+        triples.load(path, "MASCOT", num_parties, party);
+        get_frs(triples.store->key(), &mac_key, 1);
+        check_triple_stores(elgl, *triples.store);
+    }
+    // Matrix analogue of generate_triple: one message per peer carries the
+    // local A and B, and C is a single local product.
+    MatrixTriple generate_matrix_triple(size_t m, size_t k, size_t n) {
+        MatrixTriple t;
+        t.m = m; t.k = k; t.n = n;
+        t.a.resize(m * k);
+        t.b.resize(k * n);
+        for (auto& x : t.a) x.setByCSPRNG();
+        for (auto& x : t.b) x.setByCSPRNG();
+        std::stringstream ss;
+        write_frs(ss, t.a.data(), t.a.size());
+        write_frs(ss, t.b.data(), t.b.size());
+        elgl->serialize_sendall_with_tag(ss, 8000 * party + party);
+        std::vector<Fr> a_full = t.a, b_full = t.b, other(m * k + k * n);
+        for (int i = 1; i <= num_parties; ++i) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 8000 * i + i);
+                read_frs(ss_recv, other.data(), other.size());
+                for (size_t j = 0; j < m * k; ++j) a_full[j] += other[j];
+                for (size_t j = 0; j < k * n; ++j) b_full[j] += other[m * k + j];
+            }
         }
-        Triple t = triples_pool.back();
-        triples_pool.pop_back();
+        t.c.assign(m * n, Fr(0));
+        if (party == 1) ring_gemm(a_full.data(), b_full.data(), t.c.data(), m, k, n, pool);
+        auto with_mac = [&](const std::vector<Fr>& v, std::vector<Fr>& mac) {
+            mac.resize(v.size());
+            for (size_t j = 0; j < v.size(); ++j) mac[j] = v[j] * mac_key;
+        };
+        with_mac(t.a, t.mac_a);
+        with_mac(t.b, t.mac_b);
+        with_mac(t.c, t.mac_c);
         return t;
     }
-    bool check_mac(const mcl::Vint& value, const mcl::Vint& mac) const {
-        return mac == (value * mac_key % field_size + field_size) % field_size;
+    void precompute_matrix_triples(size_t m, size_t k, size_t n, size_t count) {
+        auto& stock = matrix_triples_pool[{m, k, n}];
+        for (size_t i = 0; i < count; ++i) stock.push_back(generate_matrix_triple(m, k, n));
+    }
+    MatrixTriple get_matrix_triple(size_t m, size_t k, size_t n) {
+        auto it = matrix_triples_pool.find({m, k, n});
+        if (it == matrix_triples_pool.end() || it->second.empty()) {
+            return generate_matrix_triple(m, k, n);
+        }
+        MatrixTriple t = std::move(it->second.back());
+        it->second.pop_back();
+        return t;
     }
 
-    void send_value_and_mac(const mcl::Vint& value, const mcl::Vint& mac, int dst) {
+    bool check_mac(const Fr& value, const Fr& mac) const {
+        return mac == value * mac_key;
+    }
+
+    void send_value_and_mac(const Fr& value, const Fr& mac, int dst) {
         std::stringstream ss;
-        ss << value.getStr() << " " << mac.getStr() << " ";
+        write_frs(ss, &value, 1);
+        write_frs(ss, &mac, 1);
         elgl->serialize_send_with_tag(ss, dst, 5000 * dst + party);
     }
 
-    std::pair<mcl::Vint, mcl::Vint> recv_value_and_mac(int src) {
+    std::pair<Fr, Fr> recv_value_and_mac(int src) {
         std::stringstream ss;
         elgl->deserialize_recv_with_tag(ss, src, 5000 * party + src);
-        std::string s1, s2;
-        mcl::Vint value, mac;
-        ss >> s1 >> s2;
-        value.setStr(s1); mac.setStr(s2);
+        Fr value, mac;
+        read_frs(ss, &value, 1);
+        read_frs(ss, &mac, 1);
         std::cout << party << " recv_value_and_mac: " << value.getStr() << std::endl;
         return {value, mac};
     }
 
     LabeledShare get_zero_share() {
-        mcl::Vint zero(0);
-        return LabeledShare(zero, zero, party, &field_size);
+        return LabeledShare(Fr(0), Fr(0), party);
     }
 
-    MASCOT(ELGL<IO>* elgl_instance) : elgl(elgl_instance) {
+    MASCOT(ELGL<IO>* elgl_instance, ThreadPool* pool = nullptr) : elgl(elgl_instance), pool(pool) {
         party = elgl->party;
         num_parties = elgl->num_party;
 
         unsigned seed = std::chrono::system_clock::now().time_since_epoch().count() + party;
         rng.seed(seed);
 
-        mcl::Vint local_mac_key; local_mac_key.setRand(field_size); local_mac_key %= field_size;
+        Fr local_mac_key; local_mac_key.setByCSPRNG();
         {
             std::stringstream ss;
-            ss << local_mac_key.getStr() << " ";
+            write_frs(ss, &local_mac_key, 1);
             elgl->serialize_sendall_with_tag(ss, 3000 * party + party);
         }
-        mcl::Vint global_mac_key = local_mac_key;
+        mac_key = local_mac_key;
         for (int i = 1; i <= num_parties; ++i) {
             if (i != party) {
                 std::stringstream ss_recv;
                 elgl->deserialize_recv_with_tag(ss_recv, i, 3000 * i + i);
-                std::string s;
-                ss_recv >> s;
-                mcl::Vint other_key; other_key.setStr(s);
-                global_mac_key += other_key;
+                Fr other_key;
+                read_frs(ss_recv, &other_key, 1);
+                mac_key += other_key;
             }
         }
-        mac_key = global_mac_key % field_size;
 
         precompute_triples(20);
     }
 
     ~MASCOT() {}
 
-    LabeledShare distributed_share(const mcl::Vint& xi) {
-        std::vector<mcl::Vint> shares(num_parties, mcl::Vint(0));
-        mcl::Vint remain = xi % field_size;
+    LabeledShare distributed_share(const Fr& xi) {
+        std::vector<Fr> shares(num_parties, Fr(0));
+        Fr remain = xi;
         for (int i = 1; i <= num_parties; ++i) {
             if (i == party) continue;
-            mcl::Vint tmp; tmp.setRand(field_size); tmp %= field_size;
-            shares[i-1] = tmp;
-            remain = (remain - tmp) % field_size;
+            shares[i-1].setByCSPRNG();
+            remain -= shares[i-1];
         }
-        shares[party-1] = remain;
-        std::vector<mcl::Vint> received(num_parties, mcl::Vint(0));
+        Fr local_share = remain;
         for (int i = 1; i <= num_parties; ++i) {
             if (i == party) continue;
+            std::stringstream ss;
+            Fr mac = shares[i-1] * mac_key;
+            write_frs(ss, &shares[i-1], 1);
+            write_frs(ss, &mac, 1);
+            Fr share, mac2;
             if (party < i) {
-                std::stringstream ss;
-                mcl::Vint mac = shares[i-1] * mac_key % field_size;
-                ss << shares[i-1].getStr() << " " << mac.getStr() << " ";
                 elgl->serialize_send_with_tag(ss, i, 4000 * i + party, NORM_MSG);
                 std::stringstream ss_recv;
                 elgl->deserialize_recv_with_tag(ss_recv, i, 4000 * party + i, NORM_MSG);
-                std::string sshare, smac;
-                mcl::Vint share, mac2;
-                ss_recv >> sshare >> smac;
-                share.setStr(sshare); mac2.setStr(smac);
-                assert(check_mac(share, mac2));
-                received[i-1] = share % field_size;
+                read_frs(ss_recv, &share, 1);
+                read_frs(ss_recv, &mac2, 1);
             } else {
                 std::stringstream ss_recv;
                 elgl->deserialize_recv_with_tag(ss_recv, i, 4000 * party + i, NORM_MSG);
-                std::string sshare, smac;
-                mcl::Vint share, mac2;
-                ss_recv >> sshare >> smac;
-                share.setStr(sshare); mac2.setStr(smac);
-                assert(check_mac(share, mac2));
-                received[i-1] = share % field_size;
-                std::stringstream ss;
-                mcl::Vint mac = shares[i-1] * mac_key % field_size;
-                ss << shares[i-1].getStr() << " " << mac.getStr() << " ";
+                read_frs(ss_recv, &share, 1);
+                read_frs(ss_recv, &mac2, 1);
                 elgl->serialize_send_with_tag(ss, i, 4000 * i + party, NORM_MSG);
             }
+            assert(check_mac(share, mac2));
+            local_share += share;
         }
-        received[party-1] = remain;
-        mcl::Vint local_share = 0;
-        for (int i = 0; i < num_parties; ++i) {
-            local_share = (local_share + received[i]) % field_size;
-        }
-        local_share = (local_share + field_size) % field_size;
-        mcl::Vint mac = local_share * mac_key % field_size;
-        mac = (mac + field_size) % field_size;
-        return LabeledShare(local_share, mac, party, &field_size);
+        return LabeledShare(local_share, local_share * mac_key, party);
+    }
+    // xi is reduced modulo r first.
+    LabeledShare distributed_share(const mcl::Vint& xi) {
+        return distributed_share(to_fr(xi));
     }
 
-    mcl::Vint reconstruct(const LabeledShare& share) {
+    Fr reconstruct(const LabeledShare& share) {
         std::stringstream ss;
         share.pack(ss);
         elgl->serialize_sendall_with_tag(ss, 1000 * party + party);
-        mcl::Vint result = share.value % field_size;
+        Fr result = share.value;
         for (int i = 1; i <= num_parties; i++) {
             if (i != party) {
                 std::stringstream ss_recv;
                 elgl->deserialize_recv_with_tag(ss_recv, i, 1000 * i + i);
                 LabeledShare other_share;
                 other_share.unpack(ss_recv);
-                other_share.field_size_ptr = &field_size;
                 assert(check_mac(other_share.value, other_share.mac));
-                mcl::Vint v = other_share.value % field_size;
-                result = (result + v) % field_size;
+                result += other_share.value;
             }
         }
         return result;
     }
 
+    // Opens every share with one message per peer, carrying the values and
+    // then the macs as 32-byte encodings.
+    std::vector<Fr> reconstruct_batch(const FrShares& shares) {
+        size_t n = shares.size();
+        std::vector<Fr> result = shares.value;
+        if (n == 0) return result;
+        std::stringstream ss;
+        write_frs(ss, shares.value.data(), n);
+        write_frs(ss, shares.mac.data(), n);
+        elgl->serialize_sendall_with_tag(ss, 6000 * party + party);
+        std::vector<Fr> buf(2 * n);
+        for (int i = 1; i <= num_parties; i++) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 6000 * i + i);
+                read_frs(ss_recv, buf.data(), buf.size());
+                for (size_t j = 0; j < n; ++j) {
+                    assert(check_mac(buf[j], buf[n + j]));
+                    result[j] += buf[j];
+                }
+            }
+        }
+        return result;
+    }
+    std::vector<Fr> reconstruct_batch(const std::vector<LabeledShare>& shares) {
+        return reconstruct_batch(to_soa(shares));
+    }
+
+    FrShares to_soa(const std::vector<LabeledShare>& x) const {
+        FrShares out(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            out.value[i] = x[i].value;
+            out.mac[i] = x[i].mac;
+        }
+        return out;
+    }
+    std::vector<LabeledShare> from_soa(const FrShares& x) const {
+        std::vector<LabeledShare> out(x.size());
+        for (size_t i = 0; i < x.size(); ++i) out[i] = LabeledShare(x.value[i], x.mac[i], party);
+        return out;
+    }
+    FrShares add(const FrShares& x, const FrShares& y) {
+        assert(x.size() == y.size());
+        FrShares out(x.size());
+        emp::parallel_for(pool, 0, x.size(), [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                Fr::add(out.value[i], x.value[i], y.value[i]);
+                Fr::add(out.mac[i], x.mac[i], y.mac[i]);
+            }
+        });
+        return out;
+    }
+    FrShares sub(const FrShares& x, const FrShares& y) {
+        assert(x.size() == y.size());
+        FrShares out(x.size());
+        emp::parallel_for(pool, 0, x.size(), [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                Fr::sub(out.value[i], x.value[i], y.value[i]);
+                Fr::sub(out.mac[i], x.mac[i], y.mac[i]);
+            }
+        });
+        return out;
+    }
+    FrShares mul_const(const FrShares& x, const Fr& scalar) {
+        FrShares out(x.size());
+        emp::parallel_for(pool, 0, x.size(), [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                Fr::mul(out.value[i], x.value[i], scalar);
+                Fr::mul(out.mac[i], x.mac[i], scalar);
+            }
+        });
+        return out;
+    }
+
     LabeledShare add(const LabeledShare& x, const LabeledShare& y) {
         return x + y;
     }
-    LabeledShare mul_const(const LabeledShare& x, const mcl::Vint& scalar) {
+    LabeledShare mul_const(const LabeledShare& x, const Fr& scalar) {
         return x * scalar;
     }
+    LabeledShare mul_const(const LabeledShare& x, const mcl::Vint& scalar) {
+        return x * to_fr(scalar);
+    }
     LabeledShare multiply(const LabeledShare& x, const LabeledShare& y) {
         Triple t = get_triple();
-        mcl::Vint epsilon = (x.value - t.a) % field_size;
-        epsilon = (epsilon + field_size) % field_size;
-        mcl::Vint delta = (y.value - t.b) % field_size;
-        delta = (delta + field_size) % field_size;
-
-        LabeledShare eps_share(
-            epsilon, 
-            (x.mac - t.mac_a + field_size) % field_size,
-            party, 
-            &field_size
-        );
-        
-        LabeledShare del_share(
-            delta,
-            (y.mac - t.mac_b + field_size) % field_size,
-            party,
-            &field_size
-        );
-
-        mcl::Vint epsilon_open = reconstruct(eps_share);
-        mcl::Vint delta_open = reconstruct(del_share);
-
-        mcl::Vint z_value = (t.c + 
-                          (epsilon_open * t.b) % field_size + 
-                          (delta_open * t.a) % field_size) % field_size;
-        
-        if (party == 1) {
-            z_value = (z_value + (epsilon_open * delta_open) % field_size) % field_size;
-        }
-        z_value = (z_value + field_size) % field_size;
+        LabeledShare eps_share(x.value - t.a, x.mac - t.mac_a, party);
+        LabeledShare del_share(y.value - t.b, y.mac - t.mac_b, party);
 
-        mcl::Vint z_mac = (t.mac_c + 
-                        (epsilon_open * t.mac_b) % field_size + 
-                        (delta_open * t.mac_a) % field_size) % field_size;
-        
+        Fr epsilon_open = reconstruct(eps_share);
+        Fr delta_open = reconstruct(del_share);
+        return beaver_output(t.a, t.b, t.c, t.mac_a, t.mac_b, t.mac_c, epsilon_open, delta_open);
+    }
+
+    // x[i] * y[i] for all i; the masked inputs are opened in one round.
+    FrShares multiply_batch(const FrShares& x, const FrShares& y) {
+        assert(x.size() == y.size());
+        size_t n = x.size();
+        std::vector<Triple> t = get_triples(n);
+        FrShares masked(2 * n), z(n);
+        emp::parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                masked.value[i] = x.value[i] - t[i].a;
+                masked.mac[i] = x.mac[i] - t[i].mac_a;
+                masked.value[n + i] = y.value[i] - t[i].b;
+                masked.mac[n + i] = y.mac[i] - t[i].mac_b;
+            }
+        });
+        std::vector<Fr> opened = reconstruct_batch(masked);
+        emp::parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                LabeledShare s = beaver_output(t[i].a, t[i].b, t[i].c, t[i].mac_a, t[i].mac_b, t[i].mac_c, opened[i], opened[n + i]);
+                z.value[i] = s.value;
+                z.mac[i] = s.mac;
+            }
+        });
+        return z;
+    }
+    std::vector<LabeledShare> multiply_batch(const std::vector<LabeledShare>& x, const std::vector<LabeledShare>& y) {
+        return from_soa(multiply_batch(to_soa(x), to_soa(y)));
+    }
+
+    // z = c + e b + d a (+ e d on party 1), and likewise for the macs.
+    LabeledShare beaver_output(const Fr& a, const Fr& b, const Fr& c, const Fr& mac_a, const Fr& mac_b, const Fr& mac_c,
+                               const Fr& epsilon_open, const Fr& delta_open) const {
+        Fr z_value = c + epsilon_open * b + delta_open * a;
+        Fr z_mac = mac_c + epsilon_open * mac_b + delta_open * mac_a;
         if (party == 1) {
-            z_mac = (z_mac + (epsilon_open * delta_open * mac_key) % field_size) % field_size;
+            Fr ed = epsilon_open * delta_open;
+            z_value += ed;
+            z_mac += ed * mac_key;
         }
-        z_mac = (z_mac + field_size) % field_size;
-
         assert(check_mac(z_value, z_mac));
+        return LabeledShare(z_value, z_mac, party);
+    }
 
-        return LabeledShare(z_value, z_mac, party, &field_size);
+    // a (m x k) times b (k x n) with a matrix triple: E = X - A and F = Y - B
+    // are opened together and Z = C + E B + A F (+ E F on party 1) is local.
+    // The product is not truncated.
+    std::vector<LabeledShare> matrix_multiply(const std::vector<LabeledShare>& a, const std::vector<LabeledShare>& b, size_t m, size_t k, size_t n) {
+        assert(a.size() == m * k);
+        assert(b.size() == k * n);
+        MatrixTriple t = get_matrix_triple(m, k, n);
+        FrShares masked(m * k + k * n);
+        for (size_t i = 0; i < m * k; ++i) {
+            masked.value[i] = a[i].value - t.a[i];
+            masked.mac[i] = a[i].mac - t.mac_a[i];
+        }
+        for (size_t i = 0; i < k * n; ++i) {
+            masked.value[m * k + i] = b[i].value - t.b[i];
+            masked.mac[m * k + i] = b[i].mac - t.mac_b[i];
+        }
+        std::vector<Fr> opened = reconstruct_batch(masked);
+        const Fr* e = opened.data();
+        const Fr* d = opened.data() + m * k;
+        std::vector<Fr> z = t.c, z_mac = t.mac_c;
+        ring_gemm(e, t.b.data(), z.data(), m, k, n, pool);
+        ring_gemm(t.a.data(), d, z.data(), m, k, n, pool);
+        ring_gemm(e, t.mac_b.data(), z_mac.data(), m, k, n, pool);
+        ring_gemm(t.mac_a.data(), d, z_mac.data(), m, k, n, pool);
+        if (party == 1) {
+            std::vector<Fr> ed(m * n, Fr(0));
+            ring_gemm(e, d, ed.data(), m, k, n, pool);
+            for (size_t i = 0; i < m * n; ++i) {
+                z[i] += ed[i];
+                z_mac[i] += ed[i] * mac_key;
+            }
+        }
+        std::vector<LabeledShare> result(m * n);
+        for (size_t i = 0; i < m * n; ++i) {
+            result[i] = LabeledShare(z[i], z_mac[i], party);
+        }
+        return result;
     }
 
     void print_raw_values(const LabeledShare& share) {
@@ -313,60 +514,73 @@ public:
 
     LabeledShare truncate_share(const LabeledShare& x, int f) {
         mcl::Vint fs = field_size;
-        mcl::Vint r; r.setRand(fs >> 1);  
+        mcl::Vint r; r.setRand(fs >> 1);
         mcl::Vint r_hi = r >> f;
         LabeledShare share_r = distributed_share(r);
         LabeledShare share_r_hi = distributed_share(r_hi);
         LabeledShare masked = add(x, share_r);
-        mcl::Vint z = reconstruct(masked);
+        mcl::Vint z = reconstruct(masked).getMpz();
         bool is_negative = z >= (fs >> 1);
         mcl::Vint z_abs = is_negative ? fs - z : z;
         mcl::Vint z_trunc = z_abs >> f;
         if (is_negative) {
             z_trunc = fs - z_trunc;
         }
-        mcl::Vint result_value = (z_trunc - share_r_hi.value) % fs;
-        if (result_value < 0) result_value += fs;
-        mcl::Vint result_mac = (result_value * mac_key) % fs;
-        return LabeledShare(result_value, result_mac, party, &field_size);
+        Fr result_value = to_fr(z_trunc) - share_r_hi.value;
+        return LabeledShare(result_value, result_value * mac_key, party);
     }
 
     LabeledShare multiply_with_trunc(const LabeledShare& x, const LabeledShare& y, int f) {
         Triple t = get_triple();
-        mcl::Vint eps = (x.value - t.a) % field_size;
-        eps = (eps + field_size) % field_size;
-        mcl::Vint del = (y.value - t.b) % field_size;
-        del = (del + field_size) % field_size;
-        LabeledShare eps_share(
-            eps,
-            ((x.mac - t.mac_a) % field_size + field_size) % field_size,
-            party,
-            &field_size
-        );
-        LabeledShare del_share(
-            del,
-            ((y.mac - t.mac_b) % field_size + field_size) % field_size,
-            party,
-            &field_size
-        );
-        mcl::Vint eps_open = reconstruct(eps_share);
-        mcl::Vint del_open = reconstruct(del_share);
+        LabeledShare eps_share(x.value - t.a, x.mac - t.mac_a, party);
+        LabeledShare del_share(y.value - t.b, y.mac - t.mac_b, party);
+        Fr eps_open = reconstruct(eps_share);
+        Fr del_open = reconstruct(del_share);
         LabeledShare tmp;
         if (party == 1) {
-            tmp = LabeledShare(eps_open * t.b + del_open * t.a + eps_open * del_open, eps_open * t.mac_b + del_open * t.mac_a + eps_open * del_open * mac_key, party, &field_size);
+            tmp = LabeledShare(eps_open * t.b + del_open * t.a + eps_open * del_open, eps_open * t.mac_b + del_open * t.mac_a + eps_open * del_open * mac_key, party);
             tmp = truncate_share(tmp, f);
         }
         else {
-            tmp = LabeledShare(eps_open * t.b + del_open * t.a, eps_open * t.mac_b + del_open * t.mac_a, party, &field_size);
+            tmp = LabeledShare(eps_open * t.b + del_open * t.a, eps_open * t.mac_b + del_open * t.mac_a, party);
             tmp = truncate_share(tmp, f);
         }
-        mcl::Vint z_value = t.c + tmp.value;
-        z_value = (z_value + field_size) % field_size;
-        mcl::Vint z_mac = t.mac_c + tmp.mac;
-        z_mac = (z_mac + field_size) % field_size;
-        LabeledShare mult_result(z_value, z_mac, party, &field_size);
-        return mult_result;
+        return LabeledShare(t.c + tmp.value, t.mac_c + tmp.mac, party);
+    }
+
+    static Fr to_fr(const mcl::Vint& x) {
+        mcl::Vint v = x % field_size;
+        if (v < 0) v += field_size;
+        Fr out;
+        out.setMpz(v);
+        return out;
+    }
+
+private:
+    static void put_frs(uint8_t* out, const Fr* x, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (x[i].serialize(out + i * FR_BYTES, FR_BYTES) != FR_BYTES)
+                throw std::runtime_error("MASCOT: Fr encoding failed");
+        }
+    }
+    static void get_frs(const uint8_t* in, Fr* x, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (x[i].deserialize(in + i * FR_BYTES, FR_BYTES) != FR_BYTES)
+                throw std::runtime_error("MASCOT: invalid Fr encoding");
+        }
+    }
+    static void write_frs(std::stringstream& ss, const Fr* x, size_t n) {
+        std::vector<uint8_t> buf(n * FR_BYTES);
+        put_frs(buf.data(), x, n);
+        ss.write((const char*)buf.data(), buf.size());
+    }
+    static void read_frs(std::stringstream& ss, Fr* x, size_t n) {
+        std::vector<uint8_t> buf(n * FR_BYTES);
+        ss.read((char*)buf.data(), buf.size());
+        if ((size_t)ss.gcount() != buf.size())
+            throw std::runtime_error("MASCOT: short message");
+        get_frs(buf.data(), x, n);
     }
 };
 
-} // namespace emp
\ No newline at end of file
+} // namespace emp
@@ -0,0 +1,137 @@
+#pragma once
+#include "emp-aby/lvt_state.hpp"
+#include "emp-aby/utils.h"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace emp {
+
+enum class PointLayout { AFFINE, COMPRESSED };
+
+// rows x cols group elements in one contiguous block, e.g. the cip_lut of
+// an LVT. AFFINE keeps the normalized x and y in mcl's internal form (96
+// bytes per entry, against 144 for a Jacobian BLS12381Element) and reads an
+// entry back with two copies. COMPRESSED keeps the 48-byte encoding and
+// pays a square root for each entry read. A table may also view the
+// cip_lut section of a mapped state file.
+class PointTable {
+public:
+    // Allocates rows x cols identity entries, to be filled by set_row()
+    // or store() as the rows are produced.
+    void reset(size_t rows, size_t cols, PointLayout layout) {
+        clear();
+        this->layout = layout;
+        n_rows = rows;
+        n_cols = cols;
+        if (layout == PointLayout::AFFINE) {
+            xy.resize(2 * n_rows * n_cols);
+        } else {
+            uint8_t zero[LVT_POINT_BYTES];
+            G1 O;
+            O.clear();
+            lvt_put_point(zero, O);
+            packed.resize(n_rows * n_cols * LVT_POINT_BYTES);
+            for (size_t k = 0; k < n_rows * n_cols; ++k)
+                memcpy(packed.data() + k * LVT_POINT_BYTES, zero, LVT_POINT_BYTES);
+        }
+    }
+
+    void set_row(size_t row, const std::vector<BLS12381Element>& in, ThreadPool* pool) {
+        if (in.size() != n_cols)
+            throw std::runtime_error("PointTable::set_row: wrong row length");
+        emp::parallel_for(pool, 0, n_cols, [&](size_t lo, size_t hi) {
+            std::vector<G1> norm(hi - lo);
+            for (size_t c = lo; c < hi; ++c) norm[c - lo] = in[c].getPoint();
+            store(row, lo, norm.data(), norm.size());
+        });
+    }
+
+    // Fills a row from its compressed encodings, as stored in state files.
+    void decode_row(size_t row, const uint8_t* in, ThreadPool* pool) {
+        emp::parallel_for(pool, 0, n_cols, [&](size_t lo, size_t hi) {
+            std::vector<G1> pts(hi - lo);
+            for (size_t c = lo; c < hi; ++c) pts[c - lo] = lvt_get_point(in + c * LVT_POINT_BYTES).point;
+            store(row, lo, pts.data(), pts.size());
+        });
+    }
+
+    // Writes pts to entries (row, col) .. (row, col + n - 1), normalizing
+    // pts in place. Disjoint ranges may be stored concurrently.
+    void store(size_t row, size_t col, G1* pts, size_t n) {
+        G1::normalizeVec(pts, pts, n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t k = row * n_cols + col + i;
+            const G1& P = pts[i];
+            if (layout == PointLayout::COMPRESSED) {
+                lvt_put_point(packed.data() + k * LVT_POINT_BYTES, P);
+            } else if (P.isZero()) {
+                xy[2 * k].clear();
+                xy[2 * k + 1].clear();
+            } else {
+                xy[2 * k] = P.x;
+                xy[2 * k + 1] = P.y;
+            }
+        }
+    }
+
+    // Takes over a mapped cip_lut section; entries are decoded on first use.
+    void attach(std::shared_ptr<MappedPointTable> table) {
+        clear();
+        n_rows = table->rows;
+        n_cols = table->cols;
+        mapped = std::move(table);
+    }
+
+    void clear() {
+        n_rows = n_cols = 0;
+        std::vector<Fp>().swap(xy);
+        std::vector<uint8_t>().swap(packed);
+        mapped.reset();
+    }
+
+    BLS12381Element at(size_t row, size_t col) const {
+        size_t k = row * n_cols + col;
+        if (mapped) return mapped->at(row, col);
+        if (layout == PointLayout::COMPRESSED) return lvt_get_point(packed.data() + k * LVT_POINT_BYTES);
+        BLS12381Element out;
+        // (0, 0) is not on the curve and stands for the identity.
+        if (xy[2 * k].isZero() && xy[2 * k + 1].isZero()) {
+            out.point.clear();
+        } else {
+            out.point.x = xy[2 * k];
+            out.point.y = xy[2 * k + 1];
+            out.point.z = 1;
+        }
+        return out;
+    }
+
+    // Compressed encodings of one row, as stored in state files.
+    void encode_row(size_t row, uint8_t* out, ThreadPool* pool) const {
+        if (mapped) {
+            memcpy(out, mapped->row_bytes(row), n_cols * LVT_POINT_BYTES);
+        } else if (layout == PointLayout::COMPRESSED) {
+            memcpy(out, packed.data() + row * n_cols * LVT_POINT_BYTES, n_cols * LVT_POINT_BYTES);
+        } else {
+            emp::parallel_for(pool, 0, n_cols, [&](size_t lo, size_t hi) {
+                for (size_t c = lo; c < hi; ++c)
+                    lvt_put_point(out + c * LVT_POINT_BYTES, at(row, c).getPoint());
+            });
+        }
+    }
+
+    size_t rows() const { return n_rows; }
+    size_t cols() const { return n_cols; }
+    bool empty() const { return n_rows == 0; }
+    // Resident bytes, not counting pages of a mapped file.
+    size_t bytes() const { return xy.size() * sizeof(Fp) + packed.size(); }
+
+private:
+    PointLayout layout = PointLayout::AFFINE;
+    size_t n_rows = 0, n_cols = 0;
+    std::vector<Fp> xy;
+    std::vector<uint8_t> packed;
+    std::shared_ptr<MappedPointTable> mapped;
+};
+
+}  // namespace emp
@@ -0,0 +1,33 @@
+#pragma once
+#include "emp-aby/utils.h"
+#include <algorithm>
+
+namespace emp {
+
+// C[m x n] += A[m x k] * B[k x n], row-major, in the ring of T: wrapping
+// uint64_t arithmetic for Z_2^k shares, mcl::Vint or Fr for field shares
+// (Vint callers reduce C afterwards). The k and n loops are blocked so a
+// kc x nc panel of B stays in cache while a block of rows of A streams over
+// it; row blocks run in parallel on pool.
+template <typename T>
+void ring_gemm(const T* A, const T* B, T* C, size_t m, size_t k, size_t n, ThreadPool* pool = nullptr) {
+    const size_t kc = 128, nc = 512;
+    emp::parallel_for(pool, 0, m, [&](size_t lo, size_t hi) {
+        for (size_t kk = 0; kk < k; kk += kc) {
+            size_t ke = std::min(k, kk + kc);
+            for (size_t jj = 0; jj < n; jj += nc) {
+                size_t je = std::min(n, jj + nc);
+                for (size_t i = lo; i < hi; ++i) {
+                    T* c = C + i * n;
+                    for (size_t p = kk; p < ke; ++p) {
+                        const T a = A[i * k + p];
+                        const T* b = B + p * n;
+                        for (size_t j = jj; j < je; ++j) c[j] += a * b[j];
+                    }
+                }
+            }
+        }
+    });
+}
+
+}  // namespace emp
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "elgl_interface.hpp"
+#include "emp-aby/ring_gemm.hpp"
+#include "emp-aby/triple_store.hpp"
+#include "emp-aby/z2k.hpp"
 #include "testLLM/FixedPointConverter.h"
 #include <vector>
 #include <random>
@@ -10,12 +13,14 @@
 #include <mutex>
 #include <condition_variable>
 #include <map>
+#include <array>
 
 const uint64_t spdz2k_field_size = (1ULL << 63); 
 
 namespace emp {
 
 inline uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod) {
+    if ((mod & (mod - 1)) == 0) return (a * b) & (mod - 1);
     return static_cast<uint64_t>((__uint128_t)a * b % mod);
 }
 
@@ -29,6 +34,8 @@ public:
     std::condition_variable cv;
     std::mt19937_64 rng;
     uint64_t mac_key;
+    // Runs the local matrix products; nullptr keeps them on the caller.
+    ThreadPool* pool = nullptr;
 
     struct LabeledShare {
         uint64_t value;
@@ -69,14 +76,31 @@ public:
         void unpack(std::stringstream& ss) {
             ss >> a >> b >> c >> mac_a >> mac_b >> mac_c;
         }
+
+        // Triple store record: the six words in host byte order.
+        static const size_t RECORD_BYTES = 6 * sizeof(uint64_t);
+        void encode(uint8_t* out) const {
+            uint64_t w[6] = {a, b, c, mac_a, mac_b, mac_c};
+            memcpy(out, w, RECORD_BYTES);
+        }
+        static Triple decode(const uint8_t* in) {
+            uint64_t w[6];
+            memcpy(w, in, RECORD_BYTES);
+            return Triple(w[0], w[1], w[2], w[3], w[4], w[5]);
+        }
+    };
+
+    // <A> (m x k), <B> (k x n) and <C> = <AB>, row-major, with macs.
+    struct MatrixTriple {
+        size_t m = 0, k = 0, n = 0;
+        std::vector<uint64_t> a, b, c, mac_a, mac_b, mac_c;
     };
 
-    std::vector<Triple> triples_pool;
+    TripleSupply<Triple> triples;
+    std::map<std::array<size_t, 3>, std::vector<MatrixTriple>> matrix_triples_pool;
 
     void precompute_triples(size_t num_triples) {
-        for (size_t i = 0; i < num_triples; i++) {
-            generate_triple();
-        }
+        generate_triples(num_triples);
     }
     void generate_triple() {
         uint64_t fs = spdz2k_field_size;
@@ -101,14 +125,110 @@ public:
         uint64_t mac_a = mulmod(a_local, mac_key, fs);
         uint64_t mac_b = mulmod(b_local, mac_key, fs);
         uint64_t mac_c = mulmod(c_local, mac_key, fs);
-        triples_pool.emplace_back(a_local, b_local, c_local, mac_a, mac_b, mac_c);
+        triples.pool.emplace_back(a_local, b_local, c_local, mac_a, mac_b, mac_c);
+    }
+    // Same as generate_triple, for count triples in one message per peer.
+    void generate_triples(size_t count) {
+        if (count == 0) return;
+        uint64_t fs = spdz2k_field_size;
+        std::vector<uint64_t> local(2 * count), full(2 * count), other(2 * count);
+        for (auto& v : local) v = rng() % fs;
+        full = local;
+        std::stringstream ss;
+        ss.write((const char*)local.data(), local.size() * sizeof(uint64_t));
+        elgl->serialize_sendall_with_tag(ss, 7000 * party + party);
+        for (int i = 1; i <= num_parties; ++i) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 7000 * i + i);
+                read_words(ss_recv, other);
+                for (size_t j = 0; j < full.size(); ++j) full[j] = (full[j] + other[j]) % fs;
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            uint64_t a_local = local[2 * j], b_local = local[2 * j + 1];
+            uint64_t c_full = mulmod(full[2 * j], full[2 * j + 1], fs);
+            uint64_t c_local = (party == 1) ? c_full : 0;
+            triples.pool.emplace_back(a_local, b_local, c_local, mulmod(a_local, mac_key, fs),
+                                      mulmod(b_local, mac_key, fs), mulmod(c_local, mac_key, fs));
+        }
     }
     Triple get_triple() {
-        if (triples_pool.empty()) {
-            precompute_triples(10);
+        Triple t;
+        triples.take(&t, 1, [this](size_t k) { generate_triples(k); });
+        return t;
+    }
+    // Takes n triples, generating any shortfall in one round.
+    std::vector<Triple> get_triples(size_t n) {
+        std::vector<Triple> out(n);
+        triples.take(out.data(), n, [this](size_t k) { generate_triples(k); });
+        return out;
+    }
+
+    // Offline run: writes count triples and the mac key to this party's
+    // store at path, generating batch triples per round.
+    void save_triples(const std::string& path, size_t count, size_t batch = 1 << 16) {
+        triples.save(path, "SPDZ2K", num_parties, party, (const uint8_t*)&mac_key, sizeof(mac_key),
+                     triple_store_run_id(elgl), count, batch,
+                     [this](size_t k) { generate_triples(k); });
+    }
+    // Takes triples from a store save_triples wrote for this party, in the
+    // same run as the peers' stores, and adopts that run's mac key. Shares
+    // made before this call no longer verify.
+    void load_triples(const std::string& path) {
+        triples.load(path, "SPDZ2K", num_parties, party);
+        memcpy(&mac_key, triples.store->key(), sizeof(mac_key));
+        check_triple_stores(elgl, *triples.store);
+    }
+    // Matrix analogue of generate_triple: one message per peer carries the
+    // local A and B, and C is a single local product.
+    MatrixTriple generate_matrix_triple(size_t m, size_t k, size_t n) {
+        const uint64_t mask = spdz2k_field_size - 1;
+        MatrixTriple t;
+        t.m = m; t.k = k; t.n = n;
+        t.a.resize(m * k);
+        t.b.resize(k * n);
+        for (auto& v : t.a) v = rng() & mask;
+        for (auto& v : t.b) v = rng() & mask;
+        std::vector<uint64_t> a_full = t.a, b_full = t.b, other(m * k + k * n);
+        std::stringstream ss;
+        ss.write((const char*)t.a.data(), t.a.size() * sizeof(uint64_t));
+        ss.write((const char*)t.b.data(), t.b.size() * sizeof(uint64_t));
+        elgl->serialize_sendall_with_tag(ss, 8000 * party + party);
+        for (int i = 1; i <= num_parties; ++i) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 8000 * i + i);
+                read_words(ss_recv, other);
+                for (size_t j = 0; j < m * k; ++j) a_full[j] += other[j];
+                for (size_t j = 0; j < k * n; ++j) b_full[j] += other[m * k + j];
+            }
+        }
+        t.c.assign(m * n, 0);
+        if (party == 1) ring_gemm(a_full.data(), b_full.data(), t.c.data(), m, k, n, pool);
+        auto with_mac = [&](std::vector<uint64_t>& v, std::vector<uint64_t>& mac) {
+            mac.resize(v.size());
+            for (size_t j = 0; j < v.size(); ++j) {
+                v[j] &= mask;
+                mac[j] = (v[j] * mac_key) & mask;
+            }
+        };
+        with_mac(t.a, t.mac_a);
+        with_mac(t.b, t.mac_b);
+        with_mac(t.c, t.mac_c);
+        return t;
+    }
+    void precompute_matrix_triples(size_t m, size_t k, size_t n, size_t count) {
+        auto& stock = matrix_triples_pool[{m, k, n}];
+        for (size_t i = 0; i < count; ++i) stock.push_back(generate_matrix_triple(m, k, n));
+    }
+    MatrixTriple get_matrix_triple(size_t m, size_t k, size_t n) {
+        auto it = matrix_triples_pool.find({m, k, n});
+        if (it == matrix_triples_pool.end() || it->second.empty()) {
+            return generate_matrix_triple(m, k, n);
         }
-        Triple t = triples_pool.back();
-        triples_pool.pop_back();
+        MatrixTriple t = std::move(it->second.back());
+        it->second.pop_back();
         return t;
     }
     bool check_mac(uint64_t value, uint64_t mac) const {
@@ -126,7 +246,7 @@ public:
         ss >> value >> mac;
         return {value, mac};
     }
-    SPDZ2k(ELGL<IO>* elgl_instance) : elgl(elgl_instance) {
+    SPDZ2k(ELGL<IO>* elgl_instance, ThreadPool* pool = nullptr) : elgl(elgl_instance), pool(pool) {
         party = elgl->party;
         num_parties = elgl->num_party;
         unsigned seed = std::chrono::system_clock::now().time_since_epoch().count() + party;
@@ -225,6 +345,66 @@ public:
         }
         return result % fs;
     }
+    // Opens every share with one message per peer, carrying the values and
+    // then the macs as raw 64-bit words.
+    std::vector<uint64_t> reconstruct_batch(const Z2kShares& shares) {
+        size_t n = shares.size();
+        std::vector<uint64_t> result = shares.value;
+        if (n == 0) return result;
+        std::stringstream ss;
+        ss.write((const char*)shares.value.data(), n * sizeof(uint64_t));
+        ss.write((const char*)shares.mac.data(), n * sizeof(uint64_t));
+        elgl->serialize_sendall_with_tag(ss, 6000 * party + party);
+        std::vector<uint64_t> buf(2 * n);
+        for (int i = 1; i <= num_parties; i++) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 6000 * i + i);
+                read_words(ss_recv, buf);
+                for (size_t j = 0; j < n; ++j) assert(check_mac(buf[j], buf[n + j]));
+                z2k_add(result.data(), result.data(), buf.data(), n);
+            }
+        }
+        return result;
+    }
+    std::vector<uint64_t> reconstruct_batch(const std::vector<LabeledShare>& shares) {
+        return reconstruct_batch(to_soa(shares));
+    }
+
+    Z2kShares to_soa(const std::vector<LabeledShare>& x) const {
+        Z2kShares out(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            out.value[i] = x[i].value & Z2K_MASK;
+            out.mac[i] = x[i].mac & Z2K_MASK;
+        }
+        return out;
+    }
+    std::vector<LabeledShare> from_soa(const Z2kShares& x) const {
+        std::vector<LabeledShare> out(x.size());
+        for (size_t i = 0; i < x.size(); ++i) out[i] = LabeledShare(x.value[i], x.mac[i], party, &spdz2k_field_size);
+        return out;
+    }
+    Z2kShares add(const Z2kShares& x, const Z2kShares& y) {
+        assert(x.size() == y.size());
+        Z2kShares out(x.size());
+        z2k_add(out.value.data(), x.value.data(), y.value.data(), x.size());
+        z2k_add(out.mac.data(), x.mac.data(), y.mac.data(), x.size());
+        return out;
+    }
+    Z2kShares sub(const Z2kShares& x, const Z2kShares& y) {
+        assert(x.size() == y.size());
+        Z2kShares out(x.size());
+        z2k_sub(out.value.data(), x.value.data(), y.value.data(), x.size());
+        z2k_sub(out.mac.data(), x.mac.data(), y.mac.data(), x.size());
+        return out;
+    }
+    Z2kShares mul_const(const Z2kShares& x, uint64_t scalar) {
+        Z2kShares out(x.size());
+        z2k_mul_const(out.value.data(), x.value.data(), scalar, x.size());
+        z2k_mul_const(out.mac.data(), x.mac.data(), scalar, x.size());
+        return out;
+    }
+
     LabeledShare add(const LabeledShare& x, const LabeledShare& y) {
         return x + y;
     }
@@ -250,6 +430,39 @@ public:
         );
         uint64_t epsilon_open = reconstruct(eps_share);
         uint64_t delta_open = reconstruct(del_share);
+        return beaver_output(t, epsilon_open, delta_open);
+    }
+
+    // x[i] * y[i] for all i; the masked inputs are opened in one round.
+    Z2kShares multiply_batch(const Z2kShares& x, const Z2kShares& y) {
+        assert(x.size() == y.size());
+        size_t n = x.size();
+        std::vector<Triple> t = get_triples(n);
+        Z2kShares a(n), b(n), z(n);
+        for (size_t i = 0; i < n; ++i) {
+            a.value[i] = t[i].a; a.mac[i] = t[i].mac_a;
+            b.value[i] = t[i].b; b.mac[i] = t[i].mac_b;
+            z.value[i] = t[i].c; z.mac[i] = t[i].mac_c;
+        }
+        Z2kShares masked(2 * n);
+        z2k_sub(masked.value.data(), x.value.data(), a.value.data(), n);
+        z2k_sub(masked.mac.data(), x.mac.data(), a.mac.data(), n);
+        z2k_sub(masked.value.data() + n, y.value.data(), b.value.data(), n);
+        z2k_sub(masked.mac.data() + n, y.mac.data(), b.mac.data(), n);
+        std::vector<uint64_t> opened = reconstruct_batch(masked);
+        const uint64_t* e = opened.data();
+        const uint64_t* d = opened.data() + n;
+        // z = c + e b + d a (+ e d on party 1), and likewise for the macs.
+        z2k_beaver(z.value.data(), e, d, b.value.data(), a.value.data(), party == 1 ? 1 : 0, n);
+        z2k_beaver(z.mac.data(), e, d, b.mac.data(), a.mac.data(), party == 1 ? mac_key : 0, n);
+        return z;
+    }
+    std::vector<LabeledShare> multiply_batch(const std::vector<LabeledShare>& x, const std::vector<LabeledShare>& y) {
+        return from_soa(multiply_batch(to_soa(x), to_soa(y)));
+    }
+
+    LabeledShare beaver_output(const Triple& t, uint64_t epsilon_open, uint64_t delta_open) {
+        uint64_t fs = spdz2k_field_size;
         uint64_t z_value = (t.c + mulmod(epsilon_open, t.b, fs) + mulmod(delta_open, t.a, fs)) % fs;
         if (party == 1) {
             z_value = (z_value + mulmod(epsilon_open, delta_open, fs)) % fs;
@@ -328,6 +541,18 @@ public:
         return static_cast<uint64_t>(t);
     }
 
+    std::vector<LabeledShare> truncate_batch(const std::vector<LabeledShare>& x, int f) {
+        std::vector<LabeledShare> result(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            result[i] = truncate_share(x[i], f);
+        }
+        return result;
+    }
+
+    std::vector<LabeledShare> multiply_with_trunc_batch(const std::vector<LabeledShare>& x, const std::vector<LabeledShare>& y, int f) {
+        return truncate_batch(multiply_batch(x, y), f);
+    }
+
     std::vector<LabeledShare> vector_add(const std::vector<LabeledShare>& a, const std::vector<LabeledShare>& b) {
         assert(a.size() == b.size());
         std::vector<LabeledShare> result(a.size());
@@ -341,20 +566,39 @@ public:
         assert(a.size() == m * k);
         assert(b.size() == k * n);
 
-        std::vector<LabeledShare> result(m * n, get_zero_share());
-
-        for (size_t i = 0; i < m; ++i) {
-            for (size_t j = 0; j < n; ++j) {
-                for (size_t p = 0; p < k; ++p) {
-                    size_t a_idx = i * k + p;
-                    size_t b_idx = p * n + j;
-                    LabeledShare prod = multiply_with_trunc(a[a_idx], b[b_idx], f);
-                    result[i * n + j] = add(result[i * n + j], prod);
-                }
+        // Z = C + E B + A F (+ E F on party 1) with E = X - A and F = Y - B
+        // opened together; the products are local GEMMs.
+        const uint64_t mask = spdz2k_field_size - 1;
+        MatrixTriple t = get_matrix_triple(m, k, n);
+        std::vector<LabeledShare> masked(m * k + k * n);
+        for (size_t i = 0; i < m * k; ++i) {
+            masked[i] = LabeledShare((a[i].value - t.a[i]) & mask, (a[i].mac - t.mac_a[i]) & mask, party, &spdz2k_field_size);
+        }
+        for (size_t i = 0; i < k * n; ++i) {
+            masked[m * k + i] = LabeledShare((b[i].value - t.b[i]) & mask, (b[i].mac - t.mac_b[i]) & mask, party, &spdz2k_field_size);
+        }
+        std::vector<uint64_t> opened = reconstruct_batch(masked);
+        const uint64_t* e = opened.data();
+        const uint64_t* d = opened.data() + m * k;
+        std::vector<uint64_t> z = t.c, z_mac = t.mac_c;
+        ring_gemm(e, t.b.data(), z.data(), m, k, n, pool);
+        ring_gemm(t.a.data(), d, z.data(), m, k, n, pool);
+        ring_gemm(e, t.mac_b.data(), z_mac.data(), m, k, n, pool);
+        ring_gemm(t.mac_a.data(), d, z_mac.data(), m, k, n, pool);
+        if (party == 1) {
+            std::vector<uint64_t> ed(m * n, 0);
+            ring_gemm(e, d, ed.data(), m, k, n, pool);
+            for (size_t i = 0; i < m * n; ++i) {
+                z[i] += ed[i];
+                z_mac[i] += ed[i] * mac_key;
             }
         }
+        std::vector<LabeledShare> result(m * n);
+        for (size_t i = 0; i < m * n; ++i) {
+            result[i] = LabeledShare(z[i] & mask, z_mac[i] & mask, party, &spdz2k_field_size);
+        }
 
-        return result;
+        return truncate_batch(result, f);
     }
 
     std::vector<LabeledShare> tensor_sub(const std::vector<LabeledShare>& a, const std::vector<LabeledShare>& b) {
@@ -368,13 +612,15 @@ public:
 
     std::vector<LabeledShare> elementwise_multiply(const std::vector<LabeledShare>& a, const std::vector<LabeledShare>& b, int f) {
         assert(a.size() == b.size());
-        std::vector<LabeledShare> result(a.size());
-        for (size_t i = 0; i < a.size(); ++i) {
-            result[i] = multiply_with_trunc(a[i], b[i], f);
-        }
-        return result;
+        return multiply_with_trunc_batch(a, b, f);
     }
 
+private:
+    static void read_words(std::stringstream& ss, std::vector<uint64_t>& out) {
+        ss.read((char*)out.data(), out.size() * sizeof(uint64_t));
+        if ((size_t)ss.gcount() != out.size() * sizeof(uint64_t))
+            throw std::runtime_error("SPDZ2k: short batch message");
+    }
 };
 
 } // namespace emp
@@ -1,6 +1,7 @@
 #pragma once
 #include "testLLM/FixedPointConverter.h"
 #include "elgl_interface.hpp"
+#include "emp-aby/triple_store.hpp"
 #include <vector>
 #include <random>
 #include <chrono>
@@ -59,14 +60,22 @@ public:
             a = va & 1; b = vb & 1; c = vc & 1;
             mac_a = ma & 1; mac_b = mb & 1; mac_c = mc & 1;
         }
+
+        // Triple store record: one byte per bit.
+        static const size_t RECORD_BYTES = 6;
+        void encode(uint8_t* out) const {
+            out[0] = a; out[1] = b; out[2] = c;
+            out[3] = mac_a; out[4] = mac_b; out[5] = mac_c;
+        }
+        static Triple decode(const uint8_t* in) {
+            return Triple(in[0] & 1, in[1] & 1, in[2] & 1, in[3] & 1, in[4] & 1, in[5] & 1);
+        }
     };
 
-    std::vector<Triple> triples_pool;
+    TripleSupply<Triple> triples;
 
     void precompute_triples(size_t num_triples) {
-        for (size_t i = 0; i < num_triples; i++) {
-            generate_triple();
-        }
+        generate_triples(num_triples);
     }
     void generate_triple() {
         uint8_t a_local = rng() & 1;
@@ -90,16 +99,57 @@ public:
         uint8_t mac_a = a_local & mac_key;
         uint8_t mac_b = b_local & mac_key;
         uint8_t mac_c = c_local & mac_key;
-        triples_pool.emplace_back(a_local, b_local, c_local, mac_a, mac_b, mac_c);
+        triples.pool.emplace_back(a_local, b_local, c_local, mac_a, mac_b, mac_c);
     }
-    Triple get_triple() {
-        if (triples_pool.empty()) {
-            precompute_triples(10);
+    // Same as generate_triple, for count triples in one message per peer;
+    // the local a and b bits go packed eight to a byte.
+    void generate_triples(size_t count) {
+        if (count == 0) return;
+        size_t nbytes = (2 * count + 7) / 8;
+        std::vector<uint8_t> local(nbytes, 0), full, other(nbytes);
+        for (size_t j = 0; j < 2 * count; ++j) local[j / 8] |= (rng() & 1) << (j % 8);
+        full = local;
+        std::stringstream ss;
+        ss.write((const char*)local.data(), nbytes);
+        elgl->serialize_sendall_with_tag(ss, 7000 * party + party);
+        for (int i = 1; i <= num_parties; ++i) {
+            if (i != party) {
+                std::stringstream ss_recv;
+                elgl->deserialize_recv_with_tag(ss_recv, i, 7000 * i + i);
+                ss_recv.read((char*)other.data(), nbytes);
+                if ((size_t)ss_recv.gcount() != nbytes)
+                    throw std::runtime_error("TinyMAC: short message");
+                for (size_t j = 0; j < nbytes; ++j) full[j] ^= other[j];
+            }
         }
-        Triple t = triples_pool.back();
-        triples_pool.pop_back();
+        for (size_t j = 0; j < count; ++j) {
+            size_t ia = 2 * j, ib = 2 * j + 1;
+            uint8_t a_local = (local[ia / 8] >> (ia % 8)) & 1, b_local = (local[ib / 8] >> (ib % 8)) & 1;
+            uint8_t c_full = (full[ia / 8] >> (ia % 8)) & (full[ib / 8] >> (ib % 8)) & 1;
+            uint8_t c_local = (party == 1) ? c_full : 0;
+            triples.pool.emplace_back(a_local, b_local, c_local, a_local & mac_key, b_local & mac_key, c_local & mac_key);
+        }
+    }
+    Triple get_triple() {
+        Triple t;
+        triples.take(&t, 1, [this](size_t k) { generate_triples(k); });
         return t;
     }
+
+    // Offline run: writes count triples and the mac key to this party's
+    // store at path, generating batch triples per round.
+    void save_triples(const std::string& path, size_t count, size_t batch = 1 << 16) {
+        triples.save(path, "TINYMAC", num_parties, party, &mac_key, 1, triple_store_run_id(elgl), count, batch,
+                     [this](size_t k) { generate_triples(k); });
+    }
+    // Takes triples from a store save_triples wrote for this party, in the
+    // same run as the peers' stores, and adopts that run's mac key. Shares
+    // made before this call no longer verify.
+    void load_triples(const std::string& path) {
+        triples.load(path, "TINYMAC", num_parties, party);
+        mac_key = triples.store->key()[0] & 1;
+        check_triple_stores(elgl, *triples.store);
+    }
     bool check_mac(uint8_t value, uint8_t mac) const {
         return mac == (value & mac_key);
     }
@@ -0,0 +1,275 @@
+#pragma once
+#include "emp-aby/BSGS.hpp"
+#include "emp-aby/elgl_interface.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+namespace emp {
+
+// On-disk triple store: this header, padded to header_size, then count
+// fixed-size records written by the protocol's Triple::encode. One file per
+// party; key holds the mac key the macs were computed under and run the id
+// all parties agreed on for the offline run that wrote them.
+struct TripleStoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    char kind[8];
+    uint32_t num_party;
+    uint32_t party;
+    uint32_t record_size;
+    uint32_t key_size;
+    uint64_t count;
+    uint8_t key[64];
+    uint64_t run;
+};
+
+static const char TRIPLE_STORE_MAGIC[8] = {'T', 'R', 'I', 'P', 'L', 'E', 'S', '\0'};
+static const uint32_t TRIPLE_STORE_VERSION = 2;
+static const uint32_t TRIPLE_STORE_HEADER_SIZE = 256;
+
+// Appends records batch by batch and fills in the count on close(). The
+// file is written under path + ".tmp" and renamed, so readers never see a
+// partial store.
+class TripleStoreWriter {
+public:
+    TripleStoreWriter(const std::string& path, const char* kind, int num_party, int party, uint32_t record_size,
+                      const uint8_t* key, uint32_t key_size, uint64_t run)
+        : path(path), tmp_path(path + ".tmp") {
+        if (key_size > sizeof(header.key)) throw std::runtime_error("TripleStore: mac key too long");
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRIPLE_STORE_MAGIC, sizeof(header.magic));
+        header.version = TRIPLE_STORE_VERSION;
+        header.header_size = TRIPLE_STORE_HEADER_SIZE;
+        strncpy(header.kind, kind, sizeof(header.kind) - 1);
+        header.num_party = num_party;
+        header.party = party;
+        header.record_size = record_size;
+        header.key_size = key_size;
+        memcpy(header.key, key, key_size);
+        header.run = run;
+        out.open(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("TripleStore: cannot open file for writing");
+        write_header();
+    }
+    TripleStoreWriter(const TripleStoreWriter&) = delete;
+    TripleStoreWriter& operator=(const TripleStoreWriter&) = delete;
+    ~TripleStoreWriter() {
+        if (out.is_open()) {
+            out.close();
+            std::remove(tmp_path.c_str());
+        }
+    }
+
+    void append(const uint8_t* records, size_t n) {
+        out.write(reinterpret_cast<const char*>(records), n * header.record_size);
+        header.count += n;
+    }
+
+    void close() {
+        out.seekp(0);
+        write_header();
+        out.close();
+        if (out.fail() || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+            throw std::runtime_error("TripleStore: write failed");
+    }
+
+private:
+    std::string path, tmp_path;
+    std::ofstream out;
+    TripleStoreHeader header;
+
+    void write_header() {
+        char raw[TRIPLE_STORE_HEADER_SIZE] = {0};
+        memcpy(raw, &header, sizeof(header));
+        out.write(raw, TRIPLE_STORE_HEADER_SIZE);
+    }
+};
+
+// Read-only mapping of a store. take() claims records with one atomic
+// add, so any number of threads may consume without a lock.
+class TripleStore {
+public:
+    TripleStore(const std::string& path, const char* kind, int num_party, int party, uint32_t record_size) {
+        base = map_table_file(path.c_str(), TRIPLE_STORE_HEADER_SIZE, len);
+        memcpy(&header, base, sizeof(header));
+        char want[8] = {0};
+        strncpy(want, kind, sizeof(want) - 1);
+        const char* err = nullptr;
+        if (memcmp(header.magic, TRIPLE_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TRIPLE_STORE_VERSION || header.header_size != TRIPLE_STORE_HEADER_SIZE)
+            err = "TripleStore: not a triple store";
+        else if (memcmp(header.kind, want, sizeof(want)) != 0 || header.record_size != record_size)
+            err = "TripleStore: triples are for another protocol";
+        else if (header.num_party != (uint32_t)num_party || header.party != (uint32_t)party)
+            err = "TripleStore: triples are for another party";
+        else if (len < TRIPLE_STORE_HEADER_SIZE + header.count * record_size)
+            err = "TripleStore: truncated file";
+        if (err) {
+            munmap(base, len);
+            throw std::runtime_error(err);
+        }
+        records = static_cast<const uint8_t*>(base) + TRIPLE_STORE_HEADER_SIZE;
+        madvise(base, len, MADV_SEQUENTIAL);
+    }
+    TripleStore(const TripleStore&) = delete;
+    TripleStore& operator=(const TripleStore&) = delete;
+    ~TripleStore() { munmap(base, len); }
+
+    // Up to n consecutive records; got is how many, 0 once drained.
+    const uint8_t* take(size_t n, size_t& got) {
+        uint64_t at = cursor.fetch_add(n, std::memory_order_relaxed);
+        if (at >= header.count) {
+            got = 0;
+            return nullptr;
+        }
+        got = std::min<uint64_t>(n, header.count - at);
+        return records + at * header.record_size;
+    }
+
+    uint64_t size() const { return header.count; }
+    uint64_t consumed() const { return std::min<uint64_t>(cursor.load(std::memory_order_relaxed), header.count); }
+    uint64_t remaining() const { return header.count - consumed(); }
+    const uint8_t* key() const { return header.key; }
+    uint32_t key_size() const { return header.key_size; }
+    uint64_t run() const { return header.run; }
+
+private:
+    void* base = nullptr;
+    size_t len = 0;
+    TripleStoreHeader header;
+    const uint8_t* records = nullptr;
+    std::atomic<uint64_t> cursor{0};
+};
+
+struct TripleUsage {
+    uint64_t consumed = 0;    // handed out to multiplications
+    uint64_t from_store = 0;  // of those, read from a store
+    uint64_t generated = 0;   // made online
+    uint64_t refills = 0;     // generation rounds
+};
+
+// Where a protocol's multiplications get their triples: a loaded store is
+// drained first, then the in-memory pool. Whenever fewer than
+// low_watermark remain, the take() that noticed generates refill_batch more
+// in one round before returning, so that multiplication pays for the whole
+// round while the ones after it find triples in stock. Every party consumes
+// identically, so the refills line up.
+template <typename Triple>
+struct TripleSupply {
+    std::vector<Triple> pool;
+    std::unique_ptr<TripleStore> store;
+    TripleUsage usage;
+    size_t low_watermark = 16;
+    size_t refill_batch = 1024;
+
+    size_t available() const { return pool.size() + (store ? store->remaining() : 0); }
+
+    // gen(k) appends k fresh triples to pool.
+    template <typename Gen>
+    void take(Triple* out, size_t n, Gen&& gen) {
+        size_t done = 0;
+        if (store) {
+            const uint8_t* rec = store->take(n, done);
+            for (size_t i = 0; i < done; ++i) out[i] = Triple::decode(rec + i * Triple::RECORD_BYTES);
+            usage.from_store += done;
+        }
+        if (pool.size() < n - done) refill(std::max(n - done - pool.size(), refill_batch), gen);
+        std::copy(pool.end() - (n - done), pool.end(), out + done);
+        pool.resize(pool.size() - (n - done));
+        usage.consumed += n;
+        if (available() < low_watermark) refill(refill_batch, gen);
+    }
+
+    // Offline run: count triples made by gen in rounds of batch and
+    // streamed to path, tagged with run. The pool is left as it was.
+    template <typename Gen>
+    void save(const std::string& path, const char* kind, int num_party, int party, const uint8_t* key, uint32_t key_size,
+              uint64_t run, size_t count, size_t batch, Gen&& gen) {
+        TripleStoreWriter out(path, kind, num_party, party, Triple::RECORD_BYTES, key, key_size, run);
+        std::vector<uint8_t> buf;
+        for (size_t done = 0; done < count;) {
+            size_t k = std::min(batch, count - done);
+            size_t before = pool.size();
+            gen(k);
+            buf.resize(k * Triple::RECORD_BYTES);
+            for (size_t i = 0; i < k; ++i) pool[before + i].encode(buf.data() + i * Triple::RECORD_BYTES);
+            pool.resize(before);
+            out.append(buf.data(), k);
+            done += k;
+        }
+        out.close();
+    }
+
+    // Switches to the store at path. Pooled triples carry the old mac key
+    // and are dropped.
+    void load(const std::string& path, const char* kind, int num_party, int party) {
+        store.reset(new TripleStore(path, kind, num_party, party, Triple::RECORD_BYTES));
+        pool.clear();
+    }
+
+private:
+    template <typename Gen>
+    void refill(size_t k, Gen& gen) {
+        gen(k);
+        usage.generated += k;
+        ++usage.refills;
+    }
+};
+
+// Id of one offline run: the xor of a random word from every party, so all
+// stores written in the run carry the same value.
+template <typename IO>
+uint64_t triple_store_run_id(ELGL<IO>* elgl) {
+    uint64_t mine;
+    PRG prg;
+    prg.random_data(&mine, sizeof(mine));
+    std::stringstream ss;
+    ss << mine << " ";
+    elgl->serialize_sendall_with_tag(ss, 3100 * elgl->party + elgl->party);
+    uint64_t run = mine;
+    for (int i = 1; i <= elgl->num_party; ++i) {
+        if (i != elgl->party) {
+            std::stringstream ss_recv;
+            elgl->deserialize_recv_with_tag(ss_recv, i, 3100 * i + i);
+            uint64_t other;
+            ss_recv >> other;
+            run ^= other;
+        }
+    }
+    return run;
+}
+
+// Stores from different offline runs hold triples under unrelated mac
+// keys, and their sizes would put the parties' refills out of step, so the
+// parties compare run ids and sizes once after loading.
+template <typename IO>
+void check_triple_stores(ELGL<IO>* elgl, const TripleStore& store) {
+    std::stringstream ss;
+    ss << store.run() << " " << store.size() << " ";
+    elgl->serialize_sendall_with_tag(ss, 3000 * elgl->party + elgl->party);
+    bool same_run = true, same_size = true;
+    for (int i = 1; i <= elgl->num_party; ++i) {
+        if (i != elgl->party) {
+            std::stringstream ss_recv;
+            elgl->deserialize_recv_with_tag(ss_recv, i, 3000 * i + i);
+            uint64_t run, count;
+            ss_recv >> run >> count;
+            same_run  = same_run && run == store.run();
+            same_size = same_size && count == store.size();
+        }
+    }
+    if (!same_run) throw std::runtime_error("TripleStore: parties loaded stores from different offline runs");
+    if (!same_size) throw std::runtime_error("TripleStore: parties loaded stores of different sizes");
+}
+
+}  // namespace emp
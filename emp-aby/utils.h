@@ -1,5 +1,11 @@
 #pragma once
 #include "emp-tool/emp-tool.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 namespace emp {
 
 inline void andBlocks_arr(block* res, const block* x, const block* y, int nblocks) {
@@ -64,4 +70,92 @@ inline void bool_to_block_arr(block* a, bool* data, int bool_length) {
         a[i / 16] = makeBlock(high, low);
     }
 }
+
+// Shared chunk queue behind parallel_for / parallel_reduce. Workers claim
+// chunks from an atomic counter, so a thread that finishes early takes over
+// the remaining work of slower ones.
+struct ParallelRange {
+    size_t begin, end, grain, n_chunks;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex err_mtx;
+    std::exception_ptr err;
+
+    ParallelRange(size_t begin, size_t end, size_t grain)
+        : begin(begin), end(end), grain(grain), n_chunks((end - begin + grain - 1) / grain) {}
+
+    // Body is only touched after a chunk has been claimed; the caller waits
+    // for every claimed chunk, so late helpers never see a dangling body.
+    template <typename F>
+    void run(F* body) {
+        for (;;) {
+            size_t c = next.fetch_add(1, std::memory_order_relaxed);
+            if (c >= n_chunks)
+                return;
+            size_t l = begin + c * grain;
+            size_t r = std::min(end, l + grain);
+            try {
+                (*body)(c, l, r);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(err_mtx);
+                if (!err)
+                    err = std::current_exception();
+            }
+            done.fetch_add(1, std::memory_order_release);
+        }
+    }
+};
+
+inline size_t parallel_grain(ThreadPool* pool, size_t n, size_t grain) {
+    if (grain)
+        return grain;
+    size_t T = pool ? std::max<int>(1, pool->size()) : 1;
+    return std::max<size_t>(1, n / (8 * T));
+}
+
+// body(c, l, r) for chunk index c covering [l, r). The calling thread works
+// too and never waits on a helper that has not started, so nested calls from
+// inside pool tasks cannot deadlock.
+template <typename F>
+inline size_t parallel_chunks(ThreadPool* pool, size_t begin, size_t end, F body, size_t grain = 0) {
+    if (end <= begin)
+        return 0;
+    grain   = parallel_grain(pool, end - begin, grain);
+    auto st = std::make_shared<ParallelRange>(begin, end, grain);
+    if (pool && st->n_chunks > 1) {
+        size_t helpers = std::min<size_t>(pool->size(), st->n_chunks - 1);
+        auto* fn       = &body;
+        for (size_t h = 0; h < helpers; ++h)
+            pool->enqueue([st, fn]() { st->run(fn); });
+    }
+    st->run(&body);
+    while (st->done.load(std::memory_order_acquire) < st->n_chunks)
+        std::this_thread::yield();
+    if (st->err)
+        std::rethrow_exception(st->err);
+    return st->n_chunks;
+}
+
+// body(l, r) over [begin, end) in chunks of `grain` (default: ~8 per thread).
+template <typename F>
+inline void parallel_for(ThreadPool* pool, size_t begin, size_t end, F body, size_t grain = 0) {
+    parallel_chunks(pool, begin, end, [&body](size_t, size_t l, size_t r) { body(l, r); }, grain);
+}
+
+// map(l, r) -> T per chunk, folded left to right with combine, so the result
+// does not depend on scheduling.
+template <typename T, typename Map, typename Combine>
+inline T parallel_reduce(ThreadPool* pool, size_t begin, size_t end, T identity, Map map, Combine combine,
+                         size_t grain = 0) {
+    if (end <= begin)
+        return identity;
+    grain = parallel_grain(pool, end - begin, grain);
+    std::vector<T> partial((end - begin + grain - 1) / grain, identity);
+    parallel_chunks(pool, begin, end, [&](size_t c, size_t l, size_t r) { partial[c] = map(l, r); }, grain);
+    T acc = identity;
+    for (auto& v : partial)
+        acc = combine(acc, v);
+    return acc;
+}
 }  // namespace emp
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace emp {
+
+// Arithmetic in Z_2^63, the SPDZ2k share ring: wrapping uint64_t operations
+// followed by a mask, never a division.
+const uint64_t Z2K_MASK = (1ULL << 63) - 1;
+
+// SPDZ2k shares as two parallel arrays, so that kernels stream over plain
+// words instead of LabeledShare structs. Entries are kept reduced.
+struct Z2kShares {
+    std::vector<uint64_t> value, mac;
+    Z2kShares() = default;
+    explicit Z2kShares(size_t n) : value(n), mac(n) {}
+    size_t size() const { return value.size(); }
+    void resize(size_t n) {
+        value.resize(n);
+        mac.resize(n);
+    }
+};
+
+enum class Z2kIsa { SCALAR, AVX2, AVX512 };
+
+// The widest kernels this CPU runs; the build has no -march flag, so the
+// vector kernels are compiled per function and picked here at run time.
+// Assigning to it forces a narrower set, e.g. for benchmarks.
+inline Z2kIsa& z2k_isa() {
+#if defined(__x86_64__)
+    static Z2kIsa isa = __builtin_cpu_supports("avx512dq") ? Z2kIsa::AVX512
+                        : __builtin_cpu_supports("avx2")   ? Z2kIsa::AVX2
+                                                           : Z2kIsa::SCALAR;
+#else
+    static Z2kIsa isa = Z2kIsa::SCALAR;
+#endif
+    return isa;
+}
+
+// ADD  out = a + b        SUB  out = a - b        MUL_CONST  out = s a
+// AXPY out += s a         FMA  out += a b
+enum class Z2kOp { ADD, SUB, MUL_CONST, AXPY, FMA };
+
+template <Z2kOp op>
+inline void z2k_kernel_scalar(uint64_t* out, const uint64_t* a, const uint64_t* b, uint64_t s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t r;
+        if constexpr (op == Z2kOp::ADD) r = a[i] + b[i];
+        else if constexpr (op == Z2kOp::SUB) r = a[i] - b[i];
+        else if constexpr (op == Z2kOp::MUL_CONST) r = a[i] * s;
+        else if constexpr (op == Z2kOp::AXPY) r = out[i] + a[i] * s;
+        else r = out[i] + a[i] * b[i];
+        out[i] = r & Z2K_MASK;
+    }
+}
+
+// The local half of a Beaver multiplication in one pass:
+// out += e x + d y + w (e d), with w = 1 for values and the mac key for macs
+// on the party that adds the public term, 0 elsewhere.
+inline void z2k_beaver_scalar(uint64_t* out, const uint64_t* e, const uint64_t* d, const uint64_t* x, const uint64_t* y, uint64_t w, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = (out[i] + e[i] * x[i] + d[i] * y[i] + w * (e[i] * d[i])) & Z2K_MASK;
+}
+
+#if defined(__x86_64__)
+// AVX2 has no 64-bit low multiply: a b = lo(a) lo(b) + ((hi(a) lo(b) + lo(a) hi(b)) << 32).
+__attribute__((target("avx2"))) inline __m256i z2k_mullo_avx2(__m256i a, __m256i b) {
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+template <Z2kOp op>
+__attribute__((target("avx2"))) void z2k_kernel_avx2(uint64_t* out, const uint64_t* a, const uint64_t* b, uint64_t s, size_t n) {
+    const __m256i mask = _mm256_set1_epi64x(Z2K_MASK), vs = _mm256_set1_epi64x(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i)), r;
+        if constexpr (op == Z2kOp::ADD) r = _mm256_add_epi64(x, _mm256_loadu_si256((const __m256i*)(b + i)));
+        else if constexpr (op == Z2kOp::SUB) r = _mm256_sub_epi64(x, _mm256_loadu_si256((const __m256i*)(b + i)));
+        else if constexpr (op == Z2kOp::MUL_CONST) r = z2k_mullo_avx2(x, vs);
+        else if constexpr (op == Z2kOp::AXPY) r = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(out + i)), z2k_mullo_avx2(x, vs));
+        else r = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(out + i)),
+                                  z2k_mullo_avx2(x, _mm256_loadu_si256((const __m256i*)(b + i))));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_and_si256(r, mask));
+    }
+    z2k_kernel_scalar<op>(out + i, a + i, b ? b + i : nullptr, s, n - i);
+}
+
+template <Z2kOp op>
+__attribute__((target("avx512f,avx512dq"))) void z2k_kernel_avx512(uint64_t* out, const uint64_t* a, const uint64_t* b, uint64_t s, size_t n) {
+    const __m512i mask = _mm512_set1_epi64(Z2K_MASK), vs = _mm512_set1_epi64(s);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i), r;
+        if constexpr (op == Z2kOp::ADD) r = _mm512_add_epi64(x, _mm512_loadu_si512(b + i));
+        else if constexpr (op == Z2kOp::SUB) r = _mm512_sub_epi64(x, _mm512_loadu_si512(b + i));
+        else if constexpr (op == Z2kOp::MUL_CONST) r = _mm512_mullo_epi64(x, vs);
+        else if constexpr (op == Z2kOp::AXPY) r = _mm512_add_epi64(_mm512_loadu_si512(out + i), _mm512_mullo_epi64(x, vs));
+        else r = _mm512_add_epi64(_mm512_loadu_si512(out + i), _mm512_mullo_epi64(x, _mm512_loadu_si512(b + i)));
+        _mm512_storeu_si512(out + i, _mm512_and_si512(r, mask));
+    }
+    z2k_kernel_scalar<op>(out + i, a + i, b ? b + i : nullptr, s, n - i);
+}
+
+__attribute__((target("avx512f,avx512dq"))) inline void z2k_beaver_avx512(uint64_t* out, const uint64_t* e, const uint64_t* d, const uint64_t* x, const uint64_t* y, uint64_t w, size_t n) {
+    const __m512i mask = _mm512_set1_epi64(Z2K_MASK), vw = _mm512_set1_epi64(w);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i ve = _mm512_loadu_si512(e + i), vd = _mm512_loadu_si512(d + i);
+        __m512i r = _mm512_add_epi64(_mm512_loadu_si512(out + i), _mm512_mullo_epi64(ve, _mm512_loadu_si512(x + i)));
+        r = _mm512_add_epi64(r, _mm512_mullo_epi64(vd, _mm512_loadu_si512(y + i)));
+        if (w) r = _mm512_add_epi64(r, _mm512_mullo_epi64(vw, _mm512_mullo_epi64(ve, vd)));
+        _mm512_storeu_si512(out + i, _mm512_and_si512(r, mask));
+    }
+    z2k_beaver_scalar(out + i, e + i, d + i, x + i, y + i, w, n - i);
+}
+#endif
+
+template <Z2kOp op>
+inline void z2k_kernel(uint64_t* out, const uint64_t* a, const uint64_t* b, uint64_t s, size_t n) {
+#if defined(__x86_64__)
+    switch (z2k_isa()) {
+    case Z2kIsa::AVX512: return z2k_kernel_avx512<op>(out, a, b, s, n);
+    case Z2kIsa::AVX2: return z2k_kernel_avx2<op>(out, a, b, s, n);
+    default: break;
+    }
+#endif
+    z2k_kernel_scalar<op>(out, a, b, s, n);
+}
+
+inline void z2k_add(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n) { z2k_kernel<Z2kOp::ADD>(out, a, b, 0, n); }
+inline void z2k_sub(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n) { z2k_kernel<Z2kOp::SUB>(out, a, b, 0, n); }
+inline void z2k_mul_const(uint64_t* out, const uint64_t* a, uint64_t s, size_t n) { z2k_kernel<Z2kOp::MUL_CONST>(out, a, nullptr, s, n); }
+inline void z2k_axpy(uint64_t* out, const uint64_t* a, uint64_t s, size_t n) { z2k_kernel<Z2kOp::AXPY>(out, a, nullptr, s, n); }
+inline void z2k_fma(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n) { z2k_kernel<Z2kOp::FMA>(out, a, b, 0, n); }
+
+inline void z2k_beaver(uint64_t* out, const uint64_t* e, const uint64_t* d, const uint64_t* x, const uint64_t* y, uint64_t w, size_t n) {
+#if defined(__x86_64__)
+    // With AVX2 each 64-bit product costs three 32-bit ones, which loses to
+    // scalar multiplies at up to four products per entry.
+    if (z2k_isa() == Z2kIsa::AVX512) return z2k_beaver_avx512(out, e, d, x, y, w, n);
+#endif
+    z2k_beaver_scalar(out, e, d, x, y, w, n);
+}
+
+}  // namespace emp
@@ -1,4 +1,5 @@
 #include "libelgl/elgl/BLS12381Element.h"
+#include "libelgl/elgl/FixedBase.h"
 #include <mcl/bn.hpp>
 
 using namespace mcl::bn;
@@ -12,12 +13,11 @@ BLS12381Element::BLS12381Element(){
     point.clear();
 }
 
+// g^other through the shared generator table.
 BLS12381Element::BLS12381Element(const Fr& other) :
         BLS12381Element()
 {
-    std::string g1Str = "1 0x17f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb 0x08b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1";
-    point.setStr(g1Str);
-    G1::mul(point, point, other);
+    FixedBase::generator().mul(point, other);
 }
 
 BLS12381Element::BLS12381Element(const BLS12381Element& other){
@@ -90,20 +90,21 @@ bool BLS12381Element::operator!=(const BLS12381Element& other) const{
     return point != other.point;
 }
 
+// Wire format: 48-byte compressed point.
 void BLS12381Element::pack(std::stringstream& os, int) const{
-    point.save(os);
+    point.save(os, mcl::IoSerialize);
 }
 
 void BLS12381Element::pack(cybozu::MemoryOutputStream& os) const{
-    point.save(os);
+    point.save(os, mcl::IoSerialize);
 }
 
 void BLS12381Element::unpack(std::stringstream& os, int){
-    point.load(os);
+    point.load(os, mcl::IoSerialize);
 }
 
 void BLS12381Element::unpack(cybozu::MemoryInputStream& is) {
-    point.load(is);
+    point.load(is, mcl::IoSerialize);
 }
 
 std::ostream& operator<<(std::ostream& s, const BLS12381Element& x){
@@ -129,9 +130,14 @@ BLS12381Element operator*(const Fr& a, const BLS12381Element& b){
 }
 
 BLS12381Element BLS12381Element::generator() {
+    static const G1 g1 = [] {
+        G1 p;
+        std::string g1Str = "1 0x17f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb 0x08b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1";
+        p.setStr(g1Str);
+        return p;
+    }();
     BLS12381Element g;
-    std::string g1Str = "1 0x17f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb 0x08b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1";
-    g.point.setStr(g1Str);
+    g.point = g1;
     return g;
 }
 
@@ -66,6 +66,11 @@ class Ciphertext{
         c1.unpack(os);
     };
 
+    void unpack(cybozu::MemoryInputStream& is){
+        c0.unpack(is);
+        c1.unpack(is);
+    };
+
     size_t report_size() const{
         return G1::getSerializedByteSize() * 2;
     };
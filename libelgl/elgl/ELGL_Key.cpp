@@ -4,32 +4,39 @@ ELGL_PK::ELGL_PK(ELGL_SK& sk){
     pk = BLS12381Element(sk.get_sk());
 }
 
+void ELGL_PK::precompute(){
+    if (!pk_table)
+        pk_table = std::make_shared<const FixedBase>(pk);
+}
+
+BLS12381Element ELGL_PK::pk_mul(const Fr& r) const{
+    return pk_table ? *pk_table * r : pk * r;
+}
+
 void ELGL_PK::encrypt(Ciphertext &c, const Plaintext& m) const{
     Fr r;
     r.setByCSPRNG();
-    BLS12381Element rG1 = BLS12381Element(r);
-    c = Ciphertext(rG1, pk * r + BLS12381Element(m.get_message()));
+    encrypt(c, m, r);
 }
 
 Ciphertext ELGL_PK::encrypt(const Plaintext& m) const{
     Fr r;
     r.setByCSPRNG();
-    BLS12381Element rG1 = BLS12381Element(r);
-    return Ciphertext(rG1, pk * r + BLS12381Element(m.get_message()));
+    return encrypt(m, r);
 }
 
 void ELGL_PK::encrypt(Ciphertext& c, const Plaintext& mess, const Random_C rc) const{
-    BLS12381Element rG1 = BLS12381Element(rc);
-    c = Ciphertext(rG1, pk * rc + BLS12381Element(mess.get_message()));
+    c = encrypt(mess, rc);
 }
 
 Ciphertext ELGL_PK::encrypt(const Plaintext& mess, const Random_C rc) const{
     BLS12381Element rG1 = BLS12381Element(rc);
-    return Ciphertext(rG1, pk * rc + BLS12381Element(mess.get_message()));
+    return Ciphertext(rG1, pk_mul(rc) + BLS12381Element(mess.get_message()));
 }
 
 void ELGL_PK::KeyGen(ELGL_SK & sk){
     pk = BLS12381Element(sk.get_sk());
+    pk_table.reset();
 }
 void ELGL_SK::decrypt(BLS12381Element &m, const Ciphertext& c) const{
     BLS12381Element tmp = c.get_c0() * sk;
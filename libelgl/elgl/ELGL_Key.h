@@ -4,7 +4,9 @@
 #include "libelgl/elgl/Ciphertext.h"
 #include "libelgl/elgl/BLS12381Element.h"
 #include "libelgl/elgl/Plaintext.h"
+#include "libelgl/elgl/FixedBase.h"
 #include <map>
+#include <memory>
 class ELGL_PK;
 class Ciphertext;
 class ELGL_SK{
@@ -58,10 +60,19 @@ class ELGL_SK{
 
 class ELGL_PK{
     BLS12381Element pk;
+    // Optional fixed-base table for pk, shared by copies of this key.
+    std::shared_ptr<const FixedBase> pk_table;
     public:
     typedef Fr Random_C;
     BLS12381Element get_pk() const{return pk;};
-    void assign_pk(const BLS12381Element& pk_){pk = pk_;};
+    void assign_pk(const BLS12381Element& pk_){pk = pk_; pk_table.reset();};
+
+    // Builds the fixed-base table for pk; a no-op if it already exists.
+    void precompute();
+    bool precomputed() const{return pk_table != nullptr;};
+
+    // pk^r, through the table when one has been built.
+    BLS12381Element pk_mul(const Fr& r) const;
 
     ELGL_PK(){pk = BLS12381Element();};
 
@@ -80,7 +91,7 @@ class ELGL_PK{
 
     void pack(std::stringstream& os) const {pk.pack(os);};
 
-    void unpack(std::stringstream& os) {pk.unpack(os);};
+    void unpack(std::stringstream& os) {pk.unpack(os); pk_table.reset();};
 
     static bool DeserializFromFile(std::string filepath, ELGL_PK& p);
     static bool SerializeToFile(std::string filepath, ELGL_PK& p);
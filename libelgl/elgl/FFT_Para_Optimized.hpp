@@ -2,76 +2,96 @@
 #include <vector>
 #include <cassert>
 #include <future>
+#include <algorithm>
 #include "BLS12381Element.h"
+#include "emp-aby/utils.h"
 #include <mcl/bn.hpp>
 
 using namespace mcl::bn;
 
-void FFT_recursive_para(
-    const std::vector<BLS12381Element>& a,
-    std::vector<BLS12381Element>& A,
-    const Fr& omega,
-    size_t n,
-    int depth = 2
-) {
-    if (n == 1) {
-        A[0] = a[0];
-        return;
-    }
+// Runs body(l, r) over [0, n), one contiguous range per pool thread.
+template <typename F>
+inline void fft_pool_for(size_t n, ThreadPool* pool, F body) {
+    size_t T = std::max<size_t>(1, pool->size());
+    emp::parallel_for(pool, 0, n, body, (n + T - 1) / T);
+}
 
-    size_t m = n / 2;
-    std::vector<BLS12381Element> a_even(m), a_odd(m);
-    std::vector<BLS12381Element> A_even(m), A_odd(m);
+// Iterative radix-2 Cooley-Tukey over G1: bit-reversal permutation, then
+// log n butterfly stages, each split across the pool. Points stay in
+// Jacobian coordinates until a final batch normalization.
+inline void FFT_Para(std::vector<BLS12381Element>& a, const Fr& omega, ThreadPool* pool) {
+    const size_t n = a.size();
+    assert((n & (n - 1)) == 0);
+    if (n <= 1) return;
+    int logn = 0;
+    while ((size_t(1) << logn) < n) ++logn;
 
-    for (size_t i = 0; i < m; ++i) {
-        a_even[i] = a[2 * i];
-        a_odd[i] = a[2 * i + 1];
-    }
+    fft_pool_for(n, pool, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
+            size_t j = 0;
+            for (int b = 0; b < logn; ++b) j |= ((i >> b) & 1) << (logn - 1 - b);
+            if (i < j) std::swap(a[i].point, a[j].point);
+        }
+    });
 
-    Fr omega_squared = omega * omega;
+    const size_t h = n / 2;
+    std::vector<Fr> w(h);
+    fft_pool_for(h, pool, [&](size_t l, size_t r) {
+        Fr::pow(w[l], omega, l);
+        for (size_t k = l + 1; k < r; ++k) w[k] = w[k - 1] * omega;
+    });
 
-    if (depth > 0) {
-        auto fut_even = std::async(std::launch::async, FFT_recursive_para, std::cref(a_even), std::ref(A_even), omega_squared, m, depth - 1);
-        FFT_recursive_para(a_odd, A_odd, omega_squared, m, depth - 1);
-        fut_even.get();
-    } else {
-        FFT_recursive_para(a_even, A_even, omega_squared, m, 0);
-        FFT_recursive_para(a_odd, A_odd, omega_squared, m, 0);
+    for (size_t m = 2; m <= n; m <<= 1) {
+        const size_t mh = m >> 1;
+        const size_t stride = n / m;
+        fft_pool_for(h, pool, [&](size_t l, size_t r) {
+            G1 t;
+            for (size_t b = l; b < r; ++b) {
+                size_t j = b & (mh - 1);
+                size_t i = (b - j) * 2 + j;
+                G1& u = a[i].point;
+                G1& v = a[i + mh].point;
+                if (j == 0) t = v;
+                else G1::mul(t, v, w[j * stride]);
+                G1::sub(v, u, t);
+                G1::add(u, u, t);
+            }
+        });
     }
 
-    Fr w = 1;
-    for (size_t j = 0; j < m; ++j) {
-        BLS12381Element t = A_odd[j] * w;
-        A[j] = A_even[j] + t;
-        A[j + m] = A_even[j] - t;
-        w *= omega;
-    }
+    fft_pool_for(n, pool, [&](size_t l, size_t r) {
+        std::vector<G1> buf(r - l);
+        for (size_t i = l; i < r; ++i) buf[i - l] = a[i].point;
+        G1::normalizeVec(buf.data(), buf.data(), r - l);
+        for (size_t i = l; i < r; ++i) a[i].point = buf[i - l];
+    });
 }
 
-void FFT_Para(
+inline void FFT_Para(
     const std::vector<BLS12381Element>& input,
     std::vector<BLS12381Element>& output,
     const Fr& omega,
-    size_t n
+    size_t n,
+    ThreadPool* pool
 ) {
-    assert((n & (n - 1)) == 0); 
     assert(n == input.size());
-    output.resize(n);
-    FFT_recursive_para(input, output, omega, n, 3);
+    output = input;
+    FFT_Para(output, omega, pool);
 }
 
-void IFFT_Para(
+inline void IFFT_Para(
     const std::vector<BLS12381Element>& input,
     std::vector<BLS12381Element>& output,
     const Fr& omega,
-    size_t n
+    size_t n,
+    ThreadPool* pool
 ) {
     Fr omega_inv;
     Fr::inv(omega_inv, omega);
-    FFT_Para(input, output, omega_inv, n);
+    FFT_Para(input, output, omega_inv, n, pool);
     Fr inv_n;
     Fr::inv(inv_n, Fr(n));
-    for (auto& e : output) {
-        e *= inv_n;
-    }
+    fft_pool_for(n, pool, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) output[i] *= inv_n;
+    });
 }
@@ -0,0 +1,21 @@
+#include "libelgl/elgl/FixedBase.h"
+
+FixedBase::FixedBase(const BLS12381Element& base, size_t win){
+    wm.init(base.point, Fr::getBitSize(), win);
+}
+
+void FixedBase::mul(G1& out, const Fr& k) const{
+    wm.mul(out, k);
+}
+
+BLS12381Element FixedBase::operator*(const Fr& k) const{
+    BLS12381Element res;
+    wm.mul(res.point, k);
+    res.point.normalize();
+    return res;
+}
+
+const FixedBase& FixedBase::generator(){
+    static const FixedBase g(BLS12381Element::generator());
+    return g;
+}
@@ -0,0 +1,23 @@
+#ifndef BLS12381_FIXEDBASE_H_
+#define BLS12381_FIXEDBASE_H_
+#include "libelgl/elgl/BLS12381Element.h"
+#include <mcl/window_method.hpp>
+
+// Precomputed multiples of a fixed point: with w-bit windows, base * k is
+// ceil(255 / w) table additions and no doublings. Read-only after
+// construction, so one table can be shared by every thread.
+class FixedBase{
+    mcl::fp::WindowMethod<G1> wm;
+
+    public:
+    static const size_t kWindow = 8;
+
+    explicit FixedBase(const BLS12381Element& base, size_t win = kWindow);
+
+    void mul(G1& out, const Fr& k) const;
+    BLS12381Element operator*(const Fr& k) const;
+
+    // Table for BLS12381Element::generator(), built on first use.
+    static const FixedBase& generator();
+};
+#endif
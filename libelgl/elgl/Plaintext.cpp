@@ -1,5 +1,6 @@
 #include "libelgl/elgl/Plaintext.h"
 #include <fstream>
+#include <stdexcept>
 
 Plaintext::Plaintext(){
     message.clear();
@@ -44,6 +45,10 @@ void Plaintext::assign(const mpz_class num){
     message.setMpz(num);
 }
 
+void Plaintext::assign_uint64(uint64_t num){
+    message.setArray(&num, 1);
+}
+
 void Plaintext::add(Plaintext &z, const Plaintext &x, const Plaintext &y) const{
     Fr::add(z.message, x.message, y.message);
 }
@@ -61,14 +66,7 @@ void Plaintext::sqr(Plaintext &z, const Plaintext &x) const{
 }
 
 void Plaintext::pow(Plaintext &ret, const Plaintext &x, const Plaintext &exp){
-    mpz_class a_mpz, b_mpz, p_mpz, result;
-    x.get_message().getMpz(a_mpz);
-    exp.get_message().getMpz(b_mpz);
-    std::string p;
-    Fr::getModulo(p);
-    p_mpz.setStr(p, 10);
-    mcl::gmp::powMod(result, a_mpz, b_mpz, p_mpz);
-    ret.assign(result);
+    Fr::pow(ret.message, x.message, exp.message);
 }
 
 
@@ -80,23 +78,38 @@ bool Plaintext::equals(const Plaintext &other) const{
     return message == other.message;
 }
 
+// Wire format: 32-byte serialized scalar.
 void Plaintext::pack(std::stringstream& os) const{
-    this->message.save(os);
+    this->message.save(os, mcl::IoSerialize);
 }
 void Plaintext::unpack(std::stringstream& os){
-    message.load(os);
+    message.load(os, mcl::IoSerialize);
+}
+void Plaintext::unpack(cybozu::MemoryInputStream& is){
+    message.load(is, mcl::IoSerialize);
 }
 
 uint64_t Plaintext::to_uint64() const {
-    std::string str = message.getStr(10); 
-    return static_cast<uint64_t>(std::stoull(str));
+    mcl::fp::Block b;
+    message.getBlock(b);
+    for (size_t i = 1; i < b.n; i++)
+        if (b.p[i] != 0) throw std::out_of_range("Plaintext::to_uint64: value exceeds 64 bits");
+    return b.p[0];
+}
+
+uint64_t Plaintext::mod_uint64(uint64_t modulus) const {
+    if (modulus == 0) throw std::invalid_argument("Plaintext::mod_uint64: zero modulus");
+    mcl::fp::Block b;
+    message.getBlock(b);
+    if ((modulus & (modulus - 1)) == 0) return b.p[0] & (modulus - 1);
+    unsigned __int128 r = 0;
+    for (size_t i = b.n; i-- > 0;)
+        r = ((r << 64) | b.p[i]) % modulus;
+    return (uint64_t)r;
 }
 
 void Plaintext::xor_op(Plaintext &z, const Plaintext &x, const Plaintext &y) const {
-    uint64_t x_val = x.to_uint64();
-    uint64_t y_val = y.to_uint64();
-    uint64_t result = x_val ^ y_val; 
-    z.assign(std::to_string(result)); 
+    z.assign_uint64(x.to_uint64() ^ y.to_uint64());
 }
 
 Plaintext Plaintext::operator^(const Plaintext &other) const {
@@ -111,17 +124,20 @@ Plaintext Plaintext::operator^=(const Plaintext &other) {
 }
 
 void Plaintext::mod(Plaintext &z, const Plaintext &x, const Plaintext &modulus) const {
-    mcl::Vint x_vint, mod_vint, result;
-    x_vint.setStr(x.get_message().getStr(10)); 
-    mod_vint.setStr(modulus.get_message().getStr(10));
-    result = x_vint % mod_vint;
-    z.assign(result.getStr(10)); 
+    mcl::fp::Block m;
+    modulus.get_message().getBlock(m);
+    bool small = m.p[0] != 0;
+    for (size_t i = 1; i < m.n; i++) small = small && m.p[i] == 0;
+    if (small) {
+        z.assign_uint64(x.mod_uint64(m.p[0]));
+        return;
+    }
+    mcl::Vint result = x.get_message().getMpz() % modulus.get_message().getMpz();
+    z.assign(result);
 }
 
 void Plaintext::mod2(Plaintext &z, const Plaintext &x) const {
-    uint64_t x_val = x.to_uint64();
-    uint64_t result = x_val & 1;
-    z.assign(std::to_string(result));
+    z.assign_uint64(x.mod_uint64(2));
 }
 
 Plaintext Plaintext::operator%(const Plaintext &modulus) const {
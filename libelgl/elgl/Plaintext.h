@@ -17,6 +17,7 @@ class Plaintext{
     void set_random(mcl::Vint bound);
     void assign(const std::string num);
     void assign(const mpz_class num);
+    void assign_uint64(uint64_t num);
     const Fr& get_message() const{return message;};
     void set_message(const Fr& message_){message = message_;};
 
@@ -88,11 +89,14 @@ class Plaintext{
 
     void pack(std::stringstream& os) const;
     void unpack(std::stringstream& os);
+    void unpack(cybozu::MemoryInputStream& is);
 
     static bool DeserializFromFile(std::string filepath, Plaintext& p);
     static bool SerializeToFile(std::string filepath, Plaintext& p);
 
     uint64_t to_uint64() const;
+    // Canonical value mod modulus, from the limbs; no Vint or string.
+    uint64_t mod_uint64(uint64_t modulus) const;
     void xor_op(Plaintext &z, const Plaintext &x, const Plaintext &y) const;
     Plaintext operator^(const Plaintext &other) const;
     Plaintext operator^=(const Plaintext &other);
@@ -32,7 +32,7 @@ size_t CommitProver::NIZKPoK(CommProof& P, std::stringstream& ciphertexts,
         c_0 = BLS12381Element(r1[i].get_message());
         c_0.pack(ciphertexts);
 
-        tmp_ = pk.get_pk() * r1[i].get_message();
+        tmp_ = pk.pk_mul(r1[i].get_message());
         
         c_1 = BLS12381Element(r2[i].get_message());
         c_1 += tmp_;
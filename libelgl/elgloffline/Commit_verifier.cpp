@@ -37,7 +37,7 @@ void CommitVerifier::NIZKPoK(vector<Ciphertext>& c,vector<BLS12381Element>& y3,
         t3.unpack(ciphertexts);
         
         gsr = BLS12381Element(sr_tmp.get_message());
-        hsr = pk.get_pk() * sr_tmp.get_message();
+        hsr = pk.pk_mul(sr_tmp.get_message());
         
         gsxhsr = BLS12381Element(sx_tmp.get_message());
         gsxhsr += hsr;
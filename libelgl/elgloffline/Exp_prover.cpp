@@ -4,16 +4,6 @@ ExpProver::ExpProver(ExpProof& proof) {
     k.resize(proof.n_proofs);
 }
 
-struct thread1Ret
-{
-    BLS12381Element v;
-};
-
-struct thread2Ret
-{
-    Plaintext s;
-};
-
 size_t ExpProver::NIZKPoK(ExpProof& P, std::stringstream&  ciphertexts, std::stringstream&  cleartexts,
     const BLS12381Element& g1,
     const vector<BLS12381Element>& y1,
@@ -27,79 +17,67 @@ size_t ExpProver::NIZKPoK(ExpProof& P, std::stringstream&  ciphertexts, std::str
         y2[i].pack(ciphertexts);
     }
     z.setHashof(ciphertexts.str().c_str(), ciphertexts.str().size()); 
-    std::vector<std::future<thread1Ret>> futures1;
-    for (int i = 0; i < P.n_proofs; i++) {
-        futures1.emplace_back(pool->enqueue([this, &g1, &z, i]() -> thread1Ret {
-            BLS12381Element v;
-            this->k[i].set_random();
-            v = BLS12381Element(z.get_message()) + g1;
-            v = v * k[i].get_message();
-            return {v};
-        }));
-    }
-
-    for (auto& f : futures1) {
-        thread1Ret result = f.get();
-        result.v.pack(ciphertexts);
-    }
+    BLS12381Element base = BLS12381Element(z.get_message()) + g1;
+    vector<BLS12381Element> v(P.n_proofs);
+    emp::parallel_for(pool, 0, P.n_proofs, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
+            k[i].set_random();
+            v[i] = base * k[i].get_message();
+        }
+    });
+    for (auto& vi : v)
+        vi.pack(ciphertexts);
 
     P.set_challenge(ciphertexts);
 
 
-    std::vector<std::future<thread2Ret>> futures2;
     // s = k - x * challenge
-    for (int i = 0; i < P.n_proofs; i++){
-        futures2.emplace_back(pool->enqueue([this, &x, &P, i]() -> thread2Ret {
-            Plaintext s;
-            s = this->k[i];
-            s -= x[i] * P.challenge;
-            return {s};
-        }));
-    }
-
-    for (auto & f : futures2) {
-        thread2Ret result = f.get();
-        result.s.pack(cleartexts);
-    }
-    futures1.clear();
-    futures2.clear();
+    vector<Plaintext> s(P.n_proofs);
+    emp::parallel_for(pool, 0, P.n_proofs, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
+            s[i] = k[i];
+            s[i] -= x[i] * P.challenge;
+        }
+    });
+    for (auto& si : s)
+        si.pack(cleartexts);
     return report_size();
 }
 
 size_t ExpProver::NIZKPoK_(ExpProof& P, std::stringstream& sendss,
-    const BLS12381Element& pk_tmp,
+    const BLS12381Element& pk,
     const vector<BLS12381Element>& a,
     const vector<BLS12381Element>& ask,
     const Plaintext& x, ThreadPool* pool){
     if(a.size() != ask.size()){
         throw std::invalid_argument("a and ask must have the same size");
     }
+    std::stringstream buf;
+    pk.pack(buf);
     for (size_t i = 0; i < ask.size(); i++){
         ask[i].pack(sendss);
+        ask[i].pack(buf);
     }
     vector<Plaintext> z(a.size());
     vector<BLS12381Element> Z(a.size());
-    vector<std::future<void>> futs1;
-    for (size_t i = 0; i < a.size(); i++) {
-        futs1.emplace_back(pool->enqueue([&Z, &z, i, &a]() {
+    emp::parallel_for(pool, 0, a.size(), [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
             z[i].set_random();
             Z[i] = a[i] * z[i].get_message();
-        }));
-    }
-    for (auto& f : futs1) f.get(); futs1.clear();
+        }
+    });
 
     for (size_t i = 0; i < ask.size(); i++){
         Z[i].pack(sendss);
+        Z[i].pack(buf);
     }
-    P.set_challenge(sendss);
+    P.set_challenge(buf);
     vector<Plaintext> s(a.size());
-    vector<std::future<void>> futs2;
-    for (size_t i = 0; i < ask.size(); i++){
-        futs2.emplace_back(pool->enqueue([&s, &z, &x, &P, i]() {
-            s[i] = z[i] - x * P.challenge;
-        }));
-    }
-    for (auto& f : futs2) f.get(); futs2.clear();
+    Plaintext xc = x * P.challenge;
+    emp::parallel_for(pool, 0, ask.size(), [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++)
+            s[i] = z[i] - xc;
+    });
 
     for (size_t i = 0; i < ask.size(); i++){
         s[i].pack(sendss);
@@ -25,8 +25,10 @@ class ExpProver{
         const BLS12381Element& y2,
         const Plaintext& x, int i, ThreadPool* pool);
 
+    // pk is not sent, but is hashed into the challenge so the proof only
+    // verifies against the prover's own key.
     size_t NIZKPoK_(ExpProof& P, std::stringstream& sendss,
-    const BLS12381Element& pk_tmp,
+    const BLS12381Element& pk,
     const vector<BLS12381Element>& a,
     const vector<BLS12381Element>& ask,
     const Plaintext& x, ThreadPool* pool);
@@ -1,4 +1,5 @@
 #include "Exp_verifier.h"
+#include "MSM.h"
 #include <future>
 ExpVerifier::ExpVerifier(ExpProof& proof) :
     P(proof)
@@ -27,36 +28,43 @@ void ExpVerifier::NIZKPoK(BLS12381Element& g1, vector<BLS12381Element>& y1,vecto
 
     z.setHashof(buf.str().c_str(), buf.str().size()); 
 
-    BLS12381Element t1, t2, t3;
     std::vector<Plaintext> s(P.n_proofs);
     std::vector<BLS12381Element> v(P.n_proofs);
     for (int i = 0; i < P.n_proofs; i++){
         s[i].unpack(cleartexts);
         v[i].unpack(ciphertexts);
     }
-    vector<std::future<void>> futures;
-    for (int i = 0; i < P.n_proofs; i++){
-        futures.emplace_back(pool->enqueue([this, &g1, &z, i, &s, &v, &y1, &y2]() {
-            BLS12381Element Right1, Right2;
-            Right1 = BLS12381Element(z.get_message()) + g1;
-            Right1 = Right1 * s[i].get_message();
-            Right2 = y1[i] * z.get_message() + y2[i];
-            Right2 = Right2 * P.challenge.get_message();
 
-            Right1 += Right2;
-            if (v[i] != Right1 ){
-                throw runtime_error("invalid exp proof");
-            }
-        }));
+    // v_i == s_i * (g^z + g1) + c * (z * y1_i + y2_i) for all i, folded with
+    // random weights r_i into a single MSM that must vanish.
+    const Fr& c = P.challenge.get_message();
+    Fr cz = c * z.get_message();
+    std::vector<Fr> r = batch_weights(P.n_proofs);
+    std::vector<BLS12381Element> points;
+    std::vector<Fr> scalars;
+    points.reserve(3 * P.n_proofs + 1);
+    scalars.reserve(3 * P.n_proofs + 1);
+    Fr rs = 0;
+    for (int i = 0; i < P.n_proofs; i++){
+        rs += r[i] * s[i].get_message();
+        points.push_back(v[i]);
+        scalars.push_back(r[i]);
+        points.push_back(y1[i]);
+        scalars.push_back(-(cz * r[i]));
+        points.push_back(y2[i]);
+        scalars.push_back(-(c * r[i]));
     }
-    for (auto& f : futures) {
-        f.get();
+    points.push_back(BLS12381Element(z.get_message()) + g1);
+    scalars.push_back(-rs);
+    if (!msm(points, scalars, pool).point.isZero()){
+        throw runtime_error("invalid exp proof");
     }
 }
 
-void ExpVerifier::NIZKPoK_(BLS12381Element pk_tmp, vector<BLS12381Element>& a, vector<BLS12381Element>& ask, std::stringstream& recvss, ThreadPool* pool){
+void ExpVerifier::NIZKPoK_(const BLS12381Element& pk, vector<BLS12381Element>& a, vector<BLS12381Element>& ask, std::stringstream& recvss, ThreadPool* pool){
     recvss.seekg(0);
     std::stringstream buf;
+    pk.pack(buf);
     vector<BLS12381Element> Z(a.size());
     vector<Plaintext> z(a.size());
     for (size_t i = 0; i < a.size(); i++){
@@ -72,17 +80,25 @@ void ExpVerifier::NIZKPoK_(BLS12381Element pk_tmp, vector<BLS12381Element>& a, v
     for (size_t i = 0; i < a.size(); i++){
         s[i].unpack(recvss);
     }
-    vector<std::future<void>> futs2;
-    Plaintext tmp = P.challenge;
+
+    // Z_i == a_i * s_i + ask_i * c, folded with random weights.
+    const Fr& c = P.challenge.get_message();
+    std::vector<Fr> r = batch_weights(a.size());
+    std::vector<BLS12381Element> points;
+    std::vector<Fr> scalars;
+    points.reserve(3 * a.size());
+    scalars.reserve(3 * a.size());
     for (size_t i = 0; i < a.size(); i++){
-        futs2.emplace_back(pool->enqueue([&s, &z, &tmp, i, &ask, &a, &Z]() {
-            BLS12381Element r1 = a[i] * s[i].get_message() + ask[i] * tmp.get_message();
-            // if (Z[i] != r1){
-            //     throw runtime_error("invalid exp proof");
-            // }
-        }));
+        points.push_back(Z[i]);
+        scalars.push_back(r[i]);
+        points.push_back(a[i]);
+        scalars.push_back(-(r[i] * s[i].get_message()));
+        points.push_back(ask[i]);
+        scalars.push_back(-(r[i] * c));
+    }
+    if (!msm(points, scalars, pool).point.isZero()){
+        throw runtime_error("invalid exp proof");
     }
-    for (auto& f : futs2) f.get(); futs2.clear();
 }
 
 void ExpVerifier::NIZKPoK(BLS12381Element& g1, BLS12381Element& y1, BLS12381Element& y2, std::stringstream& ciphertexts, std::stringstream& cleartexts, ThreadPool* pool, int i){
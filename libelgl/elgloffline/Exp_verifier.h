@@ -12,7 +12,7 @@ class ExpVerifier{
 
     // void NIZKPoK(vector<BLS12381Element>& g1, vector<BLS12381Element>& y1,vector<BLS12381Element>& y2, std::stringstream&  ciphertexts, std::stringstream&  cleartexts);
     void NIZKPoK(BLS12381Element& g1, vector<BLS12381Element>& y1, vector<BLS12381Element>& y2, std::stringstream&  ciphertexts, std::stringstream&  cleartexts, ThreadPool* pool);
-    void NIZKPoK_(BLS12381Element pk_tmp, vector<BLS12381Element>& a, vector<BLS12381Element>& ask, std::stringstream& recvss, ThreadPool* pool);
+    void NIZKPoK_(const BLS12381Element& pk, vector<BLS12381Element>& a, vector<BLS12381Element>& ask, std::stringstream& recvss, ThreadPool* pool);
     void NIZKPoK(BLS12381Element& g1, BLS12381Element& y1, BLS12381Element& y2, std::stringstream&  ciphertexts, std::stringstream&  cleartexts, ThreadPool* pool, int i);
 
     size_t report_size(){return s.size() * sizeof(Plaintext);};
@@ -0,0 +1,46 @@
+#include "MSM.h"
+
+BLS12381Element msm(const std::vector<BLS12381Element>& points, const std::vector<Fr>& scalars, ThreadPool* pool){
+    if (points.size() != scalars.size()){
+        throw std::invalid_argument("msm: points and scalars must have the same size");
+    }
+    const size_t n = points.size();
+    std::vector<G1> xs(n);
+    for (size_t i = 0; i < n; i++){
+        xs[i] = points[i].point;
+    }
+
+    const size_t min_chunk = 256;
+    size_t T = pool ? pool->size() : 1;
+    size_t chunk = (n + T - 1) / T;
+    if (chunk < min_chunk) chunk = min_chunk;
+
+    // parallel_reduce runs chunks on the calling thread as well, so msm may
+    // be called from pool tasks without waiting on work no worker is free for.
+    G1 zero;
+    zero.clear();
+    BLS12381Element res;
+    res.point = emp::parallel_reduce(
+        pool, 0, n, zero,
+        [&xs, &scalars](size_t l, size_t r) {
+            G1 part;
+            G1::mulVec(part, xs.data() + l, scalars.data() + l, r - l);
+            return part;
+        },
+        [](const G1& a, const G1& b) {
+            G1 sum;
+            G1::add(sum, a, b);
+            return sum;
+        },
+        chunk);
+    res.point.normalize();
+    return res;
+}
+
+std::vector<Fr> batch_weights(size_t n){
+    std::vector<Fr> r(n);
+    for (size_t i = 0; i < n; i++){
+        r[i].setByCSPRNG();
+    }
+    return r;
+}
@@ -0,0 +1,15 @@
+#ifndef MSM_H
+#define MSM_H
+
+#include "libelgl/elgl/BLS12381Element.h"
+#include "emp-aby/utils.h"
+#include <vector>
+
+// sum_i scalars[i] * points[i]; chunks are run with mcl's mulVec on the pool
+// and the calling thread.
+BLS12381Element msm(const std::vector<BLS12381Element>& points, const std::vector<Fr>& scalars, ThreadPool* pool);
+
+// Local random weights for folding n verification equations into one MSM.
+std::vector<Fr> batch_weights(size_t n);
+
+#endif
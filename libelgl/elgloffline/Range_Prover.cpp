@@ -1,25 +1,10 @@
 #include "Range_Prover.h"
-#include <future>
 
 RangeProver::RangeProver(RangeProof& proof) {
     r1.resize(proof.n_proofs);
     r2.resize(proof.n_proofs);
 }
 
-struct thread_return1 {
-    BLS12381Element t1;
-    BLS12381Element t2;
-    BLS12381Element t3;
-    Plaintext rr1;
-    Plaintext rr2;
-};
-
-struct thread_return2 {
-    Plaintext sr;
-    Plaintext sx;
-};
-
-
 size_t RangeProver::NIZKPoK(RangeProof& P,
     std::stringstream& ciphertexts,
     std::stringstream& cleartexts,
@@ -33,54 +18,36 @@ size_t RangeProver::NIZKPoK(RangeProof& P,
         y2[i].pack(ciphertexts);
         y3[i].pack(ciphertexts);
     }
-    std::vector<std::future<thread_return1>> futures1;
-    futures1.reserve(P.n_proofs);
-    for (int i = 0; i < P.n_proofs; i++) {
-        futures1.emplace_back(pool->enqueue([this, &pk, &g1, i]() -> thread_return1 {
-            Plaintext rr1, rr2;
-            rr1.set_random();
-            rr2.set_random();
-            BLS12381Element c_0, c_1, c_2, c_3;
-            c_0 = BLS12381Element(rr1.get_message());
-            c_1 = pk.get_pk() * rr1.get_message();
-            c_2 = BLS12381Element(rr2.get_message());
-            c_1 += c_2;
-            c_2 = g1[i] * rr1.get_message(); 
-            c_3 = BLS12381Element(rr2.get_message());
-            c_2 += c_3;
-            return {c_0, c_1, c_2, rr1, rr2};
-        }));
+    std::vector<BLS12381Element> t1(P.n_proofs), t2(P.n_proofs), t3(P.n_proofs);
+    emp::parallel_for(pool, 0, P.n_proofs, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
+            r1[i].set_random();
+            r2[i].set_random();
+            BLS12381Element c_2 = BLS12381Element(r2[i].get_message());
+            t1[i] = BLS12381Element(r1[i].get_message());
+            t2[i] = pk.pk_mul(r1[i].get_message()) + c_2;
+            t3[i] = g1[i] * r1[i].get_message() + c_2;
+        }
+    });
+    for (size_t i = 0; i < P.n_proofs; i++) {
+        t1[i].pack(ciphertexts);
+        t3[i].pack(ciphertexts);
+        t2[i].pack(ciphertexts);
     }
-    for (size_t i = 0; i < P.n_proofs; i++)
-    {
-        thread_return1 result = futures1[i].get();
-        result.t1.pack(ciphertexts);
-        result.t3.pack(ciphertexts);
-        result.t2.pack(ciphertexts);
-        r1[i] = result.rr1;
-        r2[i] = result.rr2;
-    }
-    futures1.clear();
     P.set_challenge(ciphertexts);
-    std::vector<std::future<thread_return2>> futures2;
-    futures2.reserve(P.n_proofs);
-    for (int i = 0; i < P.n_proofs; i++){
-        futures2.emplace_back(pool->enqueue([&, i]() -> thread_return2 {
-        Plaintext sx, sr;
-        sx = P.challenge * x[i];
-        sx += r2[i];
-        sr = P.challenge * ski;
-        sr += r1[i];
-       return {sr, sx};
-    }));
-    }
-    for (size_t i = 0; i < P.n_proofs; i++)
-    {
-        thread_return2 result = futures2[i].get();
-        result.sx.pack(cleartexts);
-        result.sr.pack(cleartexts);
+    std::vector<Plaintext> sx(P.n_proofs), sr(P.n_proofs);
+    Plaintext c_ski = P.challenge * ski;
+    emp::parallel_for(pool, 0, P.n_proofs, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
+            sx[i] = P.challenge * x[i];
+            sx[i] += r2[i];
+            sr[i] = c_ski + r1[i];
+        }
+    });
+    for (size_t i = 0; i < P.n_proofs; i++) {
+        sx[i].pack(cleartexts);
+        sr[i].pack(cleartexts);
     }
-    futures2.clear();
     return report_size();
 }
 
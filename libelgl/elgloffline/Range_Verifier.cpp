@@ -1,4 +1,5 @@
 #include "Range_Verifier.h"
+#include "MSM.h"
 #include <future>
 RangeVerifier::RangeVerifier(RangeProof& proof) :
     P(proof)
@@ -31,50 +32,49 @@ void RangeVerifier::NIZKPoK(const BLS12381Element& y1, std::vector<BLS12381Eleme
         t2[i].unpack(ciphertexts);
         t3[i].unpack(ciphertexts);
     }
-    std::vector<std::future<void>> futures;
-    futures.reserve(P.n_proofs);
-    for (size_t i = 0; i < P.n_proofs; i++){
-        futures.push_back(pool->enqueue([&, i]() {
-        BLS12381Element gsr, gsx, gsxhsr;
-        BLS12381Element t1y1lamda, t2y2lamda;        
-        BLS12381Element gsxg1sr, t3y3lambda;
-        gsr = BLS12381Element(sr_tmp[i].get_message());
-        gsx = BLS12381Element(sx_tmp[i].get_message());
-        gsxhsr = pk.get_pk() * sr_tmp[i].get_message();
-        gsxhsr += gsx;
-        t1y1lamda = y1 * P.challenge.get_message();
-        t1y1lamda += t1[i];
-        gsxhsr = pk.get_pk() * sr_tmp[i].get_message();
-        gsxhsr += gsx;
-        t1y1lamda = y1 * P.challenge.get_message();
-        t1y1lamda += t1[i];
-        t2y2lamda = y2[i] * P.challenge.get_message();
-        t2y2lamda += t2[i];
-        gsxg1sr = g1[i] * sr_tmp[i].get_message();
-        gsxg1sr += gsx;
-        t3y3lambda = y3[i] * P.challenge.get_message();
-        t3y3lambda += t3[i];
-        if (gsr != t1y1lamda){
-            throw std::runtime_error("invalid proof: gsr!= t1y1lamda");
-        }
-        if (gsxhsr!= t3y3lambda){
-            throw std::runtime_error("invalid proof: gsxhsr!= t3y3lambda");
-        }
-        if (gsxg1sr!= t2y2lamda){
-            throw std::runtime_error("invalid proof: gsxg1sr!= t2y2lamda");
-        }
-        if (gsr != t1y1lamda || gsxhsr != t3y3lambda || gsxg1sr != t2y2lamda){
-            throw std::runtime_error("invalid proof");
-        }
-        }));
+    // Per proof i:
+    //   g^sr_i               == t1_i + c * y1
+    //   pk * sr_i + g^sx_i   == t3_i + c * y3_i
+    //   g1_i * sr_i + g^sx_i == t2_i + c * y2_i
+    // folded with independent random weights into one MSM that must vanish.
+    const Fr& c = P.challenge.get_message();
+    std::vector<Fr> w = batch_weights(3 * P.n_proofs);
+    std::vector<BLS12381Element> points;
+    std::vector<Fr> scalars;
+    points.reserve(6 * P.n_proofs + 3);
+    scalars.reserve(6 * P.n_proofs + 3);
+    Fr g_scalar = 0, pk_scalar = 0, y1_scalar = 0;
+    for (int i = 0; i < P.n_proofs; i++){
+        const Fr& sx = sx_tmp[i].get_message();
+        const Fr& sr = sr_tmp[i].get_message();
+        const Fr& a = w[3 * i];
+        const Fr& b = w[3 * i + 1];
+        const Fr& d = w[3 * i + 2];
+        g_scalar += a * sr + (b + d) * sx;
+        pk_scalar += b * sr;
+        y1_scalar += a;
+        points.push_back(t1[i]);
+        scalars.push_back(-a);
+        points.push_back(t3[i]);
+        scalars.push_back(-b);
+        points.push_back(y3[i]);
+        scalars.push_back(-(b * c));
+        points.push_back(g1[i]);
+        scalars.push_back(d * sr);
+        points.push_back(t2[i]);
+        scalars.push_back(-d);
+        points.push_back(y2[i]);
+        scalars.push_back(-(d * c));
     }
-
-    for (auto& future : futures) {
-        future.get();
+    points.push_back(BLS12381Element(1));
+    scalars.push_back(g_scalar);
+    points.push_back(pk.get_pk());
+    scalars.push_back(pk_scalar);
+    points.push_back(y1);
+    scalars.push_back(-(y1_scalar * c));
+    if (!msm(points, scalars, pool).point.isZero()){
+        throw std::runtime_error("invalid proof");
     }
-    
-    futures.clear();
-
 
     // std::cout << "valid proof" << std::endl;
 }
\ No newline at end of file
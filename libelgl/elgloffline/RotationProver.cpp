@@ -1,11 +1,4 @@
 #include "RotationProver.h"
-#include <future>
-#include <mutex>
-
-struct PackResult {
-    BLS12381Element M_k;
-    BLS12381Element CK_inc;
-};
 
 RotationProver::RotationProver(RotationProof& proof) {
     mk.resize(proof.n_tilde);
@@ -18,8 +11,6 @@ RotationProver::RotationProver(RotationProof& proof) {
 
 size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts, std::stringstream& cleartexts, const ELGL_PK& pk, const ELGL_PK& pk_tilde, 
     const std::vector<BLS12381Element> dx, const std::vector<BLS12381Element> ex, const std::vector<BLS12381Element> ax,const std::vector<BLS12381Element> bx, Plaintext& beta, const std::vector<Plaintext>& sk_k, ThreadPool* pool) {
-    std::mutex C_mutex;
-    std::vector<std::future<PackResult>> futures;
     BLS12381Element g = BLS12381Element(1);
     for (size_t i = 0; i < P.n_tilde; i++){
         ax[i].pack(ciphertexts);
@@ -29,7 +20,7 @@ size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts,
     }
     m_tilde.set_random();
     b.set_random();
-    BLS12381Element C_Tilde = pk.get_pk() * m_tilde.get_message();
+    BLS12381Element C_Tilde = pk.pk_mul(m_tilde.get_message());
     std::vector<BLS12381Element> ck(P.n_tilde + 1); ck[0] = g;
     std::vector<Plaintext> z(3); std::stringstream tmp_pack;
     tmp_pack.str(""); tmp_pack.clear(); tmp_pack << 0;
@@ -44,10 +35,11 @@ size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts,
     for (size_t i = 0; i < P.n_tilde; i++){
         tk[i].set_random();
         ck[i+1] = ck[i] * beta.get_message();
-        ck[i+1] += pk.get_pk() * tk[i].get_message();
+        ck[i+1] += pk.pk_mul(tk[i].get_message());
     }
-    for (size_t i = 0; i < P.n_tilde; ++i) {
-        futures.push_back(pool->enqueue([&, i]() -> PackResult {
+    std::vector<BLS12381Element> M(P.n_tilde), CK_inc(P.n_tilde);
+    emp::parallel_for(pool, 0, P.n_tilde, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
             std::stringstream tmp_pack;
             mk[i].set_random();uk[i].set_random();vk[i].set_random();
             m_tilde_k[i].set_random();
@@ -55,28 +47,25 @@ size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts,
             ax[i].pack(tmp_pack);bx[i].pack(tmp_pack);dx[i].pack(tmp_pack);
             ex[i].pack(tmp_pack);tmp_pack << i;
             yk[i].setHashof(tmp_pack.str().c_str(), tmp_pack.str().size());
-            PackResult result;
             BLS12381Element CK_tmp = ck[i] * b.get_message();
-            CK_tmp += pk.get_pk() * mk[i].get_message();
+            CK_tmp += pk.pk_mul(mk[i].get_message());
             Fr yki = yk[i].get_message();
-            result.CK_inc = CK_tmp * yki;Plaintext exp_tmp;
+            CK_inc[i] = CK_tmp * yki;Plaintext exp_tmp;
             BLS12381Element M_k;
             exp_tmp = z[0] * uk[i] + z[1] * vk[i];
             M_k = g * exp_tmp.get_message();
             exp_tmp = z[0] * m_tilde_k[i] + z[2] * vk[i];
-            M_k += pk_tilde.get_pk() * exp_tmp.get_message();
+            M_k += pk_tilde.pk_mul(exp_tmp.get_message());
             exp_tmp = z[1] * uk[i];
             M_k += ax[i] * exp_tmp.get_message();
             exp_tmp = z[2] * uk[i];
             M_k += bx[i] * exp_tmp.get_message();
-            result.M_k = M_k;
-            return result;
-        }));
-    }
-    for (size_t i = 0; i < futures.size(); ++i) {
-        PackResult res = futures[i].get();
-        ck[i+1].pack(ciphertexts); res.M_k.pack(ciphertexts);
-        C += res.CK_inc;
+            M[i] = M_k;
+        }
+    });
+    for (size_t i = 0; i < P.n_tilde; ++i) {
+        ck[i+1].pack(ciphertexts); M[i].pack(ciphertexts);
+        C += CK_inc[i];
     }
     C_Tilde.pack(ciphertexts);
     C = C - g;
@@ -91,9 +80,8 @@ size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts,
         t_star[i+1] = beta * t_star[i];
         t_star[i+1] += tk[i];betak *= beta;
     }
-    vector<std::future<void>> futures2;
-    for (size_t i = 0; i < P.n_tilde; i++){
-        futures2.push_back(pool->enqueue([&, i]() {
+    emp::parallel_for(pool, 0, P.n_tilde, [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; i++) {
             Plaintext exp, exp_tmp;
             exp.assign(std::to_string(i));
             Plaintext::pow(exp_tmp, beta, exp);
@@ -101,10 +89,8 @@ size_t RotationProver::NIZKPoK(RotationProof& P, std::stringstream& ciphertexts,
             miu[i] = P.challenge * exp_tmp;miu[i] += uk[i];
             niu[i] = P.challenge * sk_k[i];niu[i] += vk[i];
             rou[i] = P.challenge * t_star[i];rou[i] += m_tilde_k[i];
-        }));
-    }
-    for (auto& f : futures2) f.get();
-    futures2.clear();
+        }
+    });
     for (size_t i = 0; i < P.n_tilde; i++) phi_sum += phi[i] * yk[i];
     Plaintext eta = P.challenge * t_star[P.n_tilde];
     eta += m_tilde;
@@ -1,5 +1,5 @@
 #include "RotationVerifier.h"
-#include <future>
+#include "MSM.h"
 RotationVerifier::RotationVerifier(RotationProof& proof): P(proof){
     miu_k.resize(proof.n_tilde);
     niu_k.resize(proof.n_tilde);
@@ -37,7 +37,7 @@ void RotationVerifier::NIZKPoK(std::vector<BLS12381Element> &dx, std::vector<BLS
             rou_k[i].unpack(cleartexts);
         }
         BLS12381Element h_tilde_eta;
-        h_tilde_eta = pk_tilde.get_pk() * eta.get_message();
+        h_tilde_eta = pk_tilde.pk_mul(eta.get_message());
         BLS12381Element C_Tilde_c_n_gLambda;
         C_Tilde_c_n_gLambda = BLS12381Element(-1);
         C_Tilde_c_n_gLambda += ck[P.n_tilde];
@@ -57,52 +57,52 @@ void RotationVerifier::NIZKPoK(std::vector<BLS12381Element> &dx, std::vector<BLS
         z[2].setHashof(tmp_pack.str().c_str(), tmp_pack.str().size());
         std::vector<Plaintext> yk(P.n_tilde);
         BLS12381Element L, R; Plaintext tmp;
-        std::vector<std::future<void> >futures;
-        futures.reserve(P.n_tilde);
-        for (size_t i = 0; i < P.n_tilde; i++){
-            futures.push_back(pool->enqueue([&, i](){
+        emp::parallel_for(pool, 0, P.n_tilde, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; ++i) {
                 std::stringstream tmp_pack;
-                tmp_pack.str("");
-                tmp_pack.clear();
                 ax[i].pack(tmp_pack);
                 bx[i].pack(tmp_pack);
                 dx[i].pack(tmp_pack);
                 ex[i].pack(tmp_pack);
                 tmp_pack << i;
                 yk[i].setHashof(tmp_pack.str().c_str(), tmp_pack.str().size());
-                }));
-        }
-        for (auto& future : futures) {
-            future.get();
-        }
-        futures.clear();
-        for (size_t i=0; i<P.n_tilde; i++) {
-            futures.push_back(pool->enqueue([&, i]() {
-                Plaintext tmp;
-                BLS12381Element local_L, local_R;
-                tmp = z[0]*miu_k[i] + z[1]*niu_k[i];
-                local_L = BLS12381Element(tmp.get_message());
-                tmp = z[0] * rou_k[i];
-                tmp += z[2] * niu_k[i];
-                local_L += pk.get_pk() * tmp.get_message();
-                tmp = z[1] * miu_k[i];
-                local_L += ax[i] * tmp.get_message();
-                tmp = z[2] * miu_k[i];
-                local_L += bx[i] * tmp.get_message();
-                local_R = MK[i];
-                tmp = P.challenge * z[0];
-                local_R += ck[i] * tmp.get_message();
-                tmp = P.challenge * z[1];
-                local_R += dx[i] * tmp.get_message();
-                tmp = P.challenge * z[2];
-                local_R += ex[i] * tmp.get_message();
-                if (local_L != local_R) {
-                    #pragma omp critical
-                    std::cout << "error" << std::endl;
-                }
-            }));
+            }
+        });
+        // L_i == R_i for every i, folded with random weights r_i:
+        //   L_i = g^(z0 miu + z1 niu) + pk^(z0 rou + z2 niu) + ax^(z1 miu) + bx^(z2 miu)
+        //   R_i = MK + ck^(c z0) + dx^(c z1) + ex^(c z2)
+        std::vector<Fr> r = batch_weights(P.n_tilde);
+        std::vector<BLS12381Element> points;
+        std::vector<Fr> scalars;
+        points.reserve(6 * P.n_tilde + 2);
+        scalars.reserve(6 * P.n_tilde + 2);
+        const Fr& c = P.challenge.get_message();
+        Fr cz0 = c * z[0].get_message(), cz1 = c * z[1].get_message(), cz2 = c * z[2].get_message();
+        Fr g_scalar = 0, pk_scalar = 0;
+        for (size_t i = 0; i < P.n_tilde; i++){
+            const Fr& miu = miu_k[i].get_message();
+            const Fr& niu = niu_k[i].get_message();
+            const Fr& rou = rou_k[i].get_message();
+            g_scalar += r[i] * (z[0].get_message() * miu + z[1].get_message() * niu);
+            pk_scalar += r[i] * (z[0].get_message() * rou + z[2].get_message() * niu);
+            points.push_back(ax[i]);
+            scalars.push_back(r[i] * z[1].get_message() * miu);
+            points.push_back(bx[i]);
+            scalars.push_back(r[i] * z[2].get_message() * miu);
+            points.push_back(MK[i]);
+            scalars.push_back(-r[i]);
+            points.push_back(ck[i]);
+            scalars.push_back(-(r[i] * cz0));
+            points.push_back(dx[i]);
+            scalars.push_back(-(r[i] * cz1));
+            points.push_back(ex[i]);
+            scalars.push_back(-(r[i] * cz2));
         }
-        for (auto& future : futures) {
-            future.get();
+        points.push_back(g);
+        scalars.push_back(g_scalar);
+        points.push_back(pk.get_pk());
+        scalars.push_back(pk_scalar);
+        if (!msm(points, scalars, pool).point.isZero()) {
+            std::cout << "error" << std::endl;
         }
     }
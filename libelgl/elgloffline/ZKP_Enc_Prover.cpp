@@ -39,7 +39,7 @@ void EncProver::NIZKPoK(Proof& P, std::stringstream& ciphertexts, std::stringstr
   
           c_0 = BLS12381Element(r1[i].get_message());
   
-          c_1 = pk.get_pk() * r1[i].get_message();
+          c_1 = pk.pk_mul(r1[i].get_message());
   
           c_2 = BLS12381Element(r2[i].get_message());
   
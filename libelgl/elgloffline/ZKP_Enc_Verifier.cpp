@@ -64,7 +64,7 @@ void EncVerifier::NIZKPoK(std::vector<Ciphertext>& c, std::stringstream& ciphert
 
             gsxhsr = BLS12381Element(sx_tmp[i].get_message());
     
-            tmp = pk.get_pk() * sr_tmp[i].get_message();
+            tmp = pk.pk_mul(sr_tmp[i].get_message());
     
             gsxhsr = tmp + gsxhsr;
     
@@ -67,14 +67,16 @@ int main(int argc, char** argv) {
     Fr alpha_fr_bit = alpha_init(bitN);
     Fr alpha_frA = alpha_init(num);
     Fr alpha_frB = alpha_init(num);
+    // The three tables share keys and dlog indexes.
+    auto lvt_ctx = std::make_shared<LVTContext<MultiIOBase>>(num_party, party, io.get(), &pool, elgl.get());
     std::unique_ptr<LVT<MultiIOBase>> lvt_bit, lvtA, lvtB;
     LVT<MultiIOBase>* lvt_raw_bit = nullptr; LVT<MultiIOBase>* lvt_rawA = nullptr; LVT<MultiIOBase>* lvt_rawB = nullptr;
 
-    LVT<MultiIOBase>::initialize(filebit, lvt_raw_bit, num_party, party, io.get(), &pool, elgl.get(), alpha_fr_bit, bitN, op);
+    LVT<MultiIOBase>::initialize(filebit, lvt_raw_bit, lvt_ctx, alpha_fr_bit, bitN, op);
     lvt_bit.reset(lvt_raw_bit);
-    LVT<MultiIOBase>::initialize(fileA, lvt_rawA, num_party, party, io.get(), &pool, elgl.get(), alpha_frA, num, op);
+    LVT<MultiIOBase>::initialize(fileA, lvt_rawA, lvt_ctx, alpha_frA, num, op);
     lvtA.reset(lvt_rawA);
-    LVT<MultiIOBase>::initialize(fileB, lvt_rawB, num_party, party, io.get(), &pool, elgl.get(), alpha_frB, num, op);
+    LVT<MultiIOBase>::initialize(fileB, lvt_rawB, lvt_ctx, alpha_frB, num, op);
     lvtB.reset(lvt_rawB);
 
     std::vector<Plaintext> x_share;
@@ -101,15 +101,17 @@ int main(int argc, char** argv) {
     Fr alpha_frA = alpha_init(num);  
     Fr alpha_frB = alpha_init(num + DELTA_BITS);  
     
+    // The three tables share keys and dlog indexes.
+    auto lvt_ctx = std::make_shared<LVTContext<MultiIOBase>>(num_party, party, io.get(), &pool, elgl.get());
     std::unique_ptr<LVT<MultiIOBase>> lvt_bit, lvtA, lvtB;
     LVT<MultiIOBase>* lvt_raw_bit = nullptr;
     LVT<MultiIOBase>* lvt_rawA = nullptr;
     LVT<MultiIOBase>* lvt_rawB = nullptr;
-    LVT<MultiIOBase>::initialize(filebit, lvt_raw_bit, num_party, party, io.get(), &pool, elgl.get(), alpha_fr_bit, 1, op);
+    LVT<MultiIOBase>::initialize(filebit, lvt_raw_bit, lvt_ctx, alpha_fr_bit, 1, op);
     lvt_bit.reset(lvt_raw_bit);
-    LVT<MultiIOBase>::initialize(fileA, lvt_rawA, num_party, party, io.get(), &pool, elgl.get(), alpha_frA, num, op);
+    LVT<MultiIOBase>::initialize(fileA, lvt_rawA, lvt_ctx, alpha_frA, num, op);
     lvtA.reset(lvt_rawA);
-    LVT<MultiIOBase>::initialize(fileB, lvt_rawB, num_party, party, io.get(), &pool, elgl.get(), alpha_frB, num + DELTA_BITS, op);
+    LVT<MultiIOBase>::initialize(fileB, lvt_rawB, lvt_ctx, alpha_frB, num + DELTA_BITS, op);
     lvtB.reset(lvt_rawB);
     std::vector<Plaintext> x_share;
     {
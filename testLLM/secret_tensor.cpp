@@ -30,7 +30,7 @@ int main(int argc, char** argv) {
     Fr alpha_fr = alpha_init(fixedpoint_bits);
     LVT<MultiIOBase>* lvt = new LVT<MultiIOBase>(num_party, party, io, &pool, elgl, "init", alpha_fr, fixedpoint_bits, fixedpoint_bits);
     lvt->DistKeyGen(1);
-    SPDZ2k<MultiIOBase> spdz2k(elgl);
+    SPDZ2k<MultiIOBase> spdz2k(elgl, &pool);
 
     std::vector<size_t> shape = {2, 2};
     std::vector<uint64_t> plain_values = {1, 2, 3, 4};
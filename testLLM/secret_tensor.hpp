@@ -82,18 +82,7 @@ public:
         size_t m = shape[0], k = shape[1], n = other.shape[1];
         std::vector<size_t> result_shape = {m, n};
         SecretTensor result(result_shape, spdz2k, elgl, lvt, io, pool, party, num_party, fd);
-        for (size_t i = 0; i < m; ++i) {
-            for (size_t j = 0; j < n; ++j) {
-                Share acc = spdz2k.get_zero_share();
-                for (size_t p = 0; p < k; ++p) {
-                    size_t a_idx = i * k + p;
-                    size_t b_idx = p * n + j;
-                    Share prod = spdz2k.multiply_with_trunc(data_spdz2k[a_idx], other.data_spdz2k[b_idx], f);
-                    acc = spdz2k.add(acc, prod);
-                }
-                result.data_spdz2k[i * n + j] = acc;
-            }
-        }
+        result.data_spdz2k = spdz2k.matrix_multiply(data_spdz2k, other.data_spdz2k, m, k, n, f);
 
         return result;
     }
@@ -137,9 +126,7 @@ public:
         assert(type == ShareType::SPDZ2k && other.type == ShareType::SPDZ2k);
         assert(shape == other.shape);
         SecretTensor result(shape, spdz2k, elgl, lvt, io, pool, party, num_party, fd);
-        for (size_t i = 0; i < total_size; ++i) {
-            result.data_spdz2k[i] = spdz2k.multiply_with_trunc(data_spdz2k[i], other.data_spdz2k[i], f);
-        }
+        result.data_spdz2k = spdz2k.elementwise_multiply(data_spdz2k, other.data_spdz2k, f);
         return result;
     }
 
@@ -20,7 +20,7 @@ int party, port;
 const static int threads = 32;
 int num_party;
 const int su = 32;
-const mcl::Vint FIELD_SIZE("52435875175126190479447740508185965837690552500527637822603658699938581184512");
+const mcl::Vint FIELD_SIZE = field_size;
 int kl = 1; 
 int op = 1;
 
@@ -54,7 +54,7 @@ inline vector<TinyMAC<MultiIOBase>::LabeledShare> A2B(
     MASCOT<MultiIOBase>::LabeledShare x_plus_r;
     x_plus_r = mascot.add(x_arith, r_arith);
     mcl::Vint u;nt(nw);
-    u = mascot.reconstruct(x_plus_r);
+    u = mascot.reconstruct(x_plus_r).getMpz();
     u = (u + FIELD_SIZE) % FIELD_SIZE;
     vector<uint8_t> u_bits(l, 0);
     mcl::Vint tmp = u;
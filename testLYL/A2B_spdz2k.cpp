@@ -62,7 +62,9 @@ int main(int argc, char** argv) {
     SPDZ2k<MultiIOBase> spdz2k(elgl);
     uint64_t x_spdz2k = spdz2k.rng() % FIELD_SIZE;
     SPDZ2k<MultiIOBase>::LabeledShare x_arith = spdz2k.distributed_share(x_spdz2k);nt(nwc); 
-    auto x_bool = A2B_spdz2k::A2B(elgl, lvt, tiny, spdz2k, party, num_party, nwc, io, &pool, FIELD_SIZE, l, x_arith);
+    LutPool<MultiIOBase> tables(lvt, 2 * l, l);
+    tables.fill();
+    auto x_bool = A2B_spdz2k::A2B(elgl, lvt, tiny, spdz2k, party, num_party, nwc, io, &pool, FIELD_SIZE, l, x_arith, &tables);
     delete elgl; delete io; delete lvt;
     return 0;
 }
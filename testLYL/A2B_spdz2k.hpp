@@ -26,7 +26,8 @@ inline vector<TinyMAC<MultiIOBase>::LabeledShare> A2B(
     ThreadPool* pool,
     const uint64_t& FIELD_SIZE,
     int l,
-    const SPDZ2k<MultiIOBase>::LabeledShare& x_arith
+    const SPDZ2k<MultiIOBase>::LabeledShare& x_arith,
+    LutPool<MultiIOBase>* tables = nullptr
 ) {
     int bytes = io->get_total_bytes_sent();
     auto t = std::chrono::high_resolution_clock::now();
@@ -35,12 +36,16 @@ inline vector<TinyMAC<MultiIOBase>::LabeledShare> A2B(
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<int> bit_dis(0, 1);
-    lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    if (!tables) {
+        lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    }
     r_bits[0] = tiny.distributed_share(bit_dis(gen));nta();
-    for (int i=1; i<l; ++i) lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    if (!tables) {
+        for (int i = 1; i < l; ++i) lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    }
     for (int i=1; i<l; ++i) r_bits[i] = tiny.distributed_share(bit_dis(gen));nt(nw);
     SPDZ2k<MultiIOBase>::LabeledShare r_arith;
-    r_arith = B2A_spdz2k::B2A_for_A2B(elgl, lvt, tiny, spdz2k, party, num_party, nw, io, pool, FIELD_SIZE, r_bits);
+    r_arith = B2A_spdz2k::B2A_for_A2B(elgl, lvt, tiny, spdz2k, party, num_party, nw, io, pool, FIELD_SIZE, r_bits, tables);
     auto tt = std::chrono::high_resolution_clock::now();
     int bytes_ = io->get_total_bytes_sent();
     double comm_kb1 = double(bytes_ - bytes) / 1024.0;
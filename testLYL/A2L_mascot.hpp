@@ -33,13 +33,12 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     auto t = std::chrono::high_resolution_clock::now();
     Plaintext x;
     vector<Ciphertext> vec_cx(num_party);
-    Fr fd_fr; 
-    fd_fr.setStr(fd.getStr());
+    Fr fd_fr = MASCOT<MultiIOBase>::to_fr(fd);
     BLS12381Element G_fd(fd_fr);
 
     mcl::Vint r_mascot; r_mascot.setRand(fd);
     MASCOT<MultiIOBase>::LabeledShare shared_r = mascot.distributed_share(r_mascot);
-    mcl::Vint rval = shared_r.value; rval %= fd; if (rval < 0) rval += fd;
+    mcl::Vint rval = shared_r.value.getMpz(); rval %= fd; if (rval < 0) rval += fd;
     Plaintext r;
     r.assign(rval.getStr());
 
@@ -68,7 +67,7 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     int bytes_start = io->get_total_bytes_sent();
     auto t1 = std::chrono::high_resolution_clock::now();
 
-    mcl::Vint xval = shared_x.value; xval %= fd; if (xval < 0) xval += fd;
+    mcl::Vint xval = shared_x.value.getMpz(); xval %= fd; if (xval < 0) xval += fd;
     x.assign(xval.getStr());
     cx = lvt->global_pk.encrypt(x);
     count = count + cx;
@@ -87,7 +86,7 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     BLS12381Element u = thdcp_<MultiIOBase>(count, elgl, lvt->global_pk, lvt->user_pk, io, pool, party, num_party, lvt->P_to_m, lvt);
     
     MASCOT<MultiIOBase>::LabeledShare shared_u = mascot.add(shared_x, shared_r);
-    mcl::Vint u_int = mascot.reconstruct(shared_u);
+    mcl::Vint u_int = mascot.reconstruct(shared_u).getMpz();
     u_int %= fd; if (u_int < 0) u_int += fd;
 
     Fr u_int_fr; 
@@ -34,7 +34,7 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     Plaintext x;
     vector<Ciphertext> vec_cx(num_party);
     Fr fd_fr; 
-    fd_fr.setStr(std::to_string(fd));
+    fd_fr.setArray(&fd, 1);
     BLS12381Element G_fd(fd_fr);
 
     uint64_t r_spdz2k; r_spdz2k = spdz2k.rng() % fd; if(r_spdz2k < 0) r_spdz2k += fd;
@@ -42,7 +42,7 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     SPDZ2k<MultiIOBase>::LabeledShare shared_r;
     shared_r.value = r_spdz2k; shared_r.mac = r_spdz2k_mac; shared_r.owner = party; shared_r.field_size_ptr = &spdz2k_field_size;
     Plaintext r;
-    r.assign(std::to_string(r_spdz2k));
+    r.assign_uint64(r_spdz2k);
 
     Ciphertext cx, cr, count;
     cr = lvt->global_pk.encrypt(r);
@@ -70,7 +70,7 @@ inline tuple<Plaintext, vector<Ciphertext>> A2L(
     auto t1 = std::chrono::high_resolution_clock::now();
 
     uint64_t xval = shared_x.value; xval %= fd; if (xval < 0) xval += fd;
-    x.assign(std::to_string(xval));
+    x.assign_uint64(xval);
     cx = lvt->global_pk.encrypt(x);
     count = count + cx;
     vec_cx[party - 1] = cx;
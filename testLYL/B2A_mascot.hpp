@@ -48,7 +48,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     vector<Ciphertext> x_cipher(l), r_cipher(l), x_lut_ciphers(num_party);
     vector<Plaintext> x_plain(l), r_plain(l); 
     Plaintext plain_i;
-    plain_i.assign(std::to_string(r_bits[0].value)); 
+    plain_i.assign_uint64(r_bits[0].value); 
     r_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> r_ciphers;
     r_ciphers.resize(num_party); 
@@ -58,7 +58,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     if (shared_r[0].value == 0) shared_r[0].value = 0;
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(r_bits[i].value)); 
+        plain_i.assign_uint64(r_bits[i].value); 
         r_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> r_ciphers;
         r_ciphers.resize(num_party); 
@@ -68,7 +68,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
         shared_r[i] = L2A_mascot::L2A_for_B2A(elgl, lvt, mascot, party, num_party, io, pool, r_plain[i], r_ciphers, FIELD_SIZE);
         if (shared_r[i].value == 0) shared_r[i].value = 0;
     } 
-    plain_i.assign(std::to_string(x_bits[0].value));
+    plain_i.assign_uint64(x_bits[0].value);
     x_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> x_ciphers;nt(nw);
     x_ciphers.resize(num_party);  
@@ -77,7 +77,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     auto lut_ciphers = std::get<1>(result1);  
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(x_bits[i].value));
+        plain_i.assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> x_ciphers;
         x_ciphers.resize(num_party);  
@@ -91,6 +91,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
         shared_x[i] = L2A_mascot::L2A_for_B2A(elgl, lvt, mascot, party, num_party, io, pool, x_plain[i], x_lut_ciphers, FIELD_SIZE);
         if (shared_x[i].value == 0) shared_x[i].value = 0;
     }
+    mascot.precompute_triples(l);
     auto tt = std::chrono::high_resolution_clock::now();
     int bytes_ = io->get_total_bytes_sent();
     double comm_kb1 = double(bytes_ - bytes) / 1024.0;
@@ -103,16 +104,15 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     for (int i = 0; i < l; ++i) u_bits[i] = tiny.add(x_bits[i], r_bits[i]);
     auto mascot_u0 = mascot.add(shared_x[0], shared_r[0]);
     auto m0 = mascot.multiply(shared_x[0], shared_r[0]);
-    auto mascot_open0 = mascot.reconstruct(m0);
+    mcl::Vint mascot_open0 = mascot.reconstruct(m0).getMpz();
     mascot_open0 = (mascot_open0 % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
     m0 = m0 * 2;
-    m0.value = (FIELD_SIZE - m0.value) % FIELD_SIZE;
-    if (m0.value < 0) m0.value += FIELD_SIZE;
-    m0.mac = (FIELD_SIZE - m0.mac) % FIELD_SIZE;
-    if (m0.mac < 0) m0.mac += FIELD_SIZE;
+    m0.value = -m0.value;
+    m0.mac = -m0.mac;
     mascot_u0 = mascot.add(mascot_u0, m0);
-    mascot_open0 = mascot.reconstruct(mascot_u0);
+    mascot_open0 = mascot.reconstruct(mascot_u0).getMpz();
     mascot_open0 = (mascot_open0 % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
+    if (mascot_open0 > FIELD_SIZE / 2) mascot_open0 -= FIELD_SIZE;
     uint8_t tiny_u = tiny.reconstruct(tiny.add(x_bits[0], r_bits[0]));nta();
     if (((2 + tiny_u % 2)+2)%2 != ((2 + mascot_open0 % 2)+2)%2) {
         throw std::runtime_error("B2A_mascot check failed: decrypted value != share sum");
@@ -120,16 +120,15 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     for (int i = 1; i < l; ++i) {
         auto mascot_u = mascot.add(shared_x[i], shared_r[i]);
         auto m = mascot.multiply(shared_x[i], shared_r[i]);
-        auto mascot_open = mascot.reconstruct(m);
+        mcl::Vint mascot_open = mascot.reconstruct(m).getMpz();
         mascot_open = (mascot_open % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
         m = m * 2;
-        m.value = (FIELD_SIZE - m.value) % FIELD_SIZE;
-        if (m.value < 0) m.value += FIELD_SIZE;
-        m.mac = (FIELD_SIZE - m.mac) % FIELD_SIZE;
-        if (m.mac < 0) m.mac += FIELD_SIZE;
+        m.value = -m.value;
+        m.mac = -m.mac;
         mascot_u = mascot.add(mascot_u, m);
-        mascot_open = mascot.reconstruct(mascot_u);
+        mascot_open = mascot.reconstruct(mascot_u).getMpz();
         mascot_open = (mascot_open % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
+        if (mascot_open > FIELD_SIZE / 2) mascot_open -= FIELD_SIZE;
         uint8_t tiny_u = tiny.reconstruct(tiny.add(x_bits[i], r_bits[i]));
         if (((2 + tiny_u % 2)+2)%2 != ((2 + mascot_open % 2)+2)%2) {
             throw std::runtime_error("B2A_mascot check failed: decrypted value != share sum");
@@ -139,7 +138,6 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A(
     share_x_decimal.value = 0;
     share_x_decimal.mac = 0;
     share_x_decimal.owner = party;
-    share_x_decimal.field_size_ptr = &FIELD_SIZE;
     for (int i = 0; i < l; ++i) {
         share_x_decimal = share_x_decimal * 2 + shared_x[i];
     }
@@ -179,7 +177,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     vector<Ciphertext> x_cipher(l), r_cipher(l), x_lut_ciphers(num_party);
     vector<Plaintext> x_plain(l), r_plain(l); 
     Plaintext plain_i;
-    plain_i.assign(std::to_string(r_bits[0].value)); 
+    plain_i.assign_uint64(r_bits[0].value); 
     r_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> r_ciphers;
     r_ciphers.resize(num_party); 
@@ -189,7 +187,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     if (shared_r[0].value == 0) shared_r[0].value = 0;
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(r_bits[i].value)); 
+        plain_i.assign_uint64(r_bits[i].value); 
         r_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> r_ciphers;
         r_ciphers.resize(num_party); 
@@ -199,7 +197,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
         shared_r[i] = L2A_mascot::L2A_for_B2A(elgl, lvt, mascot, party, num_party, io, pool, r_plain[i], r_ciphers, FIELD_SIZE);
         if (shared_r[i].value == 0) shared_r[i].value = 0;
     } 
-    plain_i.assign(std::to_string(x_bits[0].value));
+    plain_i.assign_uint64(x_bits[0].value);
     x_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> x_ciphers;nt(nw);
     x_ciphers.resize(num_party);  
@@ -208,7 +206,7 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     auto lut_ciphers = std::get<1>(result1);  
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(x_bits[i].value));
+        plain_i.assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> x_ciphers;
         x_ciphers.resize(num_party);  
@@ -225,16 +223,15 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     for (int i = 0; i < l; ++i) u_bits[i] = tiny.add(x_bits[i], r_bits[i]);
     auto mascot_u0 = mascot.add(shared_x[0], shared_r[0]);
     auto m0 = mascot.multiply(shared_x[0], shared_r[0]);
-    auto mascot_open0 = mascot.reconstruct(m0);
+    mcl::Vint mascot_open0 = mascot.reconstruct(m0).getMpz();
     mascot_open0 = (mascot_open0 % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
     m0 = m0 * 2;
-    m0.value = (FIELD_SIZE - m0.value) % FIELD_SIZE;
-    if (m0.value < 0) m0.value += FIELD_SIZE;
-    m0.mac = (FIELD_SIZE - m0.mac) % FIELD_SIZE;
-    if (m0.mac < 0) m0.mac += FIELD_SIZE;
+    m0.value = -m0.value;
+    m0.mac = -m0.mac;
     mascot_u0 = mascot.add(mascot_u0, m0);
-    mascot_open0 = mascot.reconstruct(mascot_u0);
+    mascot_open0 = mascot.reconstruct(mascot_u0).getMpz();
     mascot_open0 = (mascot_open0 % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
+    if (mascot_open0 > FIELD_SIZE / 2) mascot_open0 -= FIELD_SIZE;
     uint8_t tiny_u = tiny.reconstruct(tiny.add(x_bits[0], r_bits[0]));nta();
     if (((2 + tiny_u % 2)+2)%2 != ((2 + mascot_open0 % 2)+2)%2) {
         throw std::runtime_error("B2A_mascot check failed: decrypted value != share sum");
@@ -242,16 +239,15 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     for (int i = 1; i < l; ++i) {
         auto mascot_u = mascot.add(shared_x[i], shared_r[i]);
         auto m = mascot.multiply(shared_x[i], shared_r[i]);
-        auto mascot_open = mascot.reconstruct(m);
+        mcl::Vint mascot_open = mascot.reconstruct(m).getMpz();
         mascot_open = (mascot_open % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
         m = m * 2;
-        m.value = (FIELD_SIZE - m.value) % FIELD_SIZE;
-        if (m.value < 0) m.value += FIELD_SIZE;
-        m.mac = (FIELD_SIZE - m.mac) % FIELD_SIZE;
-        if (m.mac < 0) m.mac += FIELD_SIZE;
+        m.value = -m.value;
+        m.mac = -m.mac;
         mascot_u = mascot.add(mascot_u, m);
-        mascot_open = mascot.reconstruct(mascot_u);
+        mascot_open = mascot.reconstruct(mascot_u).getMpz();
         mascot_open = (mascot_open % FIELD_SIZE + FIELD_SIZE) % FIELD_SIZE;
+        if (mascot_open > FIELD_SIZE / 2) mascot_open -= FIELD_SIZE;
         uint8_t tiny_u = tiny.reconstruct(tiny.add(x_bits[i], r_bits[i]));
         if (((2 + tiny_u % 2)+2)%2 != ((2 + mascot_open % 2)+2)%2) {
             throw std::runtime_error("B2A_mascot check failed: decrypted value != share sum");
@@ -261,7 +257,6 @@ inline MASCOT<MultiIOBase>::LabeledShare B2A_for_A2B(
     share_x_decimal.value = 0;
     share_x_decimal.mac = 0;
     share_x_decimal.owner = party;
-    share_x_decimal.field_size_ptr = &FIELD_SIZE;
     for (int i = 0; i < l; ++i) {
         share_x_decimal = share_x_decimal * 2 + shared_x[i];
     }
@@ -43,7 +43,16 @@ int main(int argc, char** argv){
     SPDZ2k<MultiIOBase> spdz2k(elgl);
     vector<TinyMAC<MultiIOBase>::LabeledShare> x_bits(l);
     for(int i=0;i<l;i++){x_bits[i]=tiny.distributed_share(tiny.rng()%2);}nt(nwc);
-    auto shared_x = B2A_spdz2k::B2A(elgl,lvt,tiny,spdz2k,party,num_party,nwc,io,&pool,FIELD_SIZE,x_bits);
+    // Table instances come from a background producer on a second channel
+    // (ports +3), so the conversion itself runs no table generation.
+    vector<pair<string,unsigned short>> prep_config;
+    for(auto& c:net_config) prep_config.emplace_back(c.first,(unsigned short)(c.second+3));
+    MultiIO* prep_io = new MultiIO(party,num_party,prep_config);
+    LutPool<MultiIOBase> tables(lvt,2*l,l);
+    tables.start(prep_io);
+    auto shared_x = B2A_spdz2k::B2A(elgl,lvt,tiny,spdz2k,party,num_party,nwc,io,&pool,FIELD_SIZE,x_bits,&tables);
+    tables.stop();
+    delete prep_io;
     delete elgl; delete io; delete lvt;
     return 0;
 }
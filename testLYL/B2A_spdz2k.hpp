@@ -2,6 +2,7 @@
 #include "emp-aby/io/multi-io.hpp"
 #include "emp-aby/io/mp_io_channel.h"
 #include "emp-aby/lvt.h"
+#include "emp-aby/lvt_pool.h"
 #include "emp-aby/elgl_interface.hpp"
 #include "emp-aby/tiny.hpp"
 #include "emp-aby/spdz2k.hpp"
@@ -28,13 +29,16 @@ inline SPDZ2k<MultiIOBase>::LabeledShare B2A(
     MultiIO* io,
     ThreadPool* pool,
     const uint64_t& FIELD_SIZE,
-    const vector<TinyMAC<MultiIOBase>::LabeledShare>& x_bits
+    const vector<TinyMAC<MultiIOBase>::LabeledShare>& x_bits,
+    LutPool<MultiIOBase>* tables = nullptr
 ) {
     int bytes = io->get_total_bytes_sent();
     auto t = std::chrono::high_resolution_clock::now();
-    lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);nta();
     int l = x_bits.size();
-    for (int i = 1; i < l; ++i) lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    if (!tables) {
+        lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);nta();
+        for (int i = 1; i < l; ++i) lvt->generate_shares(lvt->lut_share, lvt->rotation, lvt->table);
+    }
     vector<SPDZ2k<MultiIOBase>::LabeledShare> shared_x(l); 
     vector<TinyMAC<MultiIOBase>::LabeledShare> r_bits(l), u_bits(l);
     std::random_device rd;
@@ -47,39 +51,43 @@ inline SPDZ2k<MultiIOBase>::LabeledShare B2A(
     vector<Ciphertext> x_cipher(l), r_cipher(l), x_lut_ciphers(num_party);
     vector<Plaintext> x_plain(l), r_plain(l); 
     Plaintext plain_i;
-    plain_i.assign(std::to_string(r_bits[0].value)); 
+    plain_i.assign_uint64(r_bits[0].value); 
     r_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> r_ciphers;
     r_ciphers.resize(num_party); 
+    if (tables) tables->next();
     auto result = lvt->lookup_online_(plain_i, r_cipher[0], r_ciphers);
     r_plain[0] = std::get<0>(result); nta(); r_ciphers = std::get<1>(result);  
     shared_r[0] = L2A_spdz2k::L2A_for_B2A(elgl, lvt, spdz2k, party, num_party, io, pool, r_plain[0], r_ciphers, FIELD_SIZE);
     if (shared_r[0].value == 0) shared_r[0].value = 0;
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(r_bits[i].value)); 
+        plain_i.assign_uint64(r_bits[i].value); 
         r_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> r_ciphers;
         r_ciphers.resize(num_party); 
+        if (tables) tables->next();
         auto result = lvt->lookup_online_(plain_i, r_cipher[i], r_ciphers);
         r_plain[i] = std::get<0>(result);
         r_ciphers = std::get<1>(result);  
         shared_r[i] = L2A_spdz2k::L2A_for_B2A(elgl, lvt, spdz2k, party, num_party, io, pool, r_plain[i], r_ciphers, FIELD_SIZE);
         if (shared_r[i].value == 0) shared_r[i].value = 0;
     } 
-    plain_i.assign(std::to_string(x_bits[0].value));
+    plain_i.assign_uint64(x_bits[0].value);
     x_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> x_ciphers;nt(nw);
     x_ciphers.resize(num_party);  
+    if (tables) tables->next();
     auto result1 = lvt->lookup_online_(plain_i, x_cipher[0], x_ciphers);
     x_plain[0] = std::get<0>(result1);nta();
     auto lut_ciphers = std::get<1>(result1);  
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(x_bits[i].value));
+        plain_i.assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> x_ciphers;
         x_ciphers.resize(num_party);  
+        if (tables) tables->next();
         auto result2 = lvt->lookup_online_(plain_i, x_cipher[i], x_ciphers);
         x_plain[i] = std::get<0>(result2);  
         auto lut_ciphers = std::get<1>(result2);  
@@ -90,6 +98,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare B2A(
         shared_x[i] = L2A_spdz2k::L2A_for_B2A(elgl, lvt, spdz2k, party, num_party, io, pool, x_plain[i], x_lut_ciphers, FIELD_SIZE);
         if (shared_x[i].value == 0) shared_x[i].value = 0;
     }
+    spdz2k.precompute_triples(l);
     auto tt = std::chrono::high_resolution_clock::now();
     int bytes_ = io->get_total_bytes_sent();
     double comm_kb1 = double(bytes_ - bytes) / 1024.0;
@@ -163,7 +172,8 @@ inline SPDZ2k<MultiIOBase>::LabeledShare B2A_for_A2B(
     MultiIO* io,
     ThreadPool* pool,
     const uint64_t& FIELD_SIZE,
-    const vector<TinyMAC<MultiIOBase>::LabeledShare>& x_bits
+    const vector<TinyMAC<MultiIOBase>::LabeledShare>& x_bits,
+    LutPool<MultiIOBase>* tables = nullptr
 ) {
     int l = x_bits.size();
     vector<SPDZ2k<MultiIOBase>::LabeledShare> shared_x(l); 
@@ -178,39 +188,43 @@ inline SPDZ2k<MultiIOBase>::LabeledShare B2A_for_A2B(
     vector<Ciphertext> x_cipher(l), r_cipher(l), x_lut_ciphers(num_party);
     vector<Plaintext> x_plain(l), r_plain(l); 
     Plaintext plain_i;
-    plain_i.assign(std::to_string(r_bits[0].value)); 
+    plain_i.assign_uint64(r_bits[0].value); 
     r_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> r_ciphers;
     r_ciphers.resize(num_party); 
+    if (tables) tables->next();
     auto result = lvt->lookup_online_(plain_i, r_cipher[0], r_ciphers);
     r_plain[0] = std::get<0>(result); nta(); r_ciphers = std::get<1>(result);  
     shared_r[0] = L2A_spdz2k::L2A_for_B2A(elgl, lvt, spdz2k, party, num_party, io, pool, r_plain[0], r_ciphers, FIELD_SIZE);
     if (shared_r[0].value == 0) shared_r[0].value = 0;
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(r_bits[i].value)); 
+        plain_i.assign_uint64(r_bits[i].value); 
         r_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> r_ciphers;
         r_ciphers.resize(num_party); 
+        if (tables) tables->next();
         auto result = lvt->lookup_online_(plain_i, r_cipher[i], r_ciphers);
         r_plain[i] = std::get<0>(result);
         r_ciphers = std::get<1>(result);  
         shared_r[i] = L2A_spdz2k::L2A_for_B2A(elgl, lvt, spdz2k, party, num_party, io, pool, r_plain[i], r_ciphers, FIELD_SIZE);
         if (shared_r[i].value == 0) shared_r[i].value = 0;
     } 
-    plain_i.assign(std::to_string(x_bits[0].value));
+    plain_i.assign_uint64(x_bits[0].value);
     x_cipher[0] = lvt->global_pk.encrypt(plain_i);
     vector<Ciphertext> x_ciphers;nt(nw);
     x_ciphers.resize(num_party);  
+    if (tables) tables->next();
     auto result1 = lvt->lookup_online_(plain_i, x_cipher[0], x_ciphers);
     x_plain[0] = std::get<0>(result1);nta();
     auto lut_ciphers = std::get<1>(result1);  
     for (int i = 1; i < l; ++i) {
         Plaintext plain_i;
-        plain_i.assign(std::to_string(x_bits[i].value));
+        plain_i.assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i);
         vector<Ciphertext> x_ciphers;
         x_ciphers.resize(num_party);  
+        if (tables) tables->next();
         auto result2 = lvt->lookup_online_(plain_i, x_cipher[i], x_ciphers);
         x_plain[i] = std::get<0>(result2);  
         auto lut_ciphers = std::get<1>(result2);  
@@ -36,7 +36,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L(ELGL<MultiIOBase>* elgl, LVT<Mul
     vector<uint8_t> xx(l);
     vector<Plaintext> plain_i(l);
     for (int i = 0; i < l; ++i) {
-        plain_i[i].assign(std::to_string(r_bits[i].value));
+        plain_i[i].assign_uint64(r_bits[i].value);
         r_cipher[i] = lvt->global_pk.encrypt(plain_i[i]);
     }
     auto out1 = lvt->lookup_online_batch_(plain_i);
@@ -46,7 +46,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L(ELGL<MultiIOBase>* elgl, LVT<Mul
     }
 
     for (int i = 0; i < l; ++i) {
-        plain_i[i].assign(std::to_string(x_bits[i].value));
+        plain_i[i].assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i[i]);
     }
     auto out10 = lvt->lookup_online_batch_(plain_i);
@@ -62,7 +62,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L(ELGL<MultiIOBase>* elgl, LVT<Mul
 
     for (int i = 0; i < l; ++i) {
         uint8_t h = xx[i] ^ rr[i];
-        Plaintext hh; hh.assign(std::to_string(h));
+        Plaintext hh; hh.assign_uint64(h);
         uint64_t outt = lvt->Reconstruct_easy(hh, elgl, io, pool, party, num_party, 2).get_message().getUint64();
         uint8_t out_ = tiny.reconstruct(tiny.add(x_bits[i],r_bits[i]));
         if (outt != out_) {
@@ -117,7 +117,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L_for_L2B(
     vector<uint8_t> xx(l);
     vector<Plaintext> plain_i(l);
     for (int i = 0; i < l; ++i) {
-        plain_i[i].assign(std::to_string(r_bits[i].value));
+        plain_i[i].assign_uint64(r_bits[i].value);
         r_cipher[i] = lvt->global_pk.encrypt(plain_i[i]);
     }
     auto out1 = lvt->lookup_online_batch_(plain_i);
@@ -127,7 +127,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L_for_L2B(
     }
 
     for (int i = 0; i < l; ++i) {
-        plain_i[i].assign(std::to_string(x_bits[i].value));
+        plain_i[i].assign_uint64(x_bits[i].value);
         x_cipher[i] = lvt->global_pk.encrypt(plain_i[i]);
     }
     auto out10 = lvt->lookup_online_batch_(plain_i);
@@ -143,7 +143,7 @@ inline tuple<Plaintext, vector<Ciphertext>> B2L_for_L2B(
 
     for (int i = 0; i < l; ++i) {
         uint8_t h = xx[i] ^ rr[i];
-        Plaintext hh; hh.assign(std::to_string(h));
+        Plaintext hh; hh.assign_uint64(h);
         uint64_t outt = lvt->Reconstruct_easy(hh, elgl, io, pool, party, num_party, 2).get_message().getUint64();
         uint8_t out_ = tiny.reconstruct(tiny.add(x_bits[i],r_bits[i]));
         if (outt != out_) {
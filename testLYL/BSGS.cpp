@@ -7,35 +7,63 @@ const int thread_num = 32;
 using namespace emp;
 using namespace std;
 
-int main() {
+// usage: ./BSGS [log2 N] [value bits]
+int main(int argc, char** argv) {
     BLS12381Element::init();
-    BLS12381Element g = BLS12381Element::generator(); 
+    BLS12381Element g = BLS12381Element::generator();
 
-    // cout << "g " << g.getPoint().b_.getUint64() << endl; 
+    // cout << "g " << g.getPoint().b_.getUint64() << endl;
     ThreadPool pool(thread_num);
 
-    uint64_t N = 1ULL << 40; 
+    int logN = argc > 1 ? atoi(argv[1]) : 32;
+    int value_bits = argc > 2 ? atoi(argv[2]) : 24;
+    uint64_t N = 1ULL << logN;
     BSGSPrecomputation bsgs;
      {
         auto start_time = chrono::high_resolution_clock::now();
         bsgs.precompute(g, N);
         auto end_time = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end_time - start_time);
+        cout << "Precompute time: " << duration.count() << " milliseconds" << endl;
         bsgs.serialize("bsgs_table.bin");
     }
-    uint64_t inpu = 1ULL << 32; 
-
-    vector<BLS12381Element> y(100);
-    for (int i=0 ;i < 100;i++)   y[i]  = g * Fr(inpu); 
-    cout << inpu << endl;
-
     {
         auto start_time = chrono::high_resolution_clock::now();
-        vector<int64_t> result = bsgs.solve_parallel_with_pool_vector(y, &pool, thread_num);
+        bsgs.deserialize("bsgs_table.bin");
         auto end_time = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end_time - start_time);
-        cout << "Discrete log result: " << result[7] << endl;
-        cout << "Time taken: " << duration.count() << " milliseconds" << endl;
+        cout << "Load (mmap) time: " << duration.count() << " milliseconds" << endl;
+    }
+
+    mt19937_64 rng(42);
+    for (int logM = 10; logM <= 16; logM += 2) {
+        size_t M = 1ULL << logM;
+        vector<uint64_t> xs(M);
+        vector<BLS12381Element> y(M);
+        for (size_t i = 0; i < M; i++) {
+            xs[i] = rng() & ((1ULL << value_bits) - 1);
+            y[i] = g * Fr(static_cast<int64_t>(xs[i]));
+        }
+
+        auto start_time = chrono::high_resolution_clock::now();
+        vector<int64_t> r0 = bsgs.solve_parallel_with_pool_vector(y, &pool, thread_num);
+        auto end_time = chrono::high_resolution_clock::now();
+        double t0 = chrono::duration<double, milli>(end_time - start_time).count();
+
+        start_time = chrono::high_resolution_clock::now();
+        vector<int64_t> r1 = bsgs.solve_batch(y, &pool, thread_num);
+        end_time = chrono::high_resolution_clock::now();
+        double t1 = chrono::duration<double, milli>(end_time - start_time).count();
+
+        for (size_t i = 0; i < M; i++) {
+            if (r0[i] != (int64_t)xs[i] || r1[i] != (int64_t)xs[i]) {
+                cerr << "BSGS mismatch at " << i << endl;
+                return 1;
+            }
+        }
+        cout << "M = 2^" << logM
+             << "  per-target: " << t0 << " ms (" << M / t0 * 1000 << " dlog/s)"
+             << "  batch: " << t1 << " ms (" << M / t1 * 1000 << " dlog/s)" << endl;
     }
     return 0;
 }
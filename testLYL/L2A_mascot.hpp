@@ -33,8 +33,7 @@ inline MASCOT<MultiIOBase>::LabeledShare L2A(
     int bytes = io->get_total_bytes_sent();
     auto t = std::chrono::high_resolution_clock::now();
     MASCOT<MultiIOBase>::LabeledShare shared_x;
-    Fr fd_fr; 
-    fd_fr.setStr(fd.getStr());
+    Fr fd_fr = MASCOT<MultiIOBase>::to_fr(fd);
     BLS12381Element G_fd(fd_fr);
     mcl::Vint r_mascot; 
     r_mascot.setRand(fd);
@@ -85,7 +84,7 @@ inline MASCOT<MultiIOBase>::LabeledShare L2A(
     mcl::Vint u_int;
     MASCOT<MultiIOBase>::LabeledShare shared_u;
     shared_u = mascot.add(shared_x, shared_r);
-    u_int = mascot.reconstruct(shared_u);
+    u_int = mascot.reconstruct(shared_u).getMpz();
     u_int %= fd; if (u_int < 0) u_int += fd;
     Fr u_int_fr; 
     u_int_fr.setStr(u_int.getStr());
@@ -119,8 +118,7 @@ inline MASCOT<MultiIOBase>::LabeledShare L2A_for_B2A(
     const mcl::Vint& fd
 ) {
     MASCOT<MultiIOBase>::LabeledShare shared_x;
-    Fr fd_fr; 
-    fd_fr.setStr(fd.getStr());
+    Fr fd_fr = MASCOT<MultiIOBase>::to_fr(fd);
     BLS12381Element G_fd(fd_fr);
     mcl::Vint r_mascot; 
     r_mascot.setRand(fd);
@@ -171,7 +169,7 @@ inline MASCOT<MultiIOBase>::LabeledShare L2A_for_B2A(
     mcl::Vint u_int;
     MASCOT<MultiIOBase>::LabeledShare shared_u;
     shared_u = mascot.add(shared_x, shared_r);
-    u_int = mascot.reconstruct(shared_u);
+    u_int = mascot.reconstruct(shared_u).getMpz();
     u_int %= fd; if (u_int < 0) u_int += fd;
     Fr u_int_fr; 
     u_int_fr.setStr(u_int.getStr());
@@ -34,7 +34,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare L2A(
     auto t = std::chrono::high_resolution_clock::now();
     SPDZ2k<MultiIOBase>::LabeledShare shared_x;
     Fr fd_fr; 
-    fd_fr.setStr(std::to_string(fd));
+    fd_fr.setArray(&fd, 1);
     BLS12381Element G_fd(fd_fr);
     uint64_t r_spdz2k; r_spdz2k = spdz2k.rng() % fd; if(r_spdz2k < 0) r_spdz2k += fd;
     uint64_t r_spdz2k_mac = mulmod(r_spdz2k, spdz2k.mac_key, spdz2k_field_size);
@@ -47,7 +47,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare L2A(
     uint64_t x_spdz2k_mac = mulmod(x_spdz2k, spdz2k.mac_key, spdz2k_field_size);
     shared_x.value = x_spdz2k; shared_x.mac = x_spdz2k_mac; shared_x.owner = party; shared_x.field_size_ptr = &spdz2k_field_size;
     Plaintext r;
-    r.assign(std::to_string(r_spdz2k));
+    r.assign_uint64(r_spdz2k);
     Ciphertext cr, count;
     cr = lvt->global_pk.encrypt(r);
     elgl->serialize_sendall(cr);
@@ -120,7 +120,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare L2A_for_B2A(
 ) {
     SPDZ2k<MultiIOBase>::LabeledShare shared_x;
     Fr fd_fr; 
-    fd_fr.setStr(std::to_string(fd));
+    fd_fr.setArray(&fd, 1);
     BLS12381Element G_fd(fd_fr);
 
     uint64_t r_spdz2k; r_spdz2k = spdz2k.rng() % fd; if(r_spdz2k < 0) r_spdz2k += fd;
@@ -133,7 +133,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare L2A_for_B2A(
     shared_x = spdz2k.distributed_share(x_spdz2k);
 
     Plaintext r;
-    r.assign(std::to_string(r_spdz2k));
+    r.assign_uint64(r_spdz2k);
     Ciphertext cr, count;
     cr = lvt->global_pk.encrypt(r);
     elgl->serialize_sendall(cr);
@@ -180,7 +180,7 @@ inline SPDZ2k<MultiIOBase>::LabeledShare L2A_for_B2A(
     u_int %= fd; if (u_int < 0) u_int += fd;
 
     Fr u_int_fr; 
-    u_int_fr.setStr(std::to_string(u_int));
+    u_int_fr.setArray(&u_int, 1);
     BLS12381Element uu(u_int_fr);
     
     for (int i = 0; i <= num_party * 2; i++) {
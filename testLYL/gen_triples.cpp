@@ -0,0 +1,96 @@
+#include "emp-aby/io/multi-io.hpp"
+#include "emp-aby/mascot.hpp"
+#include "emp-aby/spdz2k.hpp"
+#include "emp-aby/tiny.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace emp;
+int party, port;
+const static int threads = 8;
+int num_party;
+
+// Offline run: every party writes count MASCOT, SPDZ2k and TinyMAC triples
+// to <dir>/<protocol>_triples_P<party>.bin. The same binary then loads the
+// stores back and compares taking m triples from them with generating
+// them on demand, and checks one product per protocol and that stores from
+// two different offline runs are refused.
+// usage: ./test_gen_triples <PartyID> <port> <num_parties> [count=2^20] [dir=.]
+template <typename F>
+static double seconds(F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <typename P, typename V>
+static bool run(const char* name, P& proto, const std::string& path, size_t count, V x, V y) {
+    size_t m = std::min<size_t>(count / 2, 100000);
+    double t_save = seconds([&] { proto.save_triples(path, count); });
+    double t_online = seconds([&] {
+        for (size_t i = 0; i < m; ++i) proto.get_triple();
+    });
+    proto.load_triples(path);
+    double t_store = seconds([&] {
+        for (size_t i = 0; i < m; ++i) proto.get_triple();
+    });
+    auto xs = proto.distributed_share(x), ys = proto.distributed_share(y);
+    auto zs = proto.multiply(xs, ys);
+    auto want = proto.reconstruct(xs) * proto.reconstruct(ys);
+    bool ok = proto.reconstruct(zs) == decltype(proto.reconstruct(zs))(want);
+    proto.save_triples(path + ".a", 64);
+    proto.save_triples(path + ".b", 64);
+    bool refused = false;
+    try {
+        proto.load_triples(path + (party == 1 ? ".b" : ".a"));
+    } catch (const std::runtime_error&) {
+        refused = true;
+    }
+    std::remove((path + ".a").c_str());
+    std::remove((path + ".b").c_str());
+    const TripleUsage& u = proto.triples.usage;
+    std::cout << name << ": " << count / t_save << " triples/s offline; taking " << m << ": " << m / t_online
+              << " /s on demand, " << m / t_store << " /s from the store; " << u.from_store << " of " << u.consumed
+              << " from the store, " << u.refills << " refills; " << (ok ? "ok" : "MISMATCH") << "; mixed runs "
+              << (refused ? "refused" : "ACCEPTED") << std::endl;
+    return ok && refused;
+}
+
+int main(int argc, char** argv) {
+    BLS12381Element::init();
+    if (argc < 4) {
+        std::cout << "Format: <PartyID> <port> <num_parties> [count] [dir]" << std::endl;
+        return 0;
+    }
+    parse_party_and_port(argv, &party, &port);
+    num_party = std::stoi(argv[3]);
+    size_t count = argc > 4 ? std::stoul(argv[4]) : 1 << 20;
+    std::string dir = argc > 5 ? argv[5] : ".";
+    std::vector<std::pair<std::string, unsigned short>> net_config;
+    for (int i = 0; i < num_party; ++i)
+        net_config.emplace_back("127.0.0.1", (unsigned short)(port + i));
+    ThreadPool pool(threads);
+    MultiIO* io = new MultiIO(party, num_party, net_config);
+    ELGL<MultiIOBase>* elgl = new ELGL<MultiIOBase>(num_party, io, &pool, party);
+    std::string suffix = "_triples_P" + std::to_string(party) + ".bin";
+    bool ok = true;
+    {
+        MASCOT<MultiIOBase> mascot(elgl, &pool);
+        ok = run("MASCOT", mascot, dir + "/mascot" + suffix, count, Fr(party + 5), Fr(party + 6)) && ok;
+    }
+    {
+        SPDZ2k<MultiIOBase> spdz2k(elgl, &pool);
+        ok = run("SPDZ2k", spdz2k, dir + "/spdz2k" + suffix, count, uint64_t(party + 5), uint64_t(party + 6)) && ok;
+    }
+    {
+        TinyMAC<MultiIOBase> tiny(elgl);
+        ok = run("TinyMAC", tiny, dir + "/tiny" + suffix, count, uint8_t(1), uint8_t(party & 1)) && ok;
+    }
+    delete elgl;
+    delete io;
+    return ok ? 0 : 1;
+}
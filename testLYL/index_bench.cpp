@@ -0,0 +1,66 @@
+#include "libelgl/elgl/Plaintext.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Table-index extraction as lookup_online does it: the old Vint/string path
+// (getMpz, mod, getStr, assign) against the limb path (mod_uint64,
+// assign_uint64), plus reduction by a modulus that is not a power of two.
+// usage: ./test_index_bench [n] [log_su]
+template <typename F>
+static double mops(size_t n, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return n / std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t n  = argc > 1 ? std::stoul(argv[1]) : 1 << 18;
+    int log_su = argc > 2 ? std::stoi(argv[2]) : 16;
+    initPairing(mcl::BLS12_381);
+    uint64_t su = 1ULL << log_su;
+
+    std::vector<Plaintext> u(n);
+    for (auto& x : u) x.set_random();
+    std::vector<size_t> ref(n), idx(n);
+
+    double old_rate = mops(n, [&] {
+        mcl::Vint h;
+        h.setStr(std::to_string(su));
+        for (size_t i = 0; i < n; i++) {
+            Plaintext p = u[i];
+            mcl::Vint q = p.get_message().getMpz();
+            mcl::gmp::mod(q, q, h);
+            p.assign(q.getStr());
+            ref[i] = q.getLow32bit();
+        }
+    });
+    double new_rate = mops(n, [&] {
+        for (size_t i = 0; i < n; i++) {
+            Plaintext p = u[i];
+            idx[i] = p.mod_uint64(su);
+            p.assign_uint64(idx[i]);
+        }
+    });
+    bool ok = ref == idx;
+
+    uint64_t m = 1000003;
+    double old_mod = mops(n, [&] {
+        mcl::Vint mv(m);
+        for (size_t i = 0; i < n; i++) {
+            mcl::Vint v = u[i].get_message().getMpz();
+            v %= mv;
+            ref[i] = v.getLow32bit();
+        }
+    });
+    double new_mod = mops(n, [&] {
+        for (size_t i = 0; i < n; i++) idx[i] = u[i].mod_uint64(m);
+    });
+    ok = ok && ref == idx;
+
+    std::cout << "index mod 2^" << log_su << "  Vint/string " << old_rate << " M/s  limbs " << new_rate << " M/s" << std::endl;
+    std::cout << "index mod " << m << "  Vint " << old_mod << " M/s  limbs " << new_mod << " M/s" << std::endl;
+    std::cout << (ok ? "ok" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
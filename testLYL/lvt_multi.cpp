@@ -0,0 +1,95 @@
+#include "emp-aby/lvt.h"
+#include "emp-aby/io/multi-io.hpp"
+#include <memory>
+using namespace emp;
+int party, port;
+const static int threads = 8;
+int num_party;
+
+// Two tables of different sizes looked up on the same inputs: once with a
+// lookup_online_batch per table and once with lookup_online_multi, which
+// opens x + rotation a single time. Both must reconstruct to T_k[x].
+// usage: ./test_lvt_multi <PartyID> <port> <num_parties> [n]
+int main(int argc, char** argv) {
+    BLS12381Element::init();
+    if (argc < 4) {
+        std::cout << "Format: <PartyID> <port> <num_parties> [n]" << std::endl;
+        return 0;
+    }
+    parse_party_and_port(argv, &party, &port);
+    num_party = std::stoi(argv[3]);
+    size_t n  = argc > 4 ? std::stoul(argv[4]) : 256;
+    std::vector<std::pair<std::string, unsigned short>> net_config;
+    for (int i = 0; i < num_party; ++i)
+        net_config.emplace_back("127.0.0.1", (unsigned short)(port + i));
+
+    ThreadPool pool(threads);
+    MultiIO* io = new MultiIO(party, num_party, net_config);
+    ELGL<MultiIOBase>* elgl = new ELGL<MultiIOBase>(num_party, io, &pool, party);
+    auto ctx = std::make_shared<LVTContext<MultiIOBase>>(num_party, party, io, &pool, elgl);
+
+    const int se_small = 6, se_large = 8, da = 8;
+    Fr alpha_small = alpha_init(se_small), alpha_large = alpha_init(se_large);
+    LVT<MultiIOBase> large(ctx, alpha_large, se_large, da);
+    LVT<MultiIOBase> small(ctx, alpha_small, se_small, da);
+    ctx->require_P_to_m(2 * (1ULL << se_large) * num_party, "../cache/p_to_m_multi.bin");
+    large.table.resize(large.su);
+    small.table.resize(small.su);
+    for (size_t i = 0; i < large.su; ++i) large.table[i] = 255 - i;
+    for (size_t i = 0; i < small.su; ++i) small.table[i] = (i * i) % 256;
+    LVT<MultiIOBase>::generate_shares_joint({&large, &small});
+    cout << "Share Generation Done." << endl;
+
+    // x = sum of the shares stays below the smaller table.
+    uint64_t share_bound = small.su / num_party;
+    vector<Plaintext> x_share(n);
+    vector<uint64_t> x(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        x_share[i].assign_uint64((i * 7 + party) % share_bound);
+        for (int p = 1; p <= num_party; ++p) x[i] += (i * 7 + p) % share_bound;
+    }
+    vector<vector<Ciphertext>> x_ciphers(num_party, vector<Ciphertext>(n));
+    for (size_t i = 0; i < n; ++i) {
+        x_ciphers[party - 1][i] = large.global_pk.encrypt(x_share[i]);
+        elgl->serialize_sendall(x_ciphers[party - 1][i]);
+        for (int p = 1; p <= num_party; ++p)
+            if (p != party) elgl->deserialize_recv(x_ciphers[p - 1][i], p);
+    }
+
+    uint64_t bytes = io->get_total_bytes_sent();
+    auto t = std::chrono::high_resolution_clock::now();
+    auto sep_large = large.lookup_online_batch(x_share, x_ciphers);
+    auto sep_small = small.lookup_online_batch(x_share, x_ciphers);
+    double sep_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t).count();
+    double sep_kb = double(io->get_total_bytes_sent() - bytes) / 1024.0;
+
+    bytes = io->get_total_bytes_sent();
+    t = std::chrono::high_resolution_clock::now();
+    auto fused = large.lookup_online_multi({&large, &small}, x_share, x_ciphers);
+    double fused_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t).count();
+    double fused_kb = double(io->get_total_bytes_sent() - bytes) / 1024.0;
+
+    bool ok = true;
+    mcl::Vint modulo(uint64_t(large.ad));
+    LVT<MultiIOBase>* tables[2] = {&large, &small};
+    for (size_t k = 0; k < 2; ++k) {
+        auto& sep = k == 0 ? sep_large : sep_small;
+        auto& [shares, cips] = fused[k];
+        for (size_t i = 0; i < std::min<size_t>(n, 8); ++i) {
+            LVT<MultiIOBase>* lvt = tables[k];
+            Plaintext a = lvt->Reconstruct(shares[i], cips.element(i), elgl, lvt->global_pk, lvt->user_pk, io, &pool, party, num_party, modulo);
+            Plaintext b = lvt->Reconstruct(std::get<0>(sep)[i], std::get<1>(sep).element(i), elgl, lvt->global_pk, lvt->user_pk, io, &pool, party, num_party, modulo);
+            uint64_t want = lvt->table[x[i]];
+            if (a.to_uint64() != want || b.to_uint64() != want) {
+                std::cerr << "table " << k << " x=" << x[i] << ": fused " << a.to_uint64() << ", separate "
+                          << b.to_uint64() << ", expected " << want << std::endl;
+                ok = false;
+            }
+        }
+    }
+    cout << "separate: " << sep_ms << " ms, " << sep_kb << " KB; fused: " << fused_ms << " ms, " << fused_kb << " KB" << endl;
+    cout << (ok ? "ok" : "MISMATCH") << endl;
+    delete elgl;
+    delete io;
+    return ok ? 0 : 1;
+}
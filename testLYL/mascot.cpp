@@ -15,7 +15,7 @@ using namespace std;
 int party, port;
 const static int threads = 32;
 int num_party;
-const mcl::Vint FIELD_SIZE("52435875175126190479447740508185965837690552500527637822603658699938581184512");
+const mcl::Vint FIELD_SIZE = field_size;
 int op = 32; 
 
 int main(int argc, char** argv) {
@@ -51,7 +51,7 @@ int main(int argc, char** argv) {
 
     lvt->DistKeyGen(1);
 
-    MASCOT<MultiIOBase> mascot(elgl);
+    MASCOT<MultiIOBase> mascot(elgl, &pool);
     
     if(party == 1) {
         for(int i = 2; i <= num_party; i++) {
@@ -68,7 +68,7 @@ int main(int argc, char** argv) {
     MASCOT<MultiIOBase>::LabeledShare shared_value;
     shared_value = mascot.distributed_share(test_input);
 
-    mcl::Vint reconstructed = mascot.reconstruct(shared_value);
+    mcl::Vint reconstructed = mascot.reconstruct(shared_value).getMpz();
     
     std::cout << "Reconstructed value: " << reconstructed.getStr() << std::endl;
     
@@ -82,14 +82,14 @@ int main(int argc, char** argv) {
     x2_share = mascot.distributed_share(x2);
     
     auto sum_share = mascot.add(x1_share, x2_share);
-    mcl::Vint sum_result = mascot.reconstruct(sum_share);
+    mcl::Vint sum_result = mascot.reconstruct(sum_share).getMpz();
     
     std::cout << "Addition result: " << sum_result.getStr() << std::endl;
     
     mcl::Vint scalar; scalar = 2; scalar %= FIELD_SIZE;
     
     auto scalar_mul_share = mascot.mul_const(x1_share, scalar);
-    mcl::Vint scalar_mul_result = mascot.reconstruct(scalar_mul_share);
+    mcl::Vint scalar_mul_result = mascot.reconstruct(scalar_mul_share).getMpz();
     
     std::cout << "\nTesting scalar multiplication: " << x1.getStr() << " * " << scalar.getStr() << std::endl;
     std::cout << "Scalar multiplication result: " << scalar_mul_result.getStr() << std::endl;
@@ -97,12 +97,33 @@ int main(int argc, char** argv) {
     std::cout << "\nTesting multiplication..." << std::endl;
     auto mul_share = mascot.multiply(x1_share, x2_share);
 
-    mcl::Vint k1 = mascot.reconstruct(x1_share);
-    mcl::Vint k2 = mascot.reconstruct(x2_share);
-    mcl::Vint k3 = mascot.reconstruct(mul_share);
+    mcl::Vint k1 = mascot.reconstruct(x1_share).getMpz();
+    mcl::Vint k2 = mascot.reconstruct(x2_share).getMpz();
+    mcl::Vint k3 = mascot.reconstruct(mul_share).getMpz();
     
     std::cout << "\nTesting multiplication: " << k1.getStr() << " * " << k2.getStr() << std::endl;
     std::cout << "Multiplication result: " << k3.getStr() << std::endl;
+
+    // 4x4 matmul with one matrix triple against the scalar multiply.
+    const size_t d = 4;
+    std::vector<MASCOT<MultiIOBase>::LabeledShare> ma(d * d), mb(d * d);
+    for (size_t i = 0; i < d * d; ++i) {
+        mcl::Vint va, vb;
+        va = party * (i + 1);
+        vb = party + 3 * i;
+        ma[i] = mascot.distributed_share(va);
+        mb[i] = mascot.distributed_share(vb);
+    }
+    auto mc = mascot.matrix_multiply(ma, mb, d, d, d);
+    bool mat_ok = true;
+    for (size_t i = 0; i < d && mat_ok; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            auto acc = mascot.multiply(ma[i * d], mb[j]);
+            for (size_t p = 1; p < d; ++p) acc = mascot.add(acc, mascot.multiply(ma[i * d + p], mb[p * d + j]));
+            if (mascot.reconstruct(acc) != mascot.reconstruct(mc[i * d + j])) mat_ok = false;
+        }
+    }
+    std::cout << "Matrix triple matmul " << (mat_ok ? "ok" : "MISMATCH") << std::endl;
     
     delete elgl;
     delete io;
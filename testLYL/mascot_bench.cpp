@@ -0,0 +1,119 @@
+#include "emp-aby/io/multi-io.hpp"
+#include "emp-aby/mascot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace emp;
+int party, port;
+const static int threads = 8;
+int num_party;
+
+// MASCOT multiplications per second: the local half of a Beaver
+// multiplication and the share encoding as the Vint version did them
+// (% field_size per operation, getStr text) against Fr with 32-byte
+// encodings, then multiply one at a time and multiply_batch on the network.
+// usage: ./test_mascot_bench <PartyID> <port> <num_parties> [n]
+template <typename F>
+static double per_sec(size_t n, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return n / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    BLS12381Element::init();
+    if (argc < 4) {
+        std::cout << "Format: <PartyID> <port> <num_parties> [n]" << std::endl;
+        return 0;
+    }
+    parse_party_and_port(argv, &party, &port);
+    num_party = std::stoi(argv[3]);
+    size_t n = argc > 4 ? std::stoul(argv[4]) : 1 << 14;
+    std::vector<std::pair<std::string, unsigned short>> net_config;
+    for (int i = 0; i < num_party; ++i)
+        net_config.emplace_back("127.0.0.1", (unsigned short)(port + i));
+    ThreadPool pool(threads);
+    MultiIO* io = new MultiIO(party, num_party, net_config);
+    ELGL<MultiIOBase>* elgl = new ELGL<MultiIOBase>(num_party, io, &pool, party);
+    MASCOT<MultiIOBase> mascot(elgl, &pool);
+    typedef MASCOT<MultiIOBase>::LabeledShare Share;
+
+    // Local Beaver step z = c + e b + d a + e d and its mac.
+    std::vector<Fr> e(n), d(n), a(n), b(n), c(n), ma(n), mb(n), mc(n);
+    for (size_t i = 0; i < n; ++i) {
+        e[i].setByCSPRNG(); d[i].setByCSPRNG(); a[i].setByCSPRNG(); b[i].setByCSPRNG(); c[i].setByCSPRNG();
+        ma[i] = a[i] * mascot.mac_key; mb[i] = b[i] * mascot.mac_key; mc[i] = c[i] * mascot.mac_key;
+    }
+    std::vector<mcl::Vint> ve(n), vd(n), va(n), vb(n), vc(n), vz(n), vm(n);
+    for (size_t i = 0; i < n; ++i) {
+        ve[i] = e[i].getMpz(); vd[i] = d[i].getMpz(); va[i] = a[i].getMpz(); vb[i] = b[i].getMpz(); vc[i] = c[i].getMpz();
+    }
+    mcl::Vint vkey = mascot.mac_key.getMpz();
+    double vint_local = per_sec(n, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            mcl::Vint z = (vc[i] + (ve[i] * vb[i]) % field_size + (vd[i] * va[i]) % field_size) % field_size;
+            z = (z + (ve[i] * vd[i]) % field_size) % field_size;
+            vz[i] = (z + field_size) % field_size;
+            mcl::Vint m = (vc[i] + (ve[i] * vb[i]) % field_size + (vd[i] * va[i]) % field_size) % field_size;
+            m = (m + (ve[i] * vd[i] * vkey) % field_size) % field_size;
+            vm[i] = (m + field_size) % field_size;
+        }
+    });
+    std::vector<Share> z(n);
+    double fr_local = per_sec(n, [&] {
+        for (size_t i = 0; i < n; ++i) z[i] = mascot.beaver_output(a[i], b[i], c[i], ma[i], mb[i], mc[i], e[i], d[i]);
+    });
+    bool ok = true;
+    for (size_t i = 0; i < n && ok; ++i) ok = (party != 1) || z[i].value.getMpz() == vz[i];
+
+    // Encoding and decoding one share as reconstruct sends it.
+    double vint_codec = per_sec(n, [&] {
+        std::stringstream ss;
+        for (size_t i = 0; i < n; ++i) ss << vz[i].getStr() << " " << vm[i].getStr() << " " << party << " ";
+        std::string s1, s2;
+        int owner;
+        for (size_t i = 0; i < n; ++i) {
+            ss >> s1 >> s2 >> owner;
+            vz[i].setStr(s1);
+            vm[i].setStr(s2);
+        }
+    });
+    double fr_codec = per_sec(n, [&] {
+        std::stringstream ss;
+        for (size_t i = 0; i < n; ++i) z[i].pack(ss);
+        for (size_t i = 0; i < n; ++i) z[i].unpack(ss);
+    });
+
+    // On the network, with triples prepared beforehand.
+    size_t seq = std::min<size_t>(n, 1000);
+    Fr one(party == 1 ? 1 : 0);
+    Share x = mascot.distributed_share(Fr(party + 1)), y = mascot.distributed_share(Fr(party + 2));
+    mascot.precompute_triples(seq + n);
+    double seq_rate = per_sec(seq, [&] {
+        for (size_t i = 0; i < seq; ++i) x = mascot.multiply(x, y);
+    });
+    FrShares xs(n), ys(n);
+    for (size_t i = 0; i < n; ++i) {
+        xs.value[i] = x.value; xs.mac[i] = x.mac;
+        ys.value[i] = y.value; ys.mac[i] = y.mac;
+    }
+    uint64_t bytes = io->get_total_bytes_sent();
+    FrShares zs;
+    double batch_rate = per_sec(n, [&] { zs = mascot.multiply_batch(xs, ys); });
+    double batch_kb = double(io->get_total_bytes_sent() - bytes) / 1024.0;
+    Fr want = mascot.reconstruct(x) * mascot.reconstruct(y);
+    std::vector<Fr> opened = mascot.reconstruct_batch(zs);
+    for (size_t i = 0; i < n; ++i) ok = ok && opened[i] == want;
+
+    std::cout << "local beaver  Vint " << vint_local << " /s  Fr " << fr_local << " /s" << std::endl;
+    std::cout << "share codec   text " << vint_codec << " /s  binary " << fr_codec << " /s" << std::endl;
+    std::cout << "multiply      " << seq_rate << " mult/s one at a time, " << batch_rate << " mult/s in a batch of " << n
+              << " (" << batch_kb << " KB)" << std::endl;
+    std::cout << (ok ? "ok" : "MISMATCH") << std::endl;
+    delete elgl;
+    delete io;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "emp-aby/io/multi-io.hpp"
+#include <algorithm>
+#include <chrono>
+using namespace emp;
+
+// All-to-all MultiIO microbenchmark: every party sends <msgs> messages of
+// <bytes> bytes to every peer while one pool task per peer drains them.
+// Reports messages/s and p50/p99 one-way receive latency (steady clock,
+// so run all parties on one host).
+// usage: ./test_multiio_bench <PartyID> <port> <num_parties> [msgs] [bytes] [backend: 0 poll, 1 epoll, 2 peer threads]
+//   for n in 3 4 8 16; do for i in $(seq 1 $n); do ./test_multiio_bench $i 12345 $n & done; wait; done
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cout << "Format: <PartyID> <port> <num_parties> [msgs] [bytes] [backend]" << std::endl;
+        return 0;
+    }
+    int party, port;
+    parse_party_and_port(argv, &party, &port);
+    int num_party = std::stoi(argv[3]);
+    int msgs      = argc > 4 ? std::stoi(argv[4]) : 20000;
+    int bytes     = argc > 5 ? std::stoi(argv[5]) : 256;
+    bytes         = std::max<int>(bytes, sizeof(int64_t));
+    RecvBackend backend = argc > 6 ? (RecvBackend)std::stoi(argv[6]) : default_recv_backend;
+
+    std::vector<std::pair<std::string, unsigned short>> net_config;
+    for (int i = 0; i < num_party; ++i)
+        net_config.emplace_back("127.0.0.1", (unsigned short)(port + 4 * i));
+
+    ThreadPool pool(2 * num_party);
+    MultiIO* io = new MultiIO(party, num_party, net_config, backend);
+
+    std::vector<std::vector<double>> lat(num_party + 1);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> futs;
+    for (int p = 1; p <= num_party; ++p) {
+        if (p == party) continue;
+        futs.push_back(pool.enqueue([&, p]() {
+            std::vector<char> buf(bytes);
+            for (int m = 0; m < msgs; ++m) {
+                int64_t ts = std::chrono::steady_clock::now().time_since_epoch().count();
+                memcpy(buf.data(), &ts, sizeof(ts));
+                io->send_data(p, buf.data(), bytes);
+            }
+        }));
+        futs.push_back(pool.enqueue([&, p]() {
+            lat[p].reserve(msgs);
+            for (int m = 0; m < msgs; ++m) {
+                MsgView msg = io->recv_view(p);
+                int64_t ts;
+                memcpy(&ts, msg.data(), sizeof(ts));
+                int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+                lat[p].push_back((now - ts) / 1000.0);
+            }
+        }));
+    }
+    for (auto& f : futs) f.get();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& v : lat) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    double p50 = all[all.size() / 2];
+    double p99 = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+    std::cout << "party " << party << "/" << num_party << "  " << all.size() / secs << " msg/s received"
+              << "  p50 " << p50 << " us  p99 " << p99 << " us" << std::endl;
+
+    // Reconstruct-style rounds: broadcast a 40-byte share, then collect one
+    // from every peer.
+    const int rounds = 2000;
+    char share[40] = {0};
+    struct iovec part = {share, sizeof(share)};
+    double bcast_us = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        io->broadcast_data_v(&part, 1);
+        bcast_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        for (int p = 1; p <= num_party; ++p)
+            if (p != party) io->recv_data(p, share, sizeof(share));
+    }
+    double round_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "party " << party << "  40B broadcast: " << bcast_us / rounds << " us/call  "
+              << round_us / rounds << " us/round" << std::endl;
+    delete io;
+    return 0;
+}
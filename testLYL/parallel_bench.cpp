@@ -0,0 +1,64 @@
+#include "emp-aby/utils.h"
+#include "libelgl/elgl/BLS12381Element.h"
+#include <chrono>
+#include <future>
+using namespace emp;
+
+// Scheduler overhead: one pool task per element (the old pattern) against
+// emp::parallel_for, on a trivial body (Fr add) and a heavy one (G1 scalar mul).
+// usage: ./test_parallel_bench [threads] [n]
+template <typename F>
+static double time_ns(size_t n, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::stoi(argv[1]) : std::thread::hardware_concurrency();
+    size_t n    = argc > 2 ? std::stoul(argv[2]) : 1 << 16;
+    BLS12381Element::init();
+    ThreadPool pool(threads);
+
+    vector<Fr> a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+        a[i].setByCSPRNG();
+        b[i].setByCSPRNG();
+    }
+    auto per_task = [&](size_t m, auto body) {
+        vector<std::future<void>> futs;
+        futs.reserve(m);
+        for (size_t i = 0; i < m; i++)
+            futs.push_back(pool.enqueue([&body, i]() { body(i); }));
+        for (auto& f : futs) f.get();
+    };
+    auto chunked = [&](size_t m, auto body) {
+        parallel_for(&pool, 0, m, [&](size_t l, size_t r) {
+            for (size_t i = l; i < r; i++) body(i);
+        });
+    };
+
+    auto add = [&](size_t i) { a[i] += b[i]; };
+    std::cout << "Fr add    per-task " << time_ns(n, [&] { per_task(n, add); }) << " ns/elem  parallel_for "
+              << time_ns(n, [&] { chunked(n, add); }) << " ns/elem" << std::endl;
+
+    size_t m = std::min<size_t>(n, 1 << 12);
+    vector<BLS12381Element> g(m);
+    BLS12381Element base = BLS12381Element::generator();
+    auto mul = [&](size_t i) { g[i] = base * a[i]; };
+    std::cout << "G1 mul    per-task " << time_ns(m, [&] { per_task(m, mul); }) << " ns/elem  parallel_for "
+              << time_ns(m, [&] { chunked(m, mul); }) << " ns/elem" << std::endl;
+
+    Fr sum = parallel_reduce(
+        &pool, 0, n, Fr(0),
+        [&](size_t l, size_t r) {
+            Fr s = 0;
+            for (size_t i = l; i < r; i++) s += a[i];
+            return s;
+        },
+        [](const Fr& x, const Fr& y) { return x + y; });
+    Fr ref = 0;
+    for (auto& v : a) ref += v;
+    std::cout << "parallel_reduce " << (sum == ref ? "ok" : "MISMATCH") << std::endl;
+    return sum == ref ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#!/bin/bash
+# Runs one test binary as N local parties and fails if any party does.
+# usage: run_parties.sh <binary> <num_parties> <port> [extra args...]
+set -u
+
+EXEC=$1
+N=$2
+PORT=$3
+shift 3
+
+PROCS=()
+for (( i=1; i<=N; i++ )); do
+    if [ "${i}" -eq 1 ]; then
+        "${EXEC}" "${i}" "${PORT}" "${N}" "$@" &
+    else
+        "${EXEC}" "${i}" "${PORT}" "${N}" "$@" > /dev/null 2>&1 &
+    fi
+    PROCS+=($!)
+done
+
+STATUS=0
+for pid in "${PROCS[@]}"; do
+    wait "${pid}" || STATUS=1
+done
+exit ${STATUS}
@@ -47,7 +47,7 @@ int main(int argc, char** argv) {
     lvt->DistKeyGen(1);
     std::cout << "party: " << party << std::endl;
 
-    SPDZ2k<MultiIOBase> spdz2k(elgl);
+    SPDZ2k<MultiIOBase> spdz2k(elgl, &pool);
     std::cout << "party: " << party << std::endl;
 
     if(party == 1) {
@@ -89,6 +89,77 @@ int main(int argc, char** argv) {
     std::cout << "\nTesting multiplication: " << k1 << " * " << k2 << std::endl;
     std::cout << "Multiplication result: " << k3 << std::endl;
 
+    std::cout << "\nTesting batch multiplication..." << std::endl;
+    const size_t batch = 256;
+    std::vector<SPDZ2k<MultiIOBase>::LabeledShare> xs(batch), ys(batch);
+    std::vector<uint64_t> x_full(batch, 0), y_full(batch, 0);
+    for (size_t i = 0; i < batch; ++i) {
+        xs[i] = spdz2k.distributed_share_(party + i);
+        ys[i] = spdz2k.distributed_share_(party * i + 3);
+        for (int p = 1; p <= num_party; ++p) {
+            x_full[i] += p + i;
+            y_full[i] += p * i + 3;
+        }
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<SPDZ2k<MultiIOBase>::LabeledShare> zs_loop(batch);
+    for (size_t i = 0; i < batch; ++i) zs_loop[i] = spdz2k.multiply(xs[i], ys[i]);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto zs = spdz2k.multiply_batch(xs, ys);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::vector<uint64_t> z_open = spdz2k.reconstruct_batch(zs);
+    std::vector<uint64_t> z_loop_open = spdz2k.reconstruct_batch(zs_loop);
+    bool batch_ok = true;
+    for (size_t i = 0; i < batch; ++i) {
+        uint64_t want = mulmod(x_full[i], y_full[i], FIELD_SIZE);
+        batch_ok = batch_ok && z_open[i] == want && z_loop_open[i] == want;
+    }
+    // 2x2 by 2x2 with f = 0, so the products are exact.
+    auto c = spdz2k.matrix_multiply({xs[0], xs[1], xs[2], xs[3]}, {ys[0], ys[1], ys[2], ys[3]}, 2, 2, 2, 0);
+    std::vector<uint64_t> c_open = spdz2k.reconstruct_batch(c);
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 2; ++j) {
+            uint64_t want = (mulmod(x_full[i * 2], y_full[j], FIELD_SIZE) + mulmod(x_full[i * 2 + 1], y_full[2 + j], FIELD_SIZE)) % FIELD_SIZE;
+            batch_ok = batch_ok && c_open[i * 2 + j] == want;
+        }
+    std::cout << batch << " multiplications: loop "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+    std::cout << "Batch multiplication " << (batch_ok ? "ok" : "MISMATCH") << std::endl;
+
+    // d x d matmul: one scalar triple per product against one matrix triple.
+    const size_t d = 32;
+    std::vector<SPDZ2k<MultiIOBase>::LabeledShare> ma(d * d), mb(d * d), lhs(d * d * d), rhs(d * d * d);
+    for (size_t i = 0; i < d * d; ++i) {
+        ma[i] = xs[i % batch];
+        mb[i] = ys[(i * 7) % batch];
+    }
+    for (size_t i = 0; i < d; ++i)
+        for (size_t j = 0; j < d; ++j)
+            for (size_t p = 0; p < d; ++p) {
+                lhs[(i * d + j) * d + p] = ma[i * d + p];
+                rhs[(i * d + j) * d + p] = mb[p * d + j];
+            }
+    spdz2k.precompute_matrix_triples(d, d, d, 1);
+    spdz2k.generate_triples(d * d * d);
+    uint64_t bytes0 = io->get_total_bytes_sent();
+    auto t3 = std::chrono::high_resolution_clock::now();
+    auto prod = spdz2k.multiply_batch(lhs, rhs);
+    uint64_t bytes1 = io->get_total_bytes_sent();
+    auto t4 = std::chrono::high_resolution_clock::now();
+    auto mc = spdz2k.matrix_multiply(ma, mb, d, d, d, 0);
+    uint64_t bytes2 = io->get_total_bytes_sent();
+    auto t5 = std::chrono::high_resolution_clock::now();
+    std::vector<SPDZ2k<MultiIOBase>::LabeledShare> summed(d * d, spdz2k.get_zero_share());
+    for (size_t ij = 0; ij < d * d; ++ij)
+        for (size_t p = 0; p < d; ++p) summed[ij] = spdz2k.add(summed[ij], prod[ij * d + p]);
+    bool mat_ok = spdz2k.reconstruct_batch(summed) == spdz2k.reconstruct_batch(mc);
+    std::cout << d << "x" << d << " matmul: scalar triples " << std::chrono::duration<double, std::milli>(t4 - t3).count()
+              << " ms, " << (bytes1 - bytes0) / 1024.0 << " KB; matrix triple "
+              << std::chrono::duration<double, std::milli>(t5 - t4).count() << " ms, " << (bytes2 - bytes1) / 1024.0
+              << " KB" << std::endl;
+    std::cout << "Matrix triple matmul " << (mat_ok ? "ok" : "MISMATCH") << std::endl;
+
     delete elgl;
     delete io;
     delete lvt;
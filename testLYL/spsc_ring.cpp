@@ -0,0 +1,44 @@
+#include "emp-aby/io/spsc_ring.hpp"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+using namespace emp;
+
+// The receive ring must never block its producer: with one receive thread
+// serving every peer, a full ring for one peer would stall all the others.
+// usage: ./test_spsc_ring
+template <size_t Cap>
+static bool fill_then_drain(size_t n) {
+    SPSCRing<size_t, Cap> ring;
+    for (size_t i = 0; i < n; ++i) ring.push(i);
+    bool ok = ring.overflowed() == (n > Cap ? n - Cap : 0);
+    // Pushes that arrive while older messages are still spilled stay
+    // behind them, even after the ring has room again.
+    size_t got = ring.pop();
+    ok = ok && got == 0;
+    ring.push(n);
+    for (size_t i = 1; i <= n; ++i) ok = ok && ring.pop() == i;
+    return ok && ring.empty();
+}
+
+template <size_t Cap>
+static bool concurrent(size_t n) {
+    SPSCRing<size_t, Cap> ring;
+    std::thread producer([&] {
+        for (size_t i = 0; i < n; ++i) ring.push(i);
+    });
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 4096 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ok = ring.pop() == i && ok;
+    }
+    producer.join();
+    return ok && ring.empty();
+}
+
+int main() {
+    bool ok = fill_then_drain<4096>(3 * 4096 + 7) && fill_then_drain<8>(5) && fill_then_drain<8>(100) &&
+              concurrent<8>(1 << 18) && concurrent<4096>(1 << 20);
+    printf("spsc ring: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "emp-aby/io/multi-io.hpp"
+#include "emp-aby/spdz2k.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace emp;
+
+// Local SPDZ2k share arithmetic on 2^min_log .. 2^max_log shares: the
+// LabeledShare path (array of structs, % and 128-bit mulmod) against
+// Z2kShares with the scalar, AVX2 and AVX-512 kernels. "beaver" is the
+// local half of a multiplication, z = c + e b + d a + e d with macs.
+// usage: ./test_z2k_bench [min_log] [max_log]
+typedef SPDZ2k<MultiIOBase>::LabeledShare Share;
+
+static uint64_t mulmod_div(uint64_t a, uint64_t b, uint64_t mod) {
+    return static_cast<uint64_t>((__uint128_t)a * b % mod);
+}
+
+// Small sizes are repeated up to 2^22 shares so that timings are stable.
+template <typename F>
+static double mops(size_t n, F f) {
+    size_t reps = std::max<size_t>(1, (size_t(1) << 22) / n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < reps; ++r) f();
+    return n * reps / std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    int min_log = argc > 1 ? std::stoi(argv[1]) : 10;
+    int max_log = argc > 2 ? std::stoi(argv[2]) : 22;
+    const uint64_t fs = spdz2k_field_size, key = 0x2545f4914f6cdd1dULL & Z2K_MASK, s = 12345;
+    std::mt19937_64 rng(7);
+    std::vector<Z2kIsa> isas = {Z2kIsa::SCALAR};
+    Z2kIsa best = z2k_isa();
+    if (best != Z2kIsa::SCALAR) isas.push_back(Z2kIsa::AVX2);
+    if (best == Z2kIsa::AVX512) isas.push_back(Z2kIsa::AVX512);
+    const char* names[] = {"scalar", "avx2", "avx512"};
+    bool ok = true;
+
+    for (int lg = min_log; lg <= max_log; lg += 2) {
+        size_t n = size_t(1) << lg;
+        std::vector<Share> x(n), y(n), c(n), out(n);
+        Z2kShares sx(n), sy(n), sc(n), so(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = Share(rng() & Z2K_MASK, rng() & Z2K_MASK, 1, &spdz2k_field_size);
+            y[i] = Share(rng() & Z2K_MASK, rng() & Z2K_MASK, 1, &spdz2k_field_size);
+            c[i] = Share(rng() & Z2K_MASK, rng() & Z2K_MASK, 1, &spdz2k_field_size);
+            sx.value[i] = x[i].value; sx.mac[i] = x[i].mac;
+            sy.value[i] = y[i].value; sy.mac[i] = y[i].mac;
+            sc.value[i] = c[i].value; sc.mac[i] = c[i].mac;
+        }
+        // x plays the opened e and y the opened d; c holds the triple's a.
+        auto same = [&]() {
+            for (size_t i = 0; i < n; ++i)
+                if (out[i].value != so.value[i] || out[i].mac != so.mac[i]) return false;
+            return true;
+        };
+
+        double aos[3], soa[3][3];
+        aos[0] = mops(n, [&] { for (size_t i = 0; i < n; ++i) out[i] = x[i] + y[i]; });
+        aos[1] = mops(n, [&] { for (size_t i = 0; i < n; ++i) out[i] = x[i] * s; });
+        aos[2] = mops(n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t e = x[i].value, d = y[i].value, ed = mulmod_div(e, d, fs);
+                uint64_t v = (c[i].value + mulmod_div(e, c[i].mac, fs) + mulmod_div(d, c[i].value, fs)) % fs;
+                uint64_t m = (c[i].mac + mulmod_div(e, c[i].mac, fs) + mulmod_div(d, c[i].mac, fs)) % fs;
+                out[i] = Share((v + ed) % fs, (m + mulmod_div(ed, key, fs)) % fs, 1, &spdz2k_field_size);
+            }
+        });
+        for (size_t k = 0; k < isas.size(); ++k) {
+            z2k_isa() = isas[k];
+            soa[k][0] = mops(n, [&] {
+                z2k_add(so.value.data(), sx.value.data(), sy.value.data(), n);
+                z2k_add(so.mac.data(), sx.mac.data(), sy.mac.data(), n);
+            });
+            for (size_t i = 0; i < n; ++i) out[i] = x[i] + y[i];
+            ok = ok && same();
+            soa[k][1] = mops(n, [&] {
+                z2k_mul_const(so.value.data(), sx.value.data(), s, n);
+                z2k_mul_const(so.mac.data(), sx.mac.data(), s, n);
+            });
+            for (size_t i = 0; i < n; ++i) out[i] = x[i] * s;
+            ok = ok && same();
+            soa[k][2] = mops(n, [&] {
+                so = sc;
+                z2k_beaver(so.value.data(), sx.value.data(), sy.value.data(), sc.mac.data(), sc.value.data(), 1, n);
+                z2k_beaver(so.mac.data(), sx.value.data(), sy.value.data(), sc.mac.data(), sc.mac.data(), key, n);
+            });
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t e = x[i].value, d = y[i].value, ed = mulmod_div(e, d, fs);
+                uint64_t v = (c[i].value + mulmod_div(e, c[i].mac, fs) + mulmod_div(d, c[i].value, fs)) % fs;
+                uint64_t m = (c[i].mac + mulmod_div(e, c[i].mac, fs) + mulmod_div(d, c[i].mac, fs)) % fs;
+                out[i] = Share((v + ed) % fs, (m + mulmod_div(ed, key, fs)) % fs, 1, &spdz2k_field_size);
+            }
+            ok = ok && same();
+        }
+        z2k_isa() = best;
+
+        const char* ops[] = {"add", "mul_const", "beaver"};
+        for (int o = 0; o < 3; ++o) {
+            std::cout << "2^" << lg << " " << ops[o] << "  LabeledShare " << aos[o] << " M/s";
+            for (size_t k = 0; k < isas.size(); ++k) std::cout << "  " << names[int(isas[k])] << " " << soa[k][o] << " M/s";
+            std::cout << std::endl;
+        }
+    }
+    std::cout << (ok ? "ok" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
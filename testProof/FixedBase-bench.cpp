@@ -0,0 +1,53 @@
+#include "libelgl/elgl/ELGL_Key.h"
+#include "libelgl/elgl/FixedBase.h"
+#include <chrono>
+
+// Single-core ElGamal encryptions/sec with generic G1::mul for both g^r, g^m
+// and pk^r ("before") against the fixed-base tables ("after").
+// usage: ./test_FixedBase-bench [n]
+int main(int argc, char** argv){
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000;
+    BLS12381Element::init();
+    ELGL_KeyPair kp;
+    kp.generate();
+    ELGL_PK pk = kp.get_pk();
+    G1 g = BLS12381Element::generator().getPoint();
+    G1 h = pk.get_pk().getPoint();
+
+    std::vector<Fr> r(n), m(n);
+    for (size_t i = 0; i < n; i++){
+        r[i].setByCSPRNG();
+        m[i].setByCSPRNG();
+    }
+
+    std::vector<Ciphertext> ref(n), out(n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++){
+        BLS12381Element c0, c1, gm;
+        G1::mul(c0.point, g, r[i]);
+        G1::mul(c1.point, h, r[i]);
+        G1::mul(gm.point, g, m[i]);
+        ref[i] = Ciphertext(c0, c1 + gm);
+    }
+    double generic = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    t0 = std::chrono::steady_clock::now();
+    pk.precompute();
+    double build = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++)
+        out[i] = pk.encrypt(Plaintext(m[i]), r[i]);
+    double fixed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    for (size_t i = 0; i < n; i++){
+        if (out[i] != ref[i]){
+            std::cerr << "mismatch at " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "generic mul:  " << n / generic << " enc/s" << std::endl;
+    std::cout << "fixed-base:   " << n / fixed << " enc/s  (" << generic / fixed << "x, table build "
+              << build * 1e3 << " ms)" << std::endl;
+    return 0;
+}
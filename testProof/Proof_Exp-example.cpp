@@ -3,11 +3,14 @@
 #include "libelgl/elgloffline/Exp_verifier.h"
 #include "libelgl/elgl/ELGL_Key.h"
 #include "libelgl/elgl/Plaintext.h"
+#include "emp-aby/utils.h"
 #include <chrono> 
 #include <typeinfo>
 using namespace std;
+const int threads = 4;
 int main(){
     BLS12381Element::init();
+    ThreadPool pool(threads);
     ELGL_KeyPair keypair;
     keypair.generate();
     ELGL_PK pk = keypair.get_pk();
@@ -42,7 +45,7 @@ int main(){
     // stds::cout << ciphertexts.str()<< std::endl;    
     
     auto start = std::chrono::high_resolution_clock::now();
-    prover.NIZKPoK(proof, ciphertexts, cleartexts, g1, y1, y2, x);
+    prover.NIZKPoK(proof, ciphertexts, cleartexts, g1, y1, y2, x, &pool);
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
 
@@ -56,7 +59,7 @@ int main(){
     ExpVerifier verifier(proof);
 
     start = std::chrono::high_resolution_clock::now();
-    verifier.NIZKPoK(g1_, y1_, y2_, ciphertexts, cleartexts);
+    verifier.NIZKPoK(g1_, y1_, y2_, ciphertexts, cleartexts, &pool);
     end = std::chrono::high_resolution_clock::now();
     elapsed = end - start;
 